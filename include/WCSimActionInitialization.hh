@@ -0,0 +1,24 @@
+#pragma once
+
+#include "G4VUserActionInitialization.hh"
+
+class WCSimDetectorConstruction;
+
+// Creates the user actions. In multithreaded mode Build() is called once for
+// each worker thread, so every thread gets its own generator, run, event,
+// tracking, stacking and stepping actions. The detector construction, and the
+// geometry tables it holds, are shared by all threads.
+class WCSimActionInitialization : public G4VUserActionInitialization
+{
+public:
+	WCSimActionInitialization(WCSimDetectorConstruction *detector);
+	~WCSimActionInitialization();
+
+	// Only the run action lives on the master thread, it merges the output
+	// files of the workers at the end of the run.
+	void BuildForMaster() const;
+	void Build() const;
+
+private:
+	WCSimDetectorConstruction *fDetector;
+};
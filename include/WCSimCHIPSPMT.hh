@@ -1,6 +1,7 @@
 #pragma once
 
 #include <iostream>
+#include <vector>
 #include "TRandom3.h"
 
 class WCSimCHIPSPMT
@@ -16,6 +17,22 @@ public:
 	// with time spread end - start.
 	double CalculateCharge(int pe, double start, double end);
 
+	// Calculate the charges for all of the hit tubes in a gate at once. The
+	// cascade is run one dynode at a time over every tube, which gives the same
+	// distribution of charges as calling CalculateCharge() for each tube.
+	void CalculateCharges(const std::vector<int> &pe, const std::vector<double> &start, const std::vector<double> &end,
+						  std::vector<double> &charges);
+
+	// Time CalculateCharge() against CalculateCharges() for nTubes tubes with a
+	// shower like spread of pe, printing the rate and charge mean / RMS of both.
+	void BenchmarkCharge(int nTubes, int nRepeats);
+
+	// Restart the random numbers from this seed
+	void SetSeed(UInt_t seed)
+	{
+		fRand.SetSeed(seed);
+	}
+
 	// Getter functions
 	double GetTotalGain() const
 	{
@@ -53,11 +70,19 @@ private:
 
 	double GetChargeRandom(double pe);
 
+	// Fill fStageGain from the first dynode gain and the relative gains
+	void CalculateStageGains();
+
 	double fTotalGain;
 	double fDamping;
 	double fDynodeGain;
 	std::vector<double> fDynodeGainMod;
 	int fDynodeStages;
+	// Gain of each dynode before any damping, fDynodeGain * fDynodeGainMod^0.7
+	std::vector<double> fStageGain;
+
+	// Work space for CalculateCharges()
+	std::vector<double> fBatchDamping;
 
 	TRandom3 fRand;
 
@@ -25,6 +25,7 @@ public:
 	virtual ~WCSimCherenkovBuilder();
 	WCSimGeoConfig *GetGeoConfig() const;
 	G4LogicalVolume *ConstructDetector(); //< Main function to build the detector - has to return a pointer for compatibility with old code
+	void ConstructSDandField();			  //< Attach the sensitive detector, called once per thread after Construct()
 
 protected:
 	void Update(); //< Reset a bunch of things if we change the geometry to avoid pointer awkwardness
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "WCSimWCHit.hh"
+#include "globals.hh"
+#include "TRandom3.h"
+#include <vector>
+
+class WCSimDetectorConstruction;
+
+// Adds PMT dark noise to the hits collection before the digitizer looks for
+// triggers. Rather than asking every PMT whether it fired, the total number of
+// dark hits in a time window is drawn from a single Poisson distribution for
+// the whole detector and the hits are then scattered uniformly over the tubes
+// and over the window.
+class WCSimDarkNoise
+{
+public:
+	WCSimDarkNoise(WCSimDetectorConstruction *det);
+	~WCSimDarkNoise();
+
+	// Dark rate of every PMT in kHz, zero turns the noise off
+	void SetDarkRate(G4double rate)
+	{
+		fDarkRate = rate;
+	}
+	G4double GetDarkRate() const
+	{
+		return fDarkRate;
+	}
+
+	// Seed of the noise hits, see WCSimDigiRandom
+	void SetSeed(UInt_t seed)
+	{
+		fRand.SetSeed(seed);
+	}
+
+	// Add dark hits between start and end (ns) to the hits collection, either as
+	// extra pe on PMTs that are already hit or as new hits. Dark hits have a
+	// parent ID of -1. Returns the number of dark hits added.
+	G4int AddDarkNoise(WCSimWCHitsCollection *hits, G4double start, G4double end);
+
+	// Print the time taken per event to add the noise over one event gate for a
+	// range of dark rates
+	void Benchmark(G4int nEvents);
+
+private:
+	// Table of the tube IDs and types, remade if the number of PMTs changes
+	void BuildTubeTable();
+
+	WCSimDetectorConstruction *fDet;
+	G4double fDarkRate; // kHz
+	TRandom3 fRand;
+
+	std::vector<G4int> fTubeIDs;
+	std::vector<G4int> fTubeTypes;
+
+	// Reused between calls
+	std::vector<G4int> fTubeToHit; // Hit collection index + 1 for each tube ID, 0 if not hit
+	std::vector<G4double> fRandomTubes;
+	std::vector<G4double> fRandomTimes;
+};
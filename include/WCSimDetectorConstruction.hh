@@ -3,6 +3,7 @@
 #include "WCSimPmtInfo.hh"
 #include "WCSimPMTConfig.hh"
 #include "WCSimPMTBuilder.hh"
+#include "WCSimPMTQE.hh"
 
 #include "G4Transform3D.hh"
 #include "G4VUserDetectorConstruction.hh"
@@ -32,6 +33,7 @@ class G4Material;
 class G4LogicalVolume;
 class G4AssemblyVolume;
 class G4VPhysicalVolume;
+class G4VTouchable;
 class WCSimDetectorMessenger;
 class WCSimWCSD;
 class WCSimPMTManager;
@@ -56,6 +58,8 @@ public:
 	~WCSimDetectorConstruction();
 
 	G4VPhysicalVolume *Construct();
+	// Attach the sensitive detector to the mailbox photocathodes, called once per thread
+	virtual void ConstructSDandField();
 
 	// Related to the new GeoManager
 	void SetDetectorName(const G4String &detName);
@@ -131,6 +135,20 @@ public:
 
 	G4float GetPMTQE(G4float, G4int, G4float, G4float, G4float);
 
+	// Tabulated QE for every PMT type, built once per geometry. Use this
+	// rather than GetPMTQE() for anything called per photon.
+	const WCSimPMTQE &GetPMTQETable() const
+	{
+		return fPMTQE;
+	}
+	// Index into GetPMTConfigs() and the QE table of the PMT type of this tube
+	G4int GetTubePMTType(G4int tubeID) const
+	{
+		return fTubePMTType[tubeID - 1];
+	}
+	// Time the old and tabulated QE for a number of random wavelengths
+	void BenchmarkPMTQE(G4int nCalls);
+
 	G4ThreeVector GetWCOffset()
 	{
 		return WCOffset;
@@ -141,6 +159,13 @@ public:
 	{
 		return tubeLocationMap[tubeTag];
 	}
+	// Integer lookup from the touchable history of a hit in the PMT glass face.
+	// This is the fast path used per photon by WCSimWCSD::ProcessHits()
+	static G4int GetTubeID(const G4VTouchable *touchable);
+	// The old string based tube tag, kept to validate the integer lookup
+	static std::string GetTubeTag(const G4VTouchable *touchable);
+	// Fold one (physical volume, copy number) level into a tube key
+	static unsigned long AddTubeKeyLevel(unsigned long key, const G4VPhysicalVolume *pv, G4int copyNo);
 	static G4Transform3D GetTubeTransform(int tubeNo)
 	{
 		return tubeIDMap[tubeNo];
@@ -197,6 +222,92 @@ public:
 		PMTPerfectTiming = val;
 	}
 
+	// Number of pe above which the default PMT simulation draws the summed charge
+	// from a single Gaussian rather than pe by pe
+	G4int GetPMTGaussianThreshold() const
+	{
+		return PMTGaussianThreshold;
+	}
+
+	void SetPMTGaussianThreshold(const G4int &val)
+	{
+		PMTGaussianThreshold = val;
+	}
+
+	// Dark rate of every PMT in kHz, zero for no dark noise
+	G4double GetPMTDarkRate() const
+	{
+		return PMTDarkRate;
+	}
+
+	void SetPMTDarkRate(const G4double &val)
+	{
+		PMTDarkRate = val;
+	}
+
+	// Base seed of the digitization random numbers, see WCSimDigiRandom
+	G4int GetDigiSeed() const
+	{
+		return DigiSeed;
+	}
+
+	void SetDigiSeed(const G4int &val)
+	{
+		DigiSeed = val;
+	}
+
+	// Trigger algorithm used by the digitizer, see WCSimTrigger
+	G4String GetTriggerType() const
+	{
+		return TriggerType;
+	}
+
+	void SetTriggerType(const G4String &val)
+	{
+		TriggerType = val;
+	}
+
+	G4int GetTriggerThreshold() const
+	{
+		return TriggerThreshold;
+	}
+
+	void SetTriggerThreshold(const G4int &val)
+	{
+		TriggerThreshold = val;
+	}
+
+	G4double GetTriggerWindow() const
+	{
+		return TriggerWindow;
+	}
+
+	void SetTriggerWindow(const G4double &val)
+	{
+		TriggerWindow = val;
+	}
+
+	G4bool GetTriggerVerbose() const
+	{
+		return TriggerVerbose;
+	}
+
+	void SetTriggerVerbose(const G4bool &val)
+	{
+		TriggerVerbose = val;
+	}
+
+	// Cross-check the integer tube lookup against the string tube tags
+	G4bool GetValidateTubeLookup() const
+	{
+		return ValidateTubeLookup;
+	}
+
+	void SetValidateTubeLookup(const G4bool &val)
+	{
+		ValidateTubeLookup = val;
+	}
+
 	// Geometry options
 	void SetIsUpright(G4bool choice)
 	{
@@ -221,6 +332,11 @@ public:
 	WCSimPMTManager *GetPMTManager() const;
 
 	std::vector<WCSimPMTConfig> GetPMTVector() const;
+	// As GetPMTVector() but without the copy, indexed by GetTubePMTType()
+	const std::vector<WCSimPMTConfig> &GetPMTConfigs() const
+	{
+		return fPMTConfigs;
+	}
 
 	std::vector<WCSimPmtInfo *> *Get_Pmts()
 	{
@@ -346,6 +462,35 @@ protected:
 	// true  = use perfect timing
 	G4bool PMTPerfectTiming;
 
+	// Use a Gaussian for the summed 1pe charge of tubes with at least this
+	// many pe in the default (SuperK) PMT simulation
+	// 0 = always sum the single pe charges (default)
+	G4int PMTGaussianThreshold;
+
+	// Dark noise rate of each PMT in kHz added by the digitizer, see WCSimDarkNoise
+	// 0 = no dark noise (default)
+	G4double PMTDarkRate;
+
+	// Base seed combined with the run and event numbers to seed the digitizer
+	// 0 = take the base seed from the Geant4 random engine each event (default)
+	G4int DigiSeed;
+
+	// Trigger settings for the digitizer
+	// - "gap" (default) = chain of hits with no gap longer than the window
+	// - "nhits" = PMT first hits in a sliding window
+	// - "ndigits" = all photoelectrons in a sliding window
+	// The threshold is in hits (default 25) and the window in ns (default 200)
+	G4String TriggerType;
+	G4int TriggerThreshold;
+	G4double TriggerWindow;
+	G4bool TriggerVerbose;
+
+	// Flag to run the old string based tube lookup alongside the integer one
+	// in the sensitive detector and report any mismatches and the timings
+	// false = integer lookup only (default)
+	// true  = validate against the tube tag strings
+	G4bool ValidateTubeLookup;
+
 	G4double WCLength;
 
 	G4double WCPosition;
@@ -429,6 +574,11 @@ protected:
 	static std::map<int, std::string> tubeTagMap;
 	//  static std::map<int, cyl_location> tubeCylLocation;
 	static hash_map<std::string, int, hash<std::string>> tubeLocationMap;
+	// Integer equivalent of tubeLocationMap, keyed by a hash of the
+	// (physical volume, copy number) chain down to the PMT glass face
+	static std::map<int, unsigned long> tubeKeyMap;
+	static hash_map<unsigned long, int, hash<unsigned long>> tubeKeyLocationMap;
+	static G4bool tubeKeyCollision;
 
 	// Variables related to configuration
 
@@ -436,6 +586,9 @@ protected:
 	G4double innerradius;
 
 	std::vector<WCSimPmtInfo *> fpmts;
+	std::vector<G4int> fTubePMTType; // PMT type of each tube, index is tubeID - 1
+
+	WCSimPMTQE fPMTQE;
 
 	WCSimPMTBuilder fPMTBuilder;
 };
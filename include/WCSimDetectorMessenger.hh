@@ -4,6 +4,7 @@ class WCSimDetectorConstruction;
 class G4UIdirectory;
 class G4UIcmdWithAString;
 class G4UIcmdWithABool;
+class G4UIcmdWithAnInteger;
 
 #include "G4UImessenger.hh"
 #include "globals.hh"
@@ -48,6 +49,26 @@ private:
 	// Andy: Flag to give the PMT perfect timing resolution (i.e. turn off time smearing)
 	G4UIcmdWithABool *PMTPerfectTiming;
 
+	// Flag to validate the integer tube lookup against the tube tag strings
+	G4UIcmdWithABool *ValidateTubeLookup;
+
+	// Time the old and tabulated PMT QE calculations
+	G4UIcmdWithAnInteger *BenchmarkPMTQE;
+	G4UIcmdWithAnInteger *PMTGaussianThreshold;
+	G4UIcmdWithAnInteger *ValidateSK1peSampler;
+
+	// Dark noise rate and its benchmark
+	G4UIcmdWithADouble *PMTDarkRate;
+	G4UIcmdWithAnInteger *DigiSeed;
+	G4UIcmdWithAnInteger *BenchmarkDarkNoise;
+
+	// Trigger settings for the digitizer
+	G4UIcmdWithAString *TriggerType;
+	G4UIcmdWithAnInteger *TriggerThreshold;
+	G4UIcmdWithADouble *TriggerWindow;
+	G4UIcmdWithABool *TriggerVerbose;
+	G4UIcmdWithAnInteger *BenchmarkPMTCharge;
+
 	G4UIcmdWithAString *tubeCmd;
 	G4UIcmdWithAString *distortionCmd;
 	G4UIcmdWithoutParameter *WCConstruct;
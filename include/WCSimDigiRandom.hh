@@ -0,0 +1,34 @@
+#pragma once
+
+#include <Rtypes.h>
+
+// Seeds for the random numbers used by the digitizer. Each event gets a seed
+// made from a base seed and its run and event numbers, and every part of the
+// digitizer draws from its own stream seeded from the event seed. The seeds
+// are a hash of these keys rather than the state of a shared generator, so an
+// event can be digitized again on its own, in any order or on any thread, and
+// give exactly the same digits.
+class WCSimDigiRandom
+{
+public:
+	// The independent streams of random numbers in the digitization of an event
+	enum Stream
+	{
+		kDarkNoise = 1,
+		kCHIPSCharge,
+		kSK1peCharge,
+		kTOTCharge,
+		kTiming
+	};
+
+	// Seed of this event, never zero
+	static UInt_t GetEventSeed(ULong64_t baseSeed, Int_t run, Int_t event);
+	// Seed of one stream of the event with this seed, never zero
+	static UInt_t GetStreamSeed(UInt_t eventSeed, Stream stream);
+
+private:
+	// Scramble the bits of x, the splitmix64 finaliser
+	static ULong64_t Mix(ULong64_t x);
+	// Fold down to a 32 bit seed, as TRandom3 uses a clock based seed for zero
+	static UInt_t Fold(ULong64_t x);
+};
@@ -11,7 +11,7 @@
 #include "TFile.h"
 #include "TVector3.h"
 
-class G4TrajectoryContainer;
+class G4Track;
 class WCSimTruthSummary;
 class TH1F;
 class TH2F;
@@ -29,7 +29,12 @@ public:
 
 	static void Open(const char *filename);
 	static void Close();
-	static void Fill(G4TrajectoryContainer *trajCont, WCSimTruthSummary *truthSumm);
+	// The profiles are filled as the photons are made, so no photon trajectories
+	// are needed. The stacking action starts each event with the primary from
+	// the truth summary and passes every Cherenkov photon it keeps to AddPhoton.
+	static void BeginEvent(const WCSimTruthSummary &truthSumm);
+	static void AddPhoton(const G4Track *track);
+	static void EndEvent();
 
 	static void FileName(const char *filename);
 
@@ -41,7 +46,9 @@ public:
 	void CloseFile();
 
 private:
-	void FillEvent(G4TrajectoryContainer *trajCont, WCSimTruthSummary *truthSumm);
+	void StartEvent(const WCSimTruthSummary &truthSumm);
+	void FillPhoton(const G4Track *track);
+	void FinishEvent();
 
 	void SmoothRho();
 	void SmoothG();
@@ -50,9 +57,6 @@ private:
 	void NormaliseRho();
 	void NormaliseG();
 
-	template <class T>
-	T AverageVector(const std::vector<T> &vec);
-
 	void SetThetaBins();
 	void SetSBins();
 	void MakeHistograms();
@@ -65,6 +69,10 @@ private:
 	int fNumPhotons;
 	double fEnergy;
 
+	// Vertex (cm) and direction of the primary in the current event
+	TVector3 fPrimaryVtx;
+	TVector3 fPrimaryDir;
+
 	// Raw histograms of s and cos theta
 	TH1F *fS;
 	TH2F *fSCosThetaFine;
@@ -95,6 +103,4 @@ private:
 	int fNBinsThetaFine;
 
 	TTree *fPhotonTree;
-	std::vector<TVector3> fPhotonVertices;
-	std::vector<TVector3> fPhotonDirections;
 };
\ No newline at end of file
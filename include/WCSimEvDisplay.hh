@@ -9,6 +9,8 @@
 
 #include <TVector3.h>
 
+#include "WCSimEvDisplayHitMaps.hh"
+
 class TChain;
 class TH1;
 class TH1D;
@@ -26,6 +28,8 @@ class TLegend;
 class TClonesArray;
 class TGraph;
 class WCSimTruthSummary;
+class WCSimRootEvent;
+class WCSimRootGeom;
 class TText;
 
 class WCSimEvDispPi0
@@ -132,7 +136,7 @@ private:
 	TVector3 fPhotonDir2;
 };
 
-class WCSimEvDisplay : public TGMainFrame
+class WCSimEvDisplay : public TGMainFrame, public WCSimEvDisplayHitMaps
 {
 protected:
 	// Canvas to show the hit PMTs
@@ -155,39 +159,9 @@ protected:
 	unsigned int fWhichPads;
 	TDatabasePDG *fDatabasePDG;
 
-	// The three 2D histograms that show the hits
-	TH2D *fBarrelHist;
-	TH2D *fTopHist;
-	TH2D *fBottomHist;
-	// Single 1D histogram to show either charge or time
-	TH1D *fChargeHist;
-	TH1D *fTimeHist;
-
-	// Some histogram text titles
-	TText *fBarrelTitle;
-	TText *fTopTitle;
-	TText *fBottomTitle;
-
-	// As the PMTs are not uniform, use TGraphs to display the points
-	// Store a vector of 10 graphs for each of the 3 regions, with each
-	// graph storing a range of charges.
-	std::vector<TGraph *> fTopGraphs;
-	std::vector<TGraph *> fBarrelGraphs;
-	std::vector<TGraph *> fBottomGraphs;
-	std::vector<double> fChargeBins; // Lower edges
-	std::vector<double> fTimeBins;	 // Lower edges
-	double fQMin;
-	double fQMax;
-	double fTMin;
-	double fTMax;
-	std::vector<Int_t> fColours;
-	void InitialiseGraph(TGraph *g, int i);
-	void CalculateChargeAndTimeBins();
-	unsigned int GetChargeBin(double charge) const;
-	unsigned int GetTimeBin(double time) const;
-	void MakeGraphColours();
+	// The hit maps are drawn by WCSimEvDisplayHitMaps, the display only
+	// needs to take the graphs off the pads before they are refilled
 	void ResetGraphs();
-	void DrawHitGraphs(std::vector<TGraph *> vec);
 
 	// The truth display is all contained within TPaveText objects
 	TPaveText *fTruthTextMain;
@@ -197,15 +171,6 @@ protected:
 	// Function to change the sizes of the TPaveTexts
 	void ResizeTruthPaveTexts(bool isOverlay);
 
-	// When using WCSim files, store the geometry information
-	double fWCRadius;
-	double fWCLength;
-	double fPMTRadius;
-	int fPMTBarrel;
-	int fPMTTop;
-	int fPMTBottom;
-	int fPMTVeto;
-
 	// The WCSim only buttons frame need to be a member variable
 	// so that we can hide it.
 	TGHorizontalFrame *hWCSimButtons;
@@ -224,20 +189,11 @@ protected:
 	// 0 = WCSim file
 	int fFileType;
 
-	// Do we want to look at charge or time?
-	// 0 = charge
-	// 1 = time
-	int fViewType;
-
-	// Do we want to display veto hits?
-	bool fViewVeto;
-
-	// Switch to log scale for charge plots
-	bool fLogZCharge;
-
 	// The current file to look at
 	TChain *fChain;
 	TChain *fGeomTree;
+	// The event read from fChain, its branch address is set once per file
+	WCSimRootEvent *fWCSimEvent;
 
 	// A pointer to the truth summary object of the current event
 	WCSimTruthSummary *fTruthSummary;
@@ -248,37 +204,20 @@ protected:
 	std::vector<TPolyMarker *> fTruthMarkersBottom;
 	std::vector<TLine *> fTruthLines; // One line per truth ring to fill the legend
 
-	// Charge cut and corresponding entry box
+	// Entry box for the charge cut
 	TGNumberEntry *fPEInput;
-	double fChargeCut;
 
 	// Flag to decide whether we show the 1D plots
 	bool fShow1DHists;
 	// Function to update the pads as a result.
 	virtual void ResizePads();
 
-	// Default construct some plots
-	void MakeDefaultPlots();
-	void FormatTitles(TText *t);
-
 	// Function to draw plots from the standard WCSim files
 	virtual void FillPlots();
 	void FillPlotsFromWCSimEvent();
 	// Use the geometry to resize the plots.
 	void ResizePlotsFromGeometry();
 
-	// Function to clear the plots
-	void ClearPlots();
-
-	// Function to make the plots look how we want them to.
-	void MakePlotsPretty(TH1 *h);
-	// Adjust the palette axis on the barrel plot.
-	void AdjustBarrelZAxis();
-
-	// Function to find what the colour axis minimum should be
-	void GetMinColourAxis(TH2D *h);
-	// Set the colour axes for the 2D plots
-	void SetPlotZAxes();
 	// Update the canvases after updating the plots.
 	virtual void UpdateCanvases();
 	// Draw the reco plots to their pads, but don't show yet.
@@ -288,9 +227,6 @@ protected:
 	// Draw the truth overlay rings to their pads
 	void UpdateTruthOverlayPad();
 
-	// Set up the style for the plots
-	void SetStyle();
-
 	// The actual behind the scenes code that opens the files.
 	void OpenNtupleFile(std::string name);
 	void OpenWCSimFile(std::string name);
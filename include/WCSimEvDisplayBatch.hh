@@ -0,0 +1,46 @@
+#pragma once
+
+#include <string>
+
+#include "WCSimEvDisplayHitMaps.hh"
+
+class TChain;
+class TCanvas;
+class TPad;
+class WCSimRootEvent;
+
+// Renders the hit maps of the event display straight to image files without
+// any GUI widgets, so it can run in ROOT's batch mode. Every event is drawn
+// twice, once coloured by charge and once by time, and saved as
+// <prefix>_<event>_charge.<format> and <prefix>_<event>_time.<format>.
+class WCSimEvDisplayBatch : public WCSimEvDisplayHitMaps
+{
+public:
+	WCSimEvDisplayBatch(int width = 1200, int height = 900);
+	~WCSimEvDisplayBatch();
+
+	// Open a chipssim output file and read its geometry, false if it isn't one
+	bool OpenFile(const std::string &name);
+	int GetNEvents() const;
+
+	// Draw and save both views of one event, false if it has no digits
+	bool RenderEvent(int event, const std::string &prefix, const std::string &format);
+	// Render the events in [first, last] that belong to this worker, every
+	// nWorkers-th event starting from first + worker. Returns the number rendered.
+	int RenderEvents(int first, int last, int worker, int nWorkers, const std::string &prefix,
+					 const std::string &format);
+
+private:
+	void SaveView(WCSimRootTrigger *trigger, int viewType, const std::string &fileName);
+
+	TChain *fChain;
+	WCSimRootEvent *fWCSimEvent;
+
+	// The same layout as the reco view of the display with the 1D plots shown
+	TCanvas *fCanvas;
+	TPad *fBarrelPad;
+	TPad *fTopPad;
+	TPad *fBottomPad;
+	TPad *fChargePad;
+	TPad *fTimePad;
+};
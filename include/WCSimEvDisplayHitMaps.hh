@@ -0,0 +1,128 @@
+#pragma once
+
+#include <vector>
+
+#include <Rtypes.h>
+
+class TH1;
+class TH1D;
+class TH2D;
+class TPad;
+class TGraph;
+class TText;
+class WCSimRootGeom;
+class WCSimRootTrigger;
+
+// The hit maps of the event display: the barrel, top and bottom views of the
+// digitised hits with the charge and time histograms. Nothing in here needs
+// the GUI, so the same binning and drawing is used by the interactive display
+// and by the batch renderer.
+class WCSimEvDisplayHitMaps
+{
+public:
+	WCSimEvDisplayHitMaps();
+	virtual ~WCSimEvDisplayHitMaps();
+
+	// Store the detector dimensions and the PMT positions for the rest of the file
+	void LoadGeometry(WCSimRootGeom *geo);
+	// Make the histograms that frame the hit maps using the loaded geometry
+	void MakeHitHistograms();
+	// Fill the hit graphs and the 1D histograms from the digits of this trigger,
+	// returns the number of digits that passed the charge cut.
+	int FillHitMaps(WCSimRootTrigger *trigger);
+	// Draw the hit maps onto the given pads. The 1D pads can be null.
+	void DrawHitMaps(TPad *barrelPad, TPad *topPad, TPad *bottomPad, TPad *chargePad, TPad *timePad);
+
+	// The view settings
+	// Do we want to look at charge or time?
+	// 0 = charge
+	// 1 = time
+	int fViewType;
+	// Do we want to display veto hits?
+	bool fViewVeto;
+	// Switch to log scale for charge plots
+	bool fLogZCharge;
+	// Charge cut in p.e.
+	double fChargeCut;
+
+protected:
+	// The three 2D histograms that show the hits
+	TH2D *fBarrelHist;
+	TH2D *fTopHist;
+	TH2D *fBottomHist;
+	// Single 1D histogram to show either charge or time
+	TH1D *fChargeHist;
+	TH1D *fTimeHist;
+
+	// Some histogram text titles
+	TText *fBarrelTitle;
+	TText *fTopTitle;
+	TText *fBottomTitle;
+
+	// As the PMTs are not uniform, use TGraphs to display the points
+	// Store a vector of 10 graphs for each of the 3 regions, with each
+	// graph storing a range of charges.
+	std::vector<TGraph *> fTopGraphs;
+	std::vector<TGraph *> fBarrelGraphs;
+	std::vector<TGraph *> fBottomGraphs;
+	std::vector<double> fChargeBins; // Lower edges
+	std::vector<double> fTimeBins;	 // Lower edges
+	double fQMin;
+	double fQMax;
+	double fTMin;
+	double fTMax;
+	std::vector<Int_t> fColours;
+	void InitialiseGraph(TGraph *g, int i);
+	void CalculateChargeAndTimeBins();
+	unsigned int GetChargeBin(double charge) const;
+	unsigned int GetTimeBin(double time) const;
+	void MakeGraphColours();
+	// Empty the graphs without touching the pads they are drawn on
+	void ClearGraphs();
+	void DrawHitGraphs(std::vector<TGraph *> vec);
+
+	// Geometry information
+	double fWCRadius;
+	double fWCLength;
+	double fPMTRadius;
+	int fPMTBarrel;
+	int fPMTTop;
+	int fPMTBottom;
+	int fPMTVeto;
+
+	// Flat copy of the PMT geometry, filled once per file and indexed by tube ID - 1
+	// so that the hits are placed without going through the WCSimRootGeom.
+	// Positions are in m and fPMTOrientZ is the z component of the PMT direction.
+	std::vector<float> fPMTX;
+	std::vector<float> fPMTY;
+	std::vector<float> fPMTZ;
+	std::vector<float> fPMTPhi;
+	std::vector<float> fPMTOrientZ;
+	std::vector<int> fPMTCylLoc;
+	void LoadGeometryCache(WCSimRootGeom *geo);
+	// Index into the geometry cache for this tube ID, -1 if it isn't in the geometry
+	int GetPMTIndex(int tubeId) const
+	{
+		return (tubeId > 0 && tubeId <= (int)fPMTCylLoc.size()) ? tubeId - 1 : -1;
+	}
+
+	// Default construct some plots
+	void MakeDefaultPlots();
+	void FormatTitles(TText *t);
+
+	// Function to clear the plots
+	void ClearPlots();
+
+	// Function to make the plots look how we want them to.
+	void MakePlotsPretty(TH1 *h);
+	// Adjust the palette axis on the barrel plot.
+	void AdjustBarrelZAxis();
+
+	// Function to find what the colour axis minimum should be
+	void GetMinColourAxis(TH2D *h);
+	// Set the colour axes for the 2D plots
+	void SetPlotZAxes();
+
+	// Set up the style for the plots
+	void SetStyle();
+};
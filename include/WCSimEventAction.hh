@@ -10,9 +10,13 @@
 #include "WCSimWCHit.hh"
 #include "WCSimWCDigi.hh"
 
+#include <vector>
+
 class WCSimEmissionProfileMaker;
 class WCSimRunAction;
 class WCSimPrimaryGeneratorAction;
+class WCSimTrackFilter;
+class WCSimTrajectory;
 class G4Event;
 
 class WCSimEventAction : public G4UserEventAction
@@ -30,6 +34,7 @@ public:
 	void BeginOfEventAction(const G4Event *);
 	void EndOfEventAction(const G4Event *);
 	void FillRootEvent(G4int, G4TrajectoryContainer *, WCSimWCHitsCollection *, WCSimWCDigitsCollection *);
+	void FillFlatEvent(G4int, WCSimWCDigitsCollection *);
 	WCSimRunAction *GetRunAction()
 	{
 		return runAction;
@@ -39,4 +44,9 @@ private:
 	G4int WCSimEventFindStartingVolume(G4ThreeVector vtx);
 	G4int WCSimEventFindStoppingVolume(G4String stopVolumeName);
 	WCSimEmissionProfileMaker *fEmissionProfileMaker;
+
+	// Chooses the truth tracks to save, and its output reused between events
+	WCSimTrackFilter *fTrackFilter;
+	std::vector<WCSimTrajectory *> fSelectedTracks;
+	std::vector<G4int> fSelectedParentTypes;
 };
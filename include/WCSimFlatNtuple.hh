@@ -0,0 +1,77 @@
+#pragma once
+
+#include "Rtypes.h"
+#include <vector>
+
+class TTree;
+
+// Optional flat copy of the digitized hits and the PMT geometry, written to the
+// main output file alongside the WCSimRootEvent tree. Every event is a single
+// entry of "flatT" holding plain vectors, one element per digit, so readers
+// that only want (tube, q, t) don't need the WCSimRoot classes or the cost of
+// reading the TClonesArrays. "flatGeoT" has a single entry with one element
+// per PMT in each vector.
+class WCSimFlatNtuple
+{
+public:
+	// The trees are made in the current ROOT directory
+	WCSimFlatNtuple(Int_t basketSize);
+	~WCSimFlatNtuple();
+
+	// Start a new event, clearing the vectors
+	void BeginEvent(Int_t eventID, Int_t mode, Int_t beamPDG, Float_t beamEnergy, Float_t vtxX, Float_t vtxY,
+					Float_t vtxZ);
+	void AddTrigger(Float_t time)
+	{
+		fTriggerTime.push_back(time);
+	}
+	void AddDigit(Int_t trigger, Int_t tube, Float_t q, Float_t t)
+	{
+		fDigiTrigger.push_back(trigger);
+		fDigiTube.push_back(tube);
+		fDigiQ.push_back(q);
+		fDigiT.push_back(t);
+	}
+	void FillEvent();
+
+	void AddPMT(Int_t tube, Int_t cylLoc, const Float_t pos[3], const Float_t dir[3], Float_t radius);
+	void FillGeometry();
+
+	TTree *GetTree()
+	{
+		return fTree;
+	}
+	TTree *GetGeoTree()
+	{
+		return fGeoTree;
+	}
+
+private:
+	TTree *fTree;
+	TTree *fGeoTree;
+
+	// Event tree
+	Int_t fEventID;
+	Int_t fMode;
+	Int_t fBeamPDG;
+	Float_t fBeamEnergy;
+	Float_t fVtxX;
+	Float_t fVtxY;
+	Float_t fVtxZ;
+	std::vector<Float_t> fTriggerTime;
+	std::vector<Int_t> fDigiTrigger;
+	std::vector<Int_t> fDigiTube;
+	std::vector<Float_t> fDigiQ;
+	std::vector<Float_t> fDigiT;
+
+	// Geometry tree
+	std::vector<Int_t> fPMTTube;
+	std::vector<Int_t> fPMTCylLoc;
+	std::vector<Float_t> fPMTX;
+	std::vector<Float_t> fPMTY;
+	std::vector<Float_t> fPMTZ;
+	std::vector<Float_t> fPMTDirX;
+	std::vector<Float_t> fPMTDirY;
+	std::vector<Float_t> fPMTDirZ;
+	std::vector<Float_t> fPMTRadius;
+};
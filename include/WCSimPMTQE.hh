@@ -0,0 +1,79 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "WCSimPMTConfig.hh"
+
+// Wavelength -> quantum efficiency lookup for every PMT type in the geometry.
+// The efficiency curves from the PMT configs are sampled once onto a uniform
+// wavelength grid so that the per-photon calls from the stacking action and
+// the sensitive detector are a clamp and a linear interpolation.
+class WCSimPMTQE
+{
+public:
+	WCSimPMTQE();
+	~WCSimPMTQE();
+
+	// Sample the efficiency curves of the given PMT types. Photons with wavelengths
+	// outside (lowWavelength, highWavelength) nm get zero efficiency.
+	void Build(const std::vector<WCSimPMTConfig> &configs, double lowWavelength = 240.,
+			   double highWavelength = 660., double binWidth = 1.);
+
+	// Efficiency of PMT type for a photon of the given wavelength (nm)
+	double GetQE(double wavelength, int type) const
+	{
+		return Interpolate(fTables[type], wavelength);
+	}
+
+	// Largest efficiency of any PMT type at this wavelength, for use before we
+	// know which PMT the photon will hit
+	double GetEnvelopeQE(double wavelength) const
+	{
+		return Interpolate(fEnvelope, wavelength);
+	}
+
+	// Largest efficiency of any PMT type at any wavelength, zero outside the table range
+	double GetMaxQE(double wavelength) const
+	{
+		return (wavelength > fLow && wavelength < fHigh) ? fMaxQE : 0.;
+	}
+	double GetMaxQE() const
+	{
+		return fMaxQE;
+	}
+
+	int GetNTypes() const
+	{
+		return fNames.size();
+	}
+
+	// Index of the PMT type with this name, -1 if it is not in the table
+	int GetType(const std::string &name) const;
+
+	// The efficiency of a PMT curve at a given wavelength (nm), calculated in the same way
+	// as the old WCSimDetectorConstruction::GetPMTQE(). Used to fill the tables.
+	static double EvaluateQE(const std::vector<std::pair<double, double>> &effVec, double wavelength);
+
+private:
+	double Interpolate(const std::vector<double> &table, double wavelength) const
+	{
+		// Clamp onto the grid, the first and last points are zero so anything
+		// outside the range gets no efficiency without needing a branch.
+		double x = std::min(std::max((wavelength - fLow) * fInvBinWidth, 0.), fMaxX);
+		unsigned int bin = static_cast<unsigned int>(x);
+		double frac = x - bin;
+		return table[bin] + frac * (table[bin + 1] - table[bin]);
+	}
+
+	double fLow;
+	double fHigh;
+	double fInvBinWidth;
+	double fMaxX;
+	double fMaxQE;
+
+	std::vector<std::vector<double>> fTables;
+	std::vector<double> fEnvelope;
+	std::vector<std::string> fNames;
+};
@@ -3,9 +3,18 @@
 #include "TString.h"
 #include "G4String.hh"
 
+#include <vector>
+
 class TFile;
 class TTree;
+class G4Track;
 
+// Records the Cherenkov photons of each event straight from the simulation,
+// without keeping a trajectory for every photon. The stacking action adds each
+// photon when it is made, the tracking action gives its end point and the
+// sensitive detector marks the ones that make a hit. The photons of an event
+// are kept as columns and written as a single entry of "photonT", one element
+// per photon in each vector.
 class WCSimPhotonNtuple
 {
 public:
@@ -18,11 +27,15 @@ public:
 
 	static void Open(const char *filename);
 	static void Close();
-	static void Fill(Int_t eventID, Int_t pdgCode, Int_t trackID, Int_t parentID, Int_t processID, Float_t energy,
-					 Float_t momentum, Float_t lambda, Bool_t opticalPhoton, Bool_t scatteredPhoton, Float_t vtxX,
-					 Float_t vtxY, Float_t vtxZ, Float_t vtxTime, Float_t endX, Float_t endY, Float_t endZ, Float_t endTime,
-					 Float_t vtxdirX, Float_t vtxdirY, Float_t vtxdirZ);
 	static void FileName(const char *filename);
+	// Is there an open ntuple for this thread?
+	static bool IsOpen();
+
+	// Called by the stacking, tracking and event actions and the sensitive detector
+	static void AddPhoton(const G4Track *track);
+	static void EndPhoton(const G4Track *track);
+	static void DetectPhoton(Int_t trackID, Int_t tubeID);
+	static void EndEvent(Int_t eventID);
 
 	void SetFileName(const char *filename)
 	{
@@ -31,10 +44,11 @@ public:
 	void OpenFile(const char *filename);
 	void CloseFile();
 
-	void WriteEvent(Int_t eventID, Int_t pdgCode, Int_t trackID, Int_t parentID, Int_t processID, Float_t energy,
-					Float_t momentum, Float_t lambda, Bool_t opticalPhoton, Bool_t scatteredPhoton, Float_t vtxX,
-					Float_t vtxY, Float_t vtxZ, Float_t vtxTime, Float_t endX, Float_t endY, Float_t endZ, Float_t endTime,
-					Float_t vtxdirX, Float_t vtxdirY, Float_t vtxdirZ);
+	// Only keep one in every prescale photons
+	void SetPrescale(Int_t prescale)
+	{
+		fPrescale = (prescale > 0) ? prescale : 1;
+	}
 
 	void SetGeometry(Float_t halfWidthXY, Float_t halfWidthZ)
 	{
@@ -43,38 +57,48 @@ public:
 	}
 
 private:
-	void WriteEventToFile();
-	void WriteToFile();
+	void RecordPhoton(const G4Track *track);
+	void RecordEnd(const G4Track *track);
+	void RecordDetection(Int_t trackID, Int_t tubeID);
+	void WriteEvent(Int_t eventID);
+	void ClearEvent();
+	// Index of the photon record for this track, -1 if it wasn't recorded
+	Int_t GetRecord(Int_t trackID) const
+	{
+		return (trackID >= 0 && trackID < (Int_t)fRecordOfTrack.size()) ? fRecordOfTrack[trackID] : -1;
+	}
 
 	TFile *fWCFile;
 	TTree *fWCTree;
 	TString fWCFileName;
 
+	Int_t fPrescale;
+	// Photons seen this event, for the prescale
+	Int_t fNumSeen;
+
 	Int_t fEventID;
-	Int_t fPdgCode;
-	Int_t fTrackID;
-	Int_t fParentID;
-	Int_t fProcessID;
-	Float_t fEnergy;
-	Float_t fMomentum;
-	Float_t fLambda;
-	Int_t fOpticalPhoton;
-	Int_t fScatteredPhoton;
-	Float_t fVtxX;
-	Float_t fVtxY;
-	Float_t fVtxZ;
-	Float_t fVtxTime;
-	Float_t fVtxDirX;
-	Float_t fVtxDirY;
-	Float_t fVtxDirZ;
-	Float_t fEndX;
-	Float_t fEndY;
-	Float_t fEndZ;
-	Float_t fEndTime;
-
-	Int_t fIsDetected;
-	Float_t fEndU;
-	Float_t fEndV;
+	Int_t fNumPhotons;
+	std::vector<Int_t> fTrackID;
+	std::vector<Int_t> fParentID;
+	std::vector<Int_t> fProcessID;
+	std::vector<Float_t> fEnergy;
+	std::vector<Float_t> fLambda;
+	std::vector<Float_t> fVtxX;
+	std::vector<Float_t> fVtxY;
+	std::vector<Float_t> fVtxZ;
+	std::vector<Float_t> fVtxTime;
+	std::vector<Float_t> fVtxDirX;
+	std::vector<Float_t> fVtxDirY;
+	std::vector<Float_t> fVtxDirZ;
+	std::vector<Float_t> fEndX;
+	std::vector<Float_t> fEndY;
+	std::vector<Float_t> fEndZ;
+	std::vector<Float_t> fEndTime;
+	std::vector<Int_t> fIsDetected;
+	std::vector<Int_t> fTubeID;
+
+	// Record number of each track ID this event, -1 for tracks that aren't recorded
+	std::vector<Int_t> fRecordOfTrack;
 
 	Float_t fHalfWidthXY;
 	Float_t fHalfWidthZ;
@@ -8,6 +8,7 @@
 #pragma once
 
 #include "G4TwoVector.hh"
+#include "G4ThreeVector.hh"
 
 namespace WCSimPolygonTools
 {
@@ -57,6 +58,21 @@ bool PolygonSliceContainsSquare(unsigned int nSides, double thetaStart, double t
 bool PolygonSliceContains(unsigned int nSides, double thetaStart, double thetaEnd, double outerRadius,
 						  G4TwoVector point);
 
+/**
+ * \brief Find where a straight line passes through a regular prism centred on (0,0,0) with its axis along z
+ * \param nSides Number of sides for the polygon, or 0 for a cylinder
+ * \param innerRadius Distance from the axis to the middle of each side (or the radius of the cylinder)
+ * \param halfHeight Half the height of the prism
+ * \param phiSide Angle of the middle of one of the sides, counting anticlockwise from theta = 0
+ * \param point Any point on the line
+ * \param dir Direction of the line, doesn't need to be a unit vector
+ * \param tEnter Set to t where the line point + t * dir enters the prism
+ * \param tExit Set to t where the line point + t * dir leaves the prism
+ * \return True if the line passes through the prism
+ */
+bool IntersectPrism(unsigned int nSides, double innerRadius, double halfHeight, double phiSide,
+					const G4ThreeVector &point, const G4ThreeVector &dir, double &tEnter, double &tExit);
+
 double GetSideFromRadius(unsigned int nSides, double outerRadius);
 double GetRadiusFromSide(unsigned int nSides, double side);
 double GetSliceAreaFromAngles(unsigned int nSides, double outerRadius, double startAngle, double endAngle);
@@ -5,8 +5,8 @@
 #include "globals.hh"
 
 #include "WCSimTruthSummary.hh"
+#include "WCSimVectorFileReader.hh"
 
-#include <fstream>
 #include <vector>
 
 class WCSimDetectorConstruction;
@@ -67,6 +67,31 @@ public:
 		return fUseXAxisForBeam;
 	}
 
+	// Start reading the vector and overlay files from this event
+	void SetFirstEvent(G4int event)
+	{
+		fFirstEvent = event;
+		fVecRangeSet = false;
+		fOverlayRangeSet = false;
+	}
+	G4int GetFirstEvent() const
+	{
+		return fFirstEvent;
+	}
+
+	// Compare the analytic detector entry of nTracks random cosmic muons with
+	// the old stepping method, and time them both
+	void BenchmarkOverlayEntry(G4int nTracks);
+
+	// Only read part index of nShards of the events after the first event
+	void SetShard(G4int index, G4int nShards)
+	{
+		fShardIndex = index;
+		fNShards = nShards;
+		fVecRangeSet = false;
+		fOverlayRangeSet = false;
+	}
+
 private:
 	WCSimDetectorConstruction *myDetector;
 	G4ParticleGun *particleGun;
@@ -82,25 +107,70 @@ private:
 	G4bool useLaserEvt; //T. Akiri: Laser flag
 	G4bool useGpsEvt;
 	G4bool useOverlayEvt;
-	std::fstream inputFile;
+	WCSimVectorFileReader *fVectorReader;
+	WCSimVectorEvent fVectorEvent;
 	G4String vectorFileName;
 	std::vector<G4String> vectorFileVec;
 	std::vector<G4String>::const_iterator vectorFileIterator;
 	G4bool GenerateVertexInRock;
 
 	// Overlay variables and functions
-	std::fstream fOverlayFile;
+	WCSimVectorFileReader *fOverlayReader;
+	WCSimVectorEvent fOverlayEvent;
 	G4String fOverlayFileName;
 	std::vector<G4String> fOverlayFileVec;
 	std::vector<G4String>::const_iterator fOverlayFileIterator;
 	void GenerateOverlayEvents(G4Event *evt);
+
+	// Number of events read from the vector files so far. In multithreaded
+	// mode each thread reads its own copy of the files, so uses this to skip
+	// over the events processed by the other threads.
+	G4int fVecEventsRead;
+	G4int fOverlayEventsRead;
+	void SkipVectorEvents(G4int nEvents);
+	void SkipOverlayEvents(G4int nEvents);
+
+	// The range of events to read, from /mygen/firstEvent and /mygen/shard
+	G4int fFirstEvent;
+	G4int fShardIndex;
+	G4int fNShards;
+	// First event and number of events (-1 for all) this job reads from the
+	// vector and overlay files, worked out when the first event is generated
+	G4int fVecStartEvent;
+	G4int fVecNEvents;
+	bool fVecRangeSet;
+	G4int fOverlayStartEvent;
+	G4int fOverlayNEvents;
+	bool fOverlayRangeSet;
+	void FindEventRange(const std::vector<G4String> &files, G4int &startEvent, G4int &nEvents) const;
+	// Skip forward to the event that G4 event number eventID should use, false if
+	// this job has run out of events
+	bool MoveToVectorEvent(G4int eventID);
+	bool MoveToOverlayEvent(G4int eventID);
+	// Read the next event from the vector files, moving on to the next file at
+	// the end of each one. Returns false when there are no events left.
+	bool ReadNextVectorEvent();
+	bool ReadNextOverlayEvent();
 	// For the overlay events, need to find a fake vertex just inside the detector, and adjust the energy correspondingly.
 	bool UpdateOverlayVertexAndEnergy(G4ThreeVector &vtx, double &timeOffset, G4ThreeVector dir, double &energy);
-
-	// Take a tokenised "track" line from a .vec file and contact the particle gun
+	// Where the line through vtx along dir enters the detector, false if it misses
+	bool FindOverlayEntry(G4ThreeVector &vtx, const G4ThreeVector &dir);
+	// The old way of finding the entry point, stepping down the detector 1mm at a time.
+	// Only used to check FindOverlayEntry in BenchmarkOverlayEntry.
+	bool FindOverlayEntryByStepping(G4ThreeVector &vtx, const G4ThreeVector &dir);
+
+	// Shape of the detector used for the overlay muons: a prism with the sides
+	// facing the x axis (a cylinder if fDetectorSides is 0), found on first use
+	void SetOverlayDetectorShape();
+	bool fDetectorShapeSet;
+	unsigned int fDetectorSides;
+	double fDetectorRadius;
+	double fDetectorHalfHeight;
+
+	// Take a track from a vector file and contact the particle gun
 	// .vec files typically need to swap x and z coordinates for use here.
-	void FireParticleGunFromTrackLine(G4Event *evt, G4ThreeVector &vtx, double &vtxTime,
-									  std::vector<std::string> &tokens, bool swapXZ, bool isOverlay);
+	void FireParticleGunFromTrack(G4Event *evt, G4ThreeVector &vtx, double &vtxTime,
+								  const WCSimVectorParticle &track, bool swapXZ, bool isOverlay);
 
 	// Function to pull an event time out of a flat distribution
 	// that simulates the beam spill.
@@ -165,19 +235,22 @@ public:
 		return useOverlayEvt;
 	}
 
+	// Open a text (.vec) or binary (.vecb) vector file
 	inline void OpenVectorFile(G4String fileName)
 	{
-		if (inputFile.is_open())
+		delete fVectorReader;
+		vectorFileName = fileName;
+		fVectorReader = WCSimVectorFileReader::Create(vectorFileName);
+		if (!fVectorReader->Open(vectorFileName))
 		{
-			inputFile.close();
+			G4cout << "Could not open the vector file " << vectorFileName << G4endl;
 		}
-		vectorFileName = fileName;
-		inputFile.open(vectorFileName, std::fstream::in);
 	}
 
 	inline void AddVectorFile(G4String fileName)
 	{
 		vectorFileVec.push_back(fileName);
+		fVecRangeSet = false;
 		if (vectorFileVec.size() == 1)
 		{
 			vectorFileIterator = vectorFileVec.begin();
@@ -201,17 +274,19 @@ public:
 	// as the standard vector files.
 	inline void OpenOverlayFile(G4String fileName)
 	{
-		if (fOverlayFile.is_open())
+		delete fOverlayReader;
+		fOverlayFileName = fileName;
+		fOverlayReader = WCSimVectorFileReader::Create(fOverlayFileName);
+		if (!fOverlayReader->Open(fOverlayFileName))
 		{
-			fOverlayFile.close();
+			G4cout << "Could not open the overlay vector file " << fOverlayFileName << G4endl;
 		}
-		fOverlayFileName = fileName;
-		fOverlayFile.open(fOverlayFileName, std::fstream::in);
 	}
 
 	inline void AddOverlayFile(G4String fileName)
 	{
 		fOverlayFileVec.push_back(fileName);
+		fOverlayRangeSet = false;
 		if (fOverlayFileVec.size() == 1)
 		{
 			fOverlayFileIterator = fOverlayFileVec.begin();
@@ -5,6 +5,7 @@ class G4UIdirectory;
 class G4UIcmdWithAString;
 class G4UIcmdWithABool;
 class G4UIcmdWithADouble;
+class G4UIcmdWithAnInteger;
 
 #include "G4UImessenger.hh"
 #include "globals.hh"
@@ -35,4 +36,9 @@ private:
 	G4UIcmdWithADouble *fFiducialBorderCmd;
 	// Toggle to swap X and Z for beam events generated along Z (ie with GENIE).
 	G4UIcmdWithABool *fSwapXZCmd;
+	// Which events of the vector files this job should read
+	G4UIcmdWithAnInteger *fFirstEventCmd;
+	G4UIcmdWithAString *fShardCmd;
+	// Check and time the detector entry point of the overlay muons
+	G4UIcmdWithAnInteger *fBenchmarkOverlayCmd;
 };
@@ -225,9 +225,10 @@ private:
 	Int_t fRun;
 	Int_t fDate;
 	Int_t fSubEvtNumber;
+	UInt_t fDigiSeed; // Seed of the digitization, see WCSimDigiRandom
 
 public:
-	WCSimRootEventHeader() : fEvtNum(0), fRun(0), fDate(0), fSubEvtNumber(1)
+	WCSimRootEventHeader() : fEvtNum(0), fRun(0), fDate(0), fSubEvtNumber(1), fDigiSeed(0)
 	{
 	}
 	virtual ~WCSimRootEventHeader()
@@ -239,11 +240,16 @@ public:
 		fRun = r;
 		fDate = d;
 		fSubEvtNumber = s;
+		fDigiSeed = 0;
 	}
 	void SetDate(Int_t d)
 	{
 		fDate = d;
 	}
+	void SetDigiSeed(UInt_t seed)
+	{
+		fDigiSeed = seed;
+	}
 	Int_t GetEvtNum() const
 	{
 		return fEvtNum;
@@ -260,8 +266,12 @@ public:
 	{
 		return fSubEvtNumber;
 	}
+	UInt_t GetDigiSeed() const
+	{
+		return fDigiSeed;
+	}
 
-	ClassDef(WCSimRootEventHeader, 2)
+	ClassDef(WCSimRootEventHeader, 3)
 	//WCSimRootEvent Header
 };
 
@@ -287,6 +297,8 @@ public:
 	}
 
 	void Set(Float_t pi0Vtx[3], Int_t gammaID[2], Float_t gammaE[2], Float_t gammaVtx[2][3]);
+	// Set everything to 0, for a trigger that is used again
+	void Clear(Option_t *option = "");
 
 	Float_t GetPi0Vtx(int i) const
 	{
@@ -337,6 +349,14 @@ private:
 	Int_t fNcherenkovhittimes;		  // Number of hits in the array
 	TClonesArray *fCherenkovHitTimes; //-> Array of WCSimRootCherenkovHits
 
+	// The raw hits packed by tube, see AddPackedCherenkovHit()
+	std::vector<Int_t> fPackedTubeID;
+	std::vector<Int_t> fPackedNumPe;
+	std::vector<UChar_t> fPackedTimes;	 // Varint steps between the ordered times of each tube
+	std::vector<Int_t> fPackedParentID;	 // Parent ID of each run of photons
+	std::vector<Int_t> fPackedParentRun; // Number of photons in each run
+	std::vector<UInt_t> fPackOrder;		 //! time order of the photons being packed
+
 	Int_t fNumDigitizedTubes;  // Number of digitized tubes
 	Int_t fNcherenkovdigihits; // Number of digihits in the array
 	Float_t fSumQ;
@@ -346,13 +366,16 @@ private:
 
 public:
 	WCSimRootTrigger();
-	WCSimRootTrigger(int, int);
+	WCSimRootTrigger(int, int, int capacity = 10000);
 	virtual ~WCSimRootTrigger();
 
-	void Initialize();
+	// Allocate the arrays with room for capacity objects, they grow if more are added
+	void Initialize(int capacity = 10000);
 
 	void Clear(Option_t *option = "");
 	static void Reset(Option_t *option = "");
+	// Remove the digits but keep the tracks and raw hits
+	void ClearDigits();
 
 	void SetHeader(Int_t i, Int_t run, Int_t date, Int_t subevtn = 1);
 	bool IsASubEvent()
@@ -471,8 +494,8 @@ public:
 		return fTracks;
 	}
 
-	WCSimRootCherenkovHit *AddCherenkovHit(Int_t tubeID, std::vector<Float_t> truetime,
-										   std::vector<Int_t> primParID);
+	WCSimRootCherenkovHit *AddCherenkovHit(Int_t tubeID, const std::vector<Float_t> &truetime,
+										   const std::vector<Int_t> &primParID);
 	TClonesArray *GetCherenkovHits() const
 	{
 		return fCherenkovHits;
@@ -482,6 +505,21 @@ public:
 		return fCherenkovHitTimes;
 	}
 
+	// Store the photons of one tube in the packed form rather than as one
+	// WCSimRootCherenkovHitTime each. The times are put in order and each one
+	// is saved as the step from the one before, as a variable length integer
+	// of the bits of the float, so they come back exactly. The parent IDs are
+	// saved as runs of the same ID.
+	void AddPackedCherenkovHit(Int_t tubeID, const std::vector<Float_t> &truetime, const std::vector<Int_t> &primParID);
+	Int_t GetNpackedhits() const
+	{
+		return fPackedTubeID.size();
+	}
+	// The raw hits of either form, with the times of tube tubeIDs[i] in the
+	// numPe[i] entries of times and parentIDs after those of the tubes before it
+	void GetRawHits(std::vector<Int_t> &tubeIDs, std::vector<Int_t> &numPe, std::vector<Float_t> &times,
+					std::vector<Int_t> &parentIDs) const;
+
 	WCSimRootCherenkovDigiHit *AddCherenkovDigiHit(Float_t q, Float_t t, Int_t tubeid);
 	//  WCSimRootCherenkovDigiHit   *AddCherenkovDigiHit(Float_t q,
 	//						  Float_t t,
@@ -493,7 +531,7 @@ public:
 		return fCherenkovDigiHits;
 	}
 
-	ClassDef(WCSimRootTrigger, 1)
+	ClassDef(WCSimRootTrigger, 2)
 	//WCSimRootEvent structure
 };
 
@@ -533,16 +571,8 @@ public:
 	//Int_t GetNumberOfSubEvents() const { return (fEventList.size()-1);}
 
 	//void AddSubEvent() { fEventList.push_back(new WCSimRootTrigger()); }
-	void AddSubEvent()
-	{
-		// be sure not to call the default constructor BUT the actual one
-		WCSimRootTrigger *tmp = dynamic_cast<WCSimRootTrigger *>((*fEventList)[0]);
-		int num = tmp->GetHeader()->GetEvtNum();
-		++Current;
-		if (Current > 9)
-			fEventList->Expand(20);
-		fEventList->AddAt(new WCSimRootTrigger(num, Current), Current);
-	}
+	// Add a trigger after the existing ones, reusing one from the pool if there is one
+	void AddSubEvent();
 
 	/*  void ReInitialize() { // need to remove all subevents at the end, or they just get added anyway...
 		 std::vector<WCSimRootTrigger*>::iterator  iter = fEventList.begin();
@@ -550,18 +580,26 @@ public:
 		 */
 	void Initialize();
 
-	void ReInitialize()
-	{ // need to remove all subevents at the end, or they just get added anyway...
-		for (int i = fEventList->GetLast(); i >= 1; i--)
-		{
-			//      std::cout << "removing element # " << i << "...";
-			WCSimRootTrigger *tmp = dynamic_cast<WCSimRootTrigger *>(fEventList->RemoveAt(i));
-			delete tmp;
-			//std::cout <<"done !\n";
-		}
-		Current = 0;
-		WCSimRootTrigger *tmp = dynamic_cast<WCSimRootTrigger *>((*fEventList)[0]);
-		tmp->Clear();
+	// Remove all the sub-events and clear the first trigger, ready for the next event.
+	// The sub-events are cleared and kept in the pool rather than deleted.
+	void ReInitialize();
+	// Remove the sub-events and the digits of the first trigger, keeping its
+	// tracks and raw hits so that they can be digitized again
+	void ClearDigits();
+
+	// Whether to keep the sub-event triggers for the next events (default) or delete them
+	void SetReuseTriggers(bool reuse)
+	{
+		fReuseTriggers = reuse;
+	}
+	bool GetReuseTriggers() const
+	{
+		return fReuseTriggers;
+	}
+	// Initial size of the hit and digit arrays of newly allocated triggers
+	Int_t GetCapacityHint() const
+	{
+		return fCapacityHint;
 	}
 
 	// Get and set the truth summary object
@@ -581,5 +619,9 @@ private:
 
 	TObjArray *fEventList;
 	Int_t Current; //!               means transient, not writable to file
+
+	std::vector<WCSimRootTrigger *> fTriggerPool; //! cleared sub-events waiting to be reused
+	bool fReuseTriggers;						  //!
+	Int_t fCapacityHint;						  //! array size for new triggers, grows with the events seen
 	ClassDef(WCSimRootEvent, 1)
 };
@@ -18,6 +18,7 @@
 #pragma link C++ class WCSimCHIPSPMT+;
 #pragma link C++ class WCSimSK1pePMT+;
 #pragma link C++ class WCSimTOTPMT+;
+#pragma link C++ class WCSimEvDisplayHitMaps;
 #pragma link C++ class WCSimEvDisplay+;
 #pragma link C++ class WCSimTruthSummary+;
 #pragma link C++ class WCSimLCConfig+;
@@ -10,8 +10,11 @@
 #include "WCSimRootGeom.hh"
 #include "WCSimDetectorConstruction.hh"
 
+#include <chrono>
+
 class G4Run;
 class WCSimRunActionMessenger;
+class WCSimFlatNtuple;
 
 class WCSimRunAction : public G4UserRunAction
 {
@@ -56,6 +59,14 @@ public:
 	{
 		return PhotonNtupleName;
 	}
+	void SetPhotonNtuplePrescale(const G4int &prescale)
+	{
+		PhotonNtuplePrescale = prescale;
+	}
+	G4int GetPhotonNtuplePrescale() const
+	{
+		return PhotonNtuplePrescale;
+	}
 
 	void SetSaveEmissionProfile(const G4bool &saveIt)
 	{
@@ -74,6 +85,81 @@ public:
 		return EmissionProfileName;
 	}
 
+	// Output policy for the event tree: save the tree header every N events
+	// or every N MB written (the events setting wins if both are set), plus
+	// the basket size and compression level of the file.
+	void SetAutoSaveEvents(const G4int &nEvents)
+	{
+		AutoSaveEvents = nEvents;
+	}
+	G4int GetAutoSaveEvents() const
+	{
+		return AutoSaveEvents;
+	}
+	void SetAutoSaveMBytes(const G4int &nMBytes)
+	{
+		AutoSaveMBytes = nMBytes;
+	}
+	G4int GetAutoSaveMBytes() const
+	{
+		return AutoSaveMBytes;
+	}
+	void SetBasketSize(const G4int &size)
+	{
+		BasketSize = size;
+	}
+	G4int GetBasketSize() const
+	{
+		return BasketSize;
+	}
+	void SetCompressionLevel(const G4int &level)
+	{
+		CompressionLevel = level;
+	}
+	G4int GetCompressionLevel() const
+	{
+		return CompressionLevel;
+	}
+
+	// Also write the digits and geometry as flat vectors, see WCSimFlatNtuple
+	void SetSaveFlatNtuple(const G4bool &saveIt)
+	{
+		SaveFlatNtuple = saveIt;
+	}
+	G4bool GetSaveFlatNtuple() const
+	{
+		return SaveFlatNtuple;
+	}
+	// Save the true photon times on each tube as well as the digits, which is
+	// what chipsdigi needs to digitize the events again
+	void SetSaveRawHits(const G4bool &saveIt)
+	{
+		SaveRawHits = saveIt;
+	}
+	G4bool GetSaveRawHits() const
+	{
+		return SaveRawHits;
+	}
+	// Zero unless the flat ntuple is being saved this run
+	WCSimFlatNtuple *GetFlatNtuple()
+	{
+		return fFlatNtuple;
+	}
+
+	// In multithreaded mode each worker writes its own output files, named
+	// after the requested file with the thread number added. The master then
+	// merges the event files into the requested file if asked to.
+	void SetMergeThreadFiles(const G4bool &mergeThem)
+	{
+		MergeThreadFiles = mergeThem;
+	}
+	G4bool GetMergeThreadFiles() const
+	{
+		return MergeThreadFiles;
+	}
+	G4String GetThreadFileName(const G4String &fileName) const;
+	static G4String GetThreadFileName(const G4String &fileName, G4int threadID);
+
 	void FillGeoTree();
 	TTree *GetTree()
 	{
@@ -139,19 +225,35 @@ public:
 	}
 
 private:
+	// True for the master of a multithreaded run, which does no event processing
+	G4bool IsMultithreadedMaster() const;
+	// Merge the event files written by the worker threads
+	void MergeWorkerFiles();
+
 	// MFechner : set by the messenger
 	std::string RootFileName;
 	std::string PhotonNtupleName;
 	std::string EmissionProfileName;
 	bool SaveRootFile;
 	bool SavePhotonNtuple;
+	int PhotonNtuplePrescale;
 	bool SaveEmissionProfile;
+	int AutoSaveEvents;
+	int AutoSaveMBytes;
+	int BasketSize;
+	int CompressionLevel;
+	bool MergeThreadFiles;
+	bool SaveFlatNtuple;
+	bool SaveRawHits;
+	// Start of the run, for the events/s printed at the end
+	std::chrono::steady_clock::time_point runStartTime;
 	//
 	TTree *WCSimTree;
 	TTree *geoTree;
 	TFile *hfile;
 	WCSimRootEvent *wcsimrootsuperevent;
 	WCSimRootGeom *wcsimrootgeom;
+	WCSimFlatNtuple *fFlatNtuple;
 	WCSimDetectorConstruction *wcsimdetector;
 
 	int numberOfEventsGenerated;
@@ -4,6 +4,7 @@ class WCSimRunAction;
 class G4UIdirectory;
 class G4UIcmdWithAString;
 class G4UIcmdWithABool;
+class G4UIcmdWithAnInteger;
 #include "G4UImessenger.hh"
 #include "globals.hh"
 
@@ -26,6 +27,14 @@ private:
 	G4UIcmdWithAString *RootFile;
 	G4UIcmdWithABool *SavePhotonNtuple;
 	G4UIcmdWithAString *PhotonNtuple;
+	G4UIcmdWithAnInteger *PhotonNtuplePrescale;
 	G4UIcmdWithABool *SaveEmissionProfile;
 	G4UIcmdWithAString *EmissionProfile;
+	G4UIcmdWithAnInteger *AutoSaveEvents;
+	G4UIcmdWithAnInteger *AutoSaveMBytes;
+	G4UIcmdWithAnInteger *BasketSize;
+	G4UIcmdWithAnInteger *CompressionLevel;
+	G4UIcmdWithABool *MergeThreadFiles;
+	G4UIcmdWithABool *SaveFlatNtuple;
+	G4UIcmdWithABool *SaveRawHits;
 };
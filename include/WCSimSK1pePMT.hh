@@ -1,6 +1,7 @@
 #pragma once
 
 #include <iostream>
+#include <vector>
 #include "TRandom3.h"
 
 class WCSimSK1pePMT
@@ -15,9 +16,47 @@ public:
 	// with time spread end - start.
 	double CalculateCharge(int pe);
 
+	// Tubes with at least this many pe get their summed 1pe charge from a single
+	// Gaussian draw with the mean and variance of the 1pe spectrum. 0 turns it off.
+	void SetGaussianThreshold(int pe)
+	{
+		fGaussianThreshold = pe;
+	}
+	int GetGaussianThreshold() const
+	{
+		return fGaussianThreshold;
+	}
+
+	// Seed of the charge draws, set by the digitizer for each event
+	void SetSeed(UInt_t seed)
+	{
+		fRand.SetSeed(seed);
+	}
+
+	// Compare the guide table sampler with the linear search over nSamples
+	// draws, and the Gaussian approximation with the summed spectrum at a few
+	// pe values. Prints the chi-square per degree of freedom of each.
+	void ValidateSampler(int nSamples);
+
 private:
+	// Draw the charge of a single pe with the guide table
 	double rn1pe();
+	// The original linear search through the cumulative table, kept for validation
+	double rn1peLinear();
+	// Sum of pe single pe charges, before the threshold
+	double SumCharge(int pe);
 	double Threshold(double pe);
 
+	// Build the guide table and the moments of the 1pe spectrum
+	void BuildSampler();
+
 	TRandom3 fRand;
+
+	// fGuide[k] is the first entry of the cumulative table >= k / fGuide.size(),
+	// so the search for a random number starts at most a few entries away.
+	std::vector<int> fGuide;
+
+	double fMean1pe;
+	double fSigma1pe;
+	int fGaussianThreshold;
 };
@@ -5,12 +5,14 @@
 #include "WCSimDetectorConstruction.hh"
 
 class G4Track;
+class WCSimRunAction;
+class WCSimPrimaryGeneratorAction;
 
 class WCSimStackingAction : public G4UserStackingAction
 {
 
 public:
-	WCSimStackingAction(WCSimDetectorConstruction *);
+	WCSimStackingAction(WCSimDetectorConstruction *, WCSimRunAction *, WCSimPrimaryGeneratorAction *);
 	virtual ~WCSimStackingAction();
 
 public:
@@ -20,4 +22,11 @@ public:
 
 private:
 	WCSimDetectorConstruction *DetConstruct;
+	WCSimRunAction *fRunAction;
+	WCSimPrimaryGeneratorAction *fGeneratorAction;
+
+	// Are the emission profiles being filled this event?
+	G4bool fFillEmissionProfile;
+	// Are the photons being saved to the photon ntuple this event?
+	G4bool fRecordPhotons;
 };
@@ -7,12 +7,30 @@ class WCSimTOTPMT
 {
 
 public:
+	// The PMTs we have a time over threshold response for
+	enum TOTModel
+	{
+		kNoModel = 0,
+		kNikhef,
+		kMadison
+	};
+
 	// Constructors / Destructor
 	WCSimTOTPMT();
 	~WCSimTOTPMT();
 
+	// Which response to use for the named PMT type, kNoModel if there isn't one
+	static TOTModel GetModel(const std::string &PMTName);
+
 	// Calculate the charge from pe photoelectrons on the cathode
 	double CalculateCharge(int totalPe, std::string PMTName);
+	double CalculateCharge(int totalPe, TOTModel model);
+
+	// Seed of the time over threshold smearing
+	void SetSeed(UInt_t seed)
+	{
+		fRand.SetSeed(seed);
+	}
 
 private:
 	TRandom3 fRand;
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "globals.hh"
+#include <set>
+#include <vector>
+
+class WCSimTrajectory;
+class WCSimTrackFilterMessenger;
+class G4TrajectoryContainer;
+
+// Decides which trajectories are written to the output file as truth tracks.
+// A track is kept if it is a primary (when primaries are saved), has one of
+// the chosen PDG codes, has a parent with one of the chosen PDG codes, or was
+// made by one of the chosen processes. Non-primary tracks also need at least
+// the minimum kinetic energy. The rules are set from the macro with the
+// /WCSimTrack/filter/ commands.
+class WCSimTrackFilter
+{
+public:
+	WCSimTrackFilter();
+	~WCSimTrackFilter();
+
+	// Make one pass over the trajectories and fill selected with those to
+	// save. parentTypes gets the PDG code of the parent of each selected track:
+	// 0 for primaries and 999 if the parent has no stored trajectory.
+	void Select(G4TrajectoryContainer *trajectories, std::vector<WCSimTrajectory *> &selected,
+				std::vector<G4int> &parentTypes);
+
+	void SetSavePrimaries(G4bool save)
+	{
+		fSavePrimaries = save;
+	}
+	void AddPDG(G4int pdg)
+	{
+		fPDGs.insert(pdg);
+	}
+	void AddParentPDG(G4int pdg)
+	{
+		fParentPDGs.insert(pdg);
+	}
+	void AddCreatorProcess(G4String process)
+	{
+		fProcesses.insert(process);
+	}
+	// Kinetic energy in Geant4 units
+	void SetMinEnergy(G4double energy)
+	{
+		fMinEnergy = energy;
+	}
+	// Most tracks to save per event, 0 for no limit
+	void SetMaxTracks(G4int maxTracks)
+	{
+		fMaxTracks = maxTracks;
+	}
+
+	// Remove all of the rules except saving the primaries
+	void Clear();
+	void Print() const;
+
+private:
+	G4bool fSavePrimaries;
+	std::set<G4int> fPDGs;
+	std::set<G4int> fParentPDGs;
+	std::set<G4String> fProcesses;
+	G4double fMinEnergy;
+	G4int fMaxTracks;
+
+	// PDG code of each track ID seen so far this event. An entry is only
+	// valid if its stamp matches the current event, so nothing needs clearing.
+	std::vector<G4int> fTrackPDG;
+	std::vector<G4int> fTrackStamp;
+	G4int fStamp;
+
+	WCSimTrackFilterMessenger *fMessenger;
+};
@@ -0,0 +1,37 @@
+#pragma once
+
+class WCSimTrackFilter;
+class G4UIdirectory;
+class G4UIcmdWithABool;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithAString;
+class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWithoutParameter;
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class WCSimTrackFilterMessenger : public G4UImessenger
+{
+public:
+	WCSimTrackFilterMessenger(WCSimTrackFilter *filter);
+	~WCSimTrackFilterMessenger();
+
+public:
+	void SetNewValue(G4UIcommand *command, G4String newValues);
+
+private:
+	WCSimTrackFilter *fTrackFilter;
+
+private:
+	//commands
+	G4UIdirectory *FilterDir;
+	G4UIcmdWithABool *SavePrimaries;
+	G4UIcmdWithAnInteger *AddPDG;
+	G4UIcmdWithAnInteger *AddParentPDG;
+	G4UIcmdWithAString *AddProcess;
+	G4UIcmdWithADoubleAndUnit *MinEnergy;
+	G4UIcmdWithAnInteger *MaxTracks;
+	G4UIcmdWithoutParameter *Clear;
+	G4UIcmdWithoutParameter *Print;
+};
@@ -57,16 +57,21 @@ public:
 	void Print() const;
 };
 
-extern G4Allocator<WCSimTrackInformation> aWCSimTrackInfoAllocator;
+// One allocator per thread, created on first use
+extern G4ThreadLocal G4Allocator<WCSimTrackInformation> *aWCSimTrackInfoAllocator;
 
 inline void *WCSimTrackInformation::operator new(size_t)
 {
 	void *aTrackInfo;
-	aTrackInfo = (void *)aWCSimTrackInfoAllocator.MallocSingle();
+	if (!aWCSimTrackInfoAllocator)
+	{
+		aWCSimTrackInfoAllocator = new G4Allocator<WCSimTrackInformation>;
+	}
+	aTrackInfo = (void *)aWCSimTrackInfoAllocator->MallocSingle();
 	return aTrackInfo;
 }
 
 inline void WCSimTrackInformation::operator delete(void *aTrackInfo)
 {
-	aWCSimTrackInfoAllocator.FreeSingle((WCSimTrackInformation *)aTrackInfo);
+	aWCSimTrackInfoAllocator->FreeSingle((WCSimTrackInformation *)aTrackInfo);
 }
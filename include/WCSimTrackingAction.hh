@@ -21,6 +21,16 @@ public:
 	void SetPercentCherenkovPhotonsToDraw(const double &percent);
 	void SetFractionCherenkovPhotonsToDraw(const double &frac);
 
+	// Keep only the start and end points of each trajectory rather than every step
+	void SetSummaryTrajectories(const bool &summary)
+	{
+		fSummaryTrajectories = summary;
+	}
+	bool GetSummaryTrajectories() const
+	{
+		return fSummaryTrajectories;
+	}
+
 private:
 	std::set<G4String> ProcessList;
 	std::set<G4int> ParticleList;
@@ -28,4 +38,5 @@ private:
 	WCSimTrackingActionMessenger *fMessenger;
 
 	double fFractionCherenkovPhotonsToDraw;
+	bool fSummaryTrajectories;
 };
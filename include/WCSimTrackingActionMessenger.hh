@@ -3,6 +3,8 @@
 class WCSimTrackingAction;
 class G4UIdirectory;
 class G4UIcmdWithADouble;
+class G4UIcmdWithAString;
+class G4UIcmdWithAnInteger;
 
 #include "G4UImessenger.hh"
 #include "globals.hh"
@@ -26,4 +28,10 @@ private:
 	// How many Cherenkov photons should we save?
 	// A double between 0 and 100.0 (i.e. %)
 	G4UIcmdWithADouble *PercentCherenkovPhotonsToDraw;
+
+	// Keep every step of the trajectories (full) or just the ends (summary)
+	G4UIcmdWithAString *TrajectoryMode;
+
+	// Time the construction of trajectories
+	G4UIcmdWithAnInteger *BenchmarkTrajectory;
 };
@@ -15,6 +15,7 @@ class WCSimTrajectory;
 #include "CLHEP/Units/SystemOfUnits.h"
 
 class G4Polyline;
+class G4VProcess;
 // Forward declaration.
 
 typedef std::vector<G4VTrajectoryPoint *> TrajectoryPointContainer;
@@ -32,7 +33,9 @@ public:
 
 	WCSimTrajectory();
 
-	WCSimTrajectory(const G4Track *aTrack);
+	// With summaryOnly only the start and end points of the track are kept,
+	// rather than a point for every step
+	WCSimTrajectory(const G4Track *aTrack, G4bool summaryOnly = false);
 	WCSimTrajectory(WCSimTrajectory &);
 	virtual ~WCSimTrajectory();
 
@@ -57,9 +60,12 @@ public:
 	{
 		return fProcessID;
 	}
+	// The names are only looked up when asked for, the trajectory itself
+	// just keeps the particle definition and the creator process. This
+	// overrides G4VTrajectory, so it has to return by value.
 	inline G4String GetParticleName() const
 	{
-		return ParticleName;
+		return fParticleDefinition->GetParticleName();
 	}
 	inline G4double GetCharge() const
 	{
@@ -73,9 +79,10 @@ public:
 	{
 		return initialMomentum;
 	}
-	inline G4String GetCreatorProcessName() const
+	const G4String &GetCreatorProcessName() const;
+	inline const G4VProcess *GetCreatorProcess() const
 	{
-		return creatorProcess;
+		return fCreatorProcess;
 	}
 	inline G4double GetWavelength() const
 	{
@@ -163,9 +170,10 @@ public:
 	{
 		return stoppingVolume;
 	}
-	inline void SetStoppingPoint(G4ThreeVector &currentPosition)
+	void SetStoppingPoint(G4ThreeVector &currentPosition);
+	inline G4bool IsSummaryOnly() const
 	{
-		stoppingPoint = currentPosition;
+		return fSummaryOnly;
 	}
 	inline void SetStoppingVolume(G4VPhysicalVolume *currentVolume)
 	{
@@ -190,7 +198,14 @@ public:
 	}
 	virtual void MergeTrajectory(G4VTrajectory *secondTrajectory);
 
-	G4ParticleDefinition *GetParticleDefinition();
+	inline G4ParticleDefinition *GetParticleDefinition() const
+	{
+		return fParticleDefinition;
+	}
+
+	// Print the time taken to make and delete a trajectory, in both the summary
+	// and full modes, and to find its particle definition by name and by pointer
+	static void BenchmarkConstruction(G4int nTracks);
 
 	virtual const std::map<G4String, G4AttDef> *GetAttDefs() const;
 	virtual std::vector<G4AttValue> *CreateAttValues() const;
@@ -205,7 +220,7 @@ private:
 	G4int fProcessID;
 	G4int PDGEncoding;
 	G4double PDGCharge;
-	G4String ParticleName;
+	G4ParticleDefinition *fParticleDefinition;
 	G4ThreeVector initialMomentum;
 
 	G4double fEnergy;
@@ -229,9 +244,12 @@ private:
 	G4bool fIsOpticalPhoton;
 	G4bool fIsScatteredPhoton;
 
+	// Only keep the first and last points
+	G4bool fSummaryOnly;
+
 	// M Fechner : new saving mechanism
 	G4bool SaveIt;
-	G4String creatorProcess;
+	const G4VProcess *fCreatorProcess; // 0 for primaries
 	G4double globalTime;
 };
 
@@ -245,16 +263,21 @@ private:
  #endif
  */
 
-extern G4Allocator<WCSimTrajectory> myTrajectoryAllocator;
+// One allocator per thread, created on first use
+extern G4ThreadLocal G4Allocator<WCSimTrajectory> *myTrajectoryAllocator;
 
 inline void *WCSimTrajectory::operator new(size_t)
 {
 	void *aTrajectory;
-	aTrajectory = (void *)myTrajectoryAllocator.MallocSingle();
+	if (!myTrajectoryAllocator)
+	{
+		myTrajectoryAllocator = new G4Allocator<WCSimTrajectory>;
+	}
+	aTrajectory = (void *)myTrajectoryAllocator->MallocSingle();
 	return aTrajectory;
 }
 
 inline void WCSimTrajectory::operator delete(void *aTrajectory)
 {
-	myTrajectoryAllocator.FreeSingle((WCSimTrajectory *)aTrajectory);
+	myTrajectoryAllocator->FreeSingle((WCSimTrajectory *)aTrajectory);
 }
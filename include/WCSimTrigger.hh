@@ -0,0 +1,96 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Trigger algorithms for the digitizer. Each one takes a list of hit times in
+// ascending order and makes a single pass over it to find the trigger times.
+// They only depend on the standard library so that the same code can be run
+// on the hits saved in the output file, see src/apps/triggerreplay.cc.
+class WCSimTrigger
+{
+public:
+	// threshold is the number of hits needed, window is in ns and is used as
+	// each algorithm describes, and deadTime (ns) is how long after a trigger
+	// before the next one can start.
+	WCSimTrigger(int threshold, double window, double deadTime);
+	virtual ~WCSimTrigger();
+
+	// Fill triggerTimes from the sorted hit times, clearing it first
+	virtual void FindTriggers(const std::vector<double> &times, std::vector<double> &triggerTimes) const = 0;
+
+	// True if the algorithm wants the time of every photon, rather than the
+	// first hit time of each PMT
+	virtual bool UsesAllHitTimes() const
+	{
+		return false;
+	}
+
+	virtual std::string GetName() const = 0;
+
+	int GetThreshold() const
+	{
+		return fThreshold;
+	}
+	double GetWindow() const
+	{
+		return fWindow;
+	}
+	double GetDeadTime() const
+	{
+		return fDeadTime;
+	}
+
+	// Make a trigger by name: "gap", "nhits" or "ndigits". Returns 0 for anything else.
+	static WCSimTrigger *Create(const std::string &type, int threshold, double window, double deadTime);
+
+protected:
+	int fThreshold;
+	double fWindow;
+	double fDeadTime;
+};
+
+// The original CHIPS trigger: a chain of PMT first hits with no gap longer
+// than the window between neighbours, and at least threshold hits in the
+// chain. The trigger time is the first hit of the chain.
+class WCSimGapTrigger : public WCSimTrigger
+{
+public:
+	WCSimGapTrigger(int threshold, double window, double deadTime);
+
+	void FindTriggers(const std::vector<double> &times, std::vector<double> &triggerTimes) const;
+	std::string GetName() const
+	{
+		return "gap";
+	}
+};
+
+// At least threshold PMT first hits inside a sliding window of fixed length.
+// The trigger time is the first hit in the window.
+class WCSimNHitsTrigger : public WCSimTrigger
+{
+public:
+	WCSimNHitsTrigger(int threshold, double window, double deadTime);
+
+	void FindTriggers(const std::vector<double> &times, std::vector<double> &triggerTimes) const;
+	std::string GetName() const
+	{
+		return "nhits";
+	}
+};
+
+// As WCSimNHitsTrigger, but counting every photoelectron rather than each PMT once
+class WCSimNDigitsTrigger : public WCSimNHitsTrigger
+{
+public:
+	WCSimNDigitsTrigger(int threshold, double window, double deadTime);
+
+	bool UsesAllHitTimes() const
+	{
+		return true;
+	}
+	std::string GetName() const
+	{
+		return "ndigits";
+	}
+};
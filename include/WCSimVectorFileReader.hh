@@ -0,0 +1,193 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+// One particle from a vector file. The direction is the unit vector given in
+// the file and the energy is the total energy in MeV.
+struct WCSimVectorParticle
+{
+	int pdg;
+	double energy;
+	double dir[3];
+	// 0 for particles that leave the nucleus, -1 for the neutrino and target
+	int status;
+};
+
+// One event from a vector file, in the units of the file: cm, ns and MeV
+struct WCSimVectorEvent
+{
+	int mode;
+	double vtx[4];
+	WCSimVectorParticle beam;
+	WCSimVectorParticle target;
+	std::vector<WCSimVectorParticle> tracks;
+
+	void Clear();
+};
+
+// Reads the events of a vector file one at a time. The readers only depend on
+// the standard library so that the same code is used by the generator action
+// and by the vectorconvert tool.
+class WCSimVectorFileReader
+{
+public:
+	virtual ~WCSimVectorFileReader();
+
+	virtual bool Open(const std::string &fileName) = 0;
+	virtual void Close() = 0;
+	virtual bool IsOpen() const = 0;
+
+	// Read the next event, false at the end of the file
+	virtual bool ReadEvent(WCSimVectorEvent &event) = 0;
+
+	// Move past up to nEvents events and return how many there were
+	virtual int SkipEvents(int nEvents);
+
+	// Position the reader so that the next ReadEvent returns this event (counting
+	// from 0), false if the file doesn't have that many events
+	virtual bool SeekEvent(int event) = 0;
+
+	// Make sure the reader knows where every event starts, so that the number of
+	// events is known and seeking doesn't read through the file
+	virtual bool BuildIndex()
+	{
+		return true;
+	}
+
+	// Total number of events in the file, -1 if it isn't known without reading it all
+	virtual int GetNumberOfEvents() const
+	{
+		return -1;
+	}
+
+	// Make the reader for this file: ".vecb" files are binary, anything else is
+	// read as a NUANCE text file. The file is not opened.
+	static WCSimVectorFileReader *Create(const std::string &fileName);
+};
+
+// The NUANCE text format written by GENIE's gevgen and the cosmic generators:
+//   $ begin
+//   $ nuance mode
+//   $ vertex x y z t
+//   $ track pdg E dx dy dz -1   (neutrino)
+//   $ track pdg E dx dy dz -1   (target)
+//   $ track pdg E dx dy dz status
+//   ...
+//   $ end
+// The offsets of the begin lines can be indexed so that events are found with
+// a seek. BuildIndex() reads the file once and caches the index next to it as
+// <file>.idx, which is picked up by Open() as long as the file hasn't changed size.
+// The cache is written under a temporary name and renamed, so jobs sharing the
+// file never read one that is half written.
+class WCSimTextVectorReader : public WCSimVectorFileReader
+{
+public:
+	WCSimTextVectorReader();
+	~WCSimTextVectorReader();
+
+	bool Open(const std::string &fileName);
+	void Close();
+	bool IsOpen() const
+	{
+		return fFile.is_open();
+	}
+
+	bool ReadEvent(WCSimVectorEvent &event);
+	// Uses the index if there is one, otherwise reads through the events
+	int SkipEvents(int nEvents);
+	bool SeekEvent(int event);
+
+	bool BuildIndex();
+	bool HasIndex() const
+	{
+		return fIndexed;
+	}
+	int GetNumberOfEvents() const
+	{
+		return fIndexed ? static_cast<int>(fOffsets.size()) : -1;
+	}
+
+private:
+	bool LoadIndex();
+	void SaveIndex() const;
+	long long GetFileSize() const;
+
+	// Read the next line into fLine and point fPos at the first number after
+	// the keyword, which is returned. Empty at the end of the file.
+	std::string ReadLine();
+	int NextInt();
+	double NextDouble();
+	void ReadParticle(WCSimVectorParticle &particle);
+
+	std::ifstream fFile;
+	std::string fFileName;
+	std::string fLine;
+	const char *fPos;
+
+	// Number of the event the next ReadEvent will return
+	int fNextEvent;
+	bool fIndexed;
+	std::vector<long long> fOffsets;
+};
+
+// Binary copy of a vector file, written by vectorconvert. All numbers are in
+// the byte order of the machine that wrote the file:
+//   char[4] "CVEC", int32 version, int32 number of events, int64 index offset
+//   per event: int32 mode, double vtx[4], beam, target, int32 nTracks, tracks
+//   per particle: int32 pdg, int32 status, double energy, double dir[3]
+//   index: int64 file offset of each event
+// The index means any event can be read without going through the ones before it.
+class WCSimBinaryVectorReader : public WCSimVectorFileReader
+{
+public:
+	WCSimBinaryVectorReader();
+	~WCSimBinaryVectorReader();
+
+	bool Open(const std::string &fileName);
+	void Close();
+	bool IsOpen() const
+	{
+		return fFile.is_open();
+	}
+
+	bool ReadEvent(WCSimVectorEvent &event);
+	int SkipEvents(int nEvents);
+	bool SeekEvent(int event);
+	int GetNumberOfEvents() const
+	{
+		return fOffsets.size();
+	}
+
+private:
+	void ReadParticle(WCSimVectorParticle &particle);
+
+	std::ifstream fFile;
+	std::vector<long long> fOffsets;
+	int fNextEvent;
+};
+
+// Writes the binary format read by WCSimBinaryVectorReader
+class WCSimBinaryVectorWriter
+{
+public:
+	WCSimBinaryVectorWriter();
+	~WCSimBinaryVectorWriter();
+
+	bool Open(const std::string &fileName);
+	void WriteEvent(const WCSimVectorEvent &event);
+	// Write the index and the header, must be called to make a readable file
+	void Close();
+
+	int GetNumberOfEvents() const
+	{
+		return fOffsets.size();
+	}
+
+private:
+	void WriteParticle(const WCSimVectorParticle &particle);
+
+	std::ofstream fFile;
+	std::vector<long long> fOffsets;
+};
@@ -82,16 +82,21 @@ public:
 };
 
 typedef G4TDigiCollection<WCSimWCDigi> WCSimWCDigitsCollection;
-extern G4Allocator<WCSimWCDigi> WCSimWCDigiAllocator;
+// One allocator per thread, created on first use
+extern G4ThreadLocal G4Allocator<WCSimWCDigi> *WCSimWCDigiAllocator;
 
 inline void *WCSimWCDigi::operator new(size_t)
 {
 	void *aDigi;
-	aDigi = (void *)WCSimWCDigiAllocator.MallocSingle();
+	if (!WCSimWCDigiAllocator)
+	{
+		WCSimWCDigiAllocator = new G4Allocator<WCSimWCDigi>;
+	}
+	aDigi = (void *)WCSimWCDigiAllocator->MallocSingle();
 	return aDigi;
 }
 
 inline void WCSimWCDigi::operator delete(void *aDigi)
 {
-	WCSimWCDigiAllocator.FreeSingle((WCSimWCDigi *)aDigi);
+	WCSimWCDigiAllocator->FreeSingle((WCSimWCDigi *)aDigi);
 }
@@ -4,14 +4,26 @@
 #include "WCSimWCDigi.hh"
 #include "WCSimWCHit.hh"
 #include "globals.hh"
-#include "Randomize.hh"
+#include "TRandom3.h"
 #include <map>
+#include <string>
 #include <vector>
 
 class WCSimDetectorConstruction;
 class WCSimCHIPSPMT;
 class WCSimSK1pePMT;
 class WCSimTOTPMT;
+class WCSimTrigger;
+class WCSimDarkNoise;
+
+// Everything the digitizer needs to know about a type of PMT, so the
+// per hit loop doesn't need to go back to the WCSimPMTConfig.
+struct WCSimDigitizerPMTType
+{
+	G4double timeConstant; // ns
+	G4int pmtSim;		   // charge model, as WCSimDetectorConstruction::GetPMTSim()
+	G4int totModel;		   // WCSimTOTPMT::TOTModel
+};
 
 class WCSimWCDigitizer : public G4VDigitizerModule
 {
@@ -34,12 +46,32 @@ public:
 		return TriggerTimes.size();
 	}
 
+	// Every random number drawn by Digitize() comes from streams seeded with
+	// this, see WCSimDigiRandom. Set it before each event.
+	void SetEventSeed(UInt_t seed)
+	{
+		fEventSeed = seed;
+	}
+	UInt_t GetEventSeed() const
+	{
+		return fEventSeed;
+	}
+
 public:
-	void MakeHitsHistogram(WCSimWCHitsCollection *);
-	void FindNumberOfGatesFast();
 	void FindTriggerWindows(WCSimWCHitsCollection *hits); // Leigh, new simple function to find trigger windows.
+	void UpdateTrigger();
+	void AddDarkNoise(WCSimWCHitsCollection *hits);
 	void DigitizeGate(WCSimWCHitsCollection *WCHC, G4int G);
+	void BuildPMTTypeTable();
+	void SeedStreams();
 	void Digitize();
+	// Digitize a hits collection that didn't come from the current Geant4 event,
+	// the digits are left for the caller in GetDigitsCollection()
+	void DigitizeHits(WCSimWCHitsCollection *WCHC);
+	WCSimWCDigitsCollection *GetDigitsCollection()
+	{
+		return DigitsCollection;
+	}
 	G4double GetTriggerTime(int i)
 	{
 		return TriggerTimes[i];
@@ -49,10 +81,6 @@ public:
 	{
 		return LongTime;
 	}
-	static G4double GetPMTDarkRate()
-	{
-		return PMTDarkRate;
-	}
 	static G4double GetEventGateDown()
 	{
 		return eventgatedown;
@@ -68,21 +96,34 @@ private:
 	static const double eventgateup;   // ns
 	static const double eventgatedown; // ns
 	static const double LongTime;	   // ns
-	static const int GlobalThreshold;  //number of hit PMTs within an <=200ns sliding window that decides the global trigger t0
-	static const double PMTDarkRate;   // kHz
 
-	G4float RealOffset; // t0 = offset corrected for trigger start
 	G4float MinTime;	// very first hit time
 	G4float PMTSize;
 
 	std::vector<G4double> TriggerTimes;
-	std::map<G4int, G4int> GateMap;
+	std::vector<double> fTriggerHitTimes; // Sorted hit times passed to the trigger
 	std::map<int, int> DigiHitMap; // need to check if a hit already exists..
 
+	// Indexed by WCSimWCHit::GetTubeType()
+	std::vector<WCSimDigitizerPMTType> fPMTTypes;
+
+	// The hits in the gate being digitized, reused between gates
+	std::vector<G4int> fGateHits;
+	std::vector<double> fGateTrueTimes;
+	std::vector<int> fGatePe;
+	std::vector<double> fGateLastTimes;
+	std::vector<double> fGateCharges;
+
 	WCSimWCDigitsCollection *DigitsCollection;
 
+	UInt_t fEventSeed;
+	TRandom3 fTimingRand; // Time resolution smearing
+
 	WCSimDetectorConstruction *fDet;
 	WCSimCHIPSPMT *fPMTSim;
 	WCSimSK1pePMT *fSK1peSim;
 	WCSimTOTPMT *fTOTSim;
+	WCSimTrigger *fTrigger; // Remade by UpdateTrigger() when the settings change
+	std::string fTriggerType; // The type asked for, fTrigger is gap if it doesn't exist
+	WCSimDarkNoise *fDarkNoise;
 };
@@ -8,34 +8,10 @@
 #include "G4ios.hh"
 // for accumulate
 #include <numeric>
-// for sort, find, count_if
+// for sort, lower_bound, upper_bound
 #include <string>
+#include <vector>
 #include <algorithm>
-//for less_equal, bind2nd,...
-#include <functional>
-
-// compose2 is not part of the C++ standard
-// use this kludgy technique to use it
-#include <ext/functional>
-using __gnu_cxx::binary_compose;
-using __gnu_cxx::compose1;
-using __gnu_cxx::compose2;
-using __gnu_cxx::constant0;
-using __gnu_cxx::constant1;
-using __gnu_cxx::constant2;
-using __gnu_cxx::constant_binary_fun;
-using __gnu_cxx::constant_unary_fun;
-using __gnu_cxx::constant_void_fun;
-using __gnu_cxx::identity;
-using __gnu_cxx::identity_element;
-using __gnu_cxx::mem_fun1;
-using __gnu_cxx::mem_fun1_ref;
-using __gnu_cxx::project1st;
-using __gnu_cxx::project2nd;
-using __gnu_cxx::select1st;
-using __gnu_cxx::select2nd;
-using __gnu_cxx::subtractive_rng;
-using __gnu_cxx::unary_compose;
 
 class WCSimWCHit : public G4VHit
 {
@@ -63,6 +39,12 @@ public:
 		fTubeName = name;
 	}
 
+	// Index of the PMT type into WCSimDetectorConstruction::GetPMTConfigs()
+	void SetTubeType(G4int type)
+	{
+		tubeType = type;
+	}
+
 	void SetTrackID(G4int track)
 	{
 		trackID = track;
@@ -87,6 +69,8 @@ public:
 	{
 		pLogV = logV;
 	}
+	// Parent IDs are kept in the same order as the times they belong to,
+	// so should be added straight after the corresponding AddPe() call.
 	void AddParentID(G4int primParentID)
 	{
 		primaryParentID.push_back(primParentID);
@@ -106,6 +90,11 @@ public:
 		if (totalPe > maxPe)
 			maxPe = totalPe;
 
+		// Photons mostly arrive in time order, so only mark the times as
+		// needing a sort when one turns up earlier than the last.
+		if (!time.empty() && hitTime < time.back())
+			timesSorted = false;
+
 		time.push_back(hitTime);
 	}
 
@@ -119,6 +108,11 @@ public:
 		return tubeID;
 	}
 
+	G4int GetTubeType()
+	{
+		return tubeType;
+	}
+
 	G4int GetTrackID()
 	{
 		return trackID;
@@ -144,60 +138,41 @@ public:
 		return primaryParentID[i];
 	}
 
-	void SortHitTimes()
-	{
-		sort(time.begin(), time.end());
-	}
+	// Sort the times, taking the parent IDs with them. This only does any
+	// work the first time it is called after an out of order AddPe().
+	void SortHitTimes();
+
+	// All of the gate queries below sort the times first if needed and then
+	// use binary searches, so are O(log n) in the number of photons.
 
 	// low is the trigger time, up is trigger+950ns (end of event)
 	G4float GetFirstHitTimeInGate(G4float low, G4float upevent)
 	{
-		G4float firsttime;
-		std::vector<G4float>::iterator tfirst = time.begin();
-		std::vector<G4float>::iterator tlast = time.end();
-
-		std::vector<G4float>::iterator found = std::find_if(tfirst, tlast,
-															compose2(std::logical_and<bool>(), std::bind2nd(std::greater_equal<G4float>(), low),
-																	 std::bind2nd(std::less_equal<G4float>(), upevent)));
-		if (found != tlast)
+		SortHitTimes();
+		std::vector<G4float>::const_iterator found = std::lower_bound(time.begin(), time.end(), low);
+		if (found != time.end() && *found <= upevent)
 		{
-			firsttime = *found; // first hit time
+			return *found; // first hit time
 		}
-		else
-		{
-			firsttime = -10000.; //error code.
-		}
-		//G4cout << "firsthit time " << firsttime << "\n";
-		return firsttime;
+		return -10000.; //error code.
 	}
 
 	// low is the trigger time, up is trigger+950ns (end of event)
 	G4float GetLastHitTimeInGate(G4float low, G4float upevent)
 	{
-		G4float lasttime;
-		std::vector<G4float>::reverse_iterator tfirst = time.rbegin();
-		std::vector<G4float>::reverse_iterator tlast = time.rend();
-
-		std::vector<G4float>::reverse_iterator found = std::find_if(tlast, tfirst,
-																	compose2(std::logical_and<bool>(), std::bind2nd(std::greater_equal<G4float>(), low),
-																			 std::bind2nd(std::less_equal<G4float>(), upevent)));
-		if (found != tlast)
+		SortHitTimes();
+		std::vector<G4float>::const_iterator found = std::upper_bound(time.begin(), time.end(), upevent);
+		if (found != time.begin() && *(found - 1) >= low)
 		{
-			lasttime = *found; // last hit time
+			return *(found - 1); // last hit time
 		}
-		else
-		{
-			lasttime = -10000.; //error code.
-		}
-		return lasttime;
+		return -10000.; //error code.
 	}
 
 	// low is the trigger time, up is trigger+950ns (end of event)
 	G4float GetMeanHitTimeInGate()
 	{
 		G4float meantime;
-		std::vector<G4float>::reverse_iterator tfirst = time.rbegin();
-		std::vector<G4float>::reverse_iterator tlast = time.rend();
 
 		if (time.size() > 0)
 		{
@@ -214,27 +189,23 @@ public:
 
 	G4int GetPeInGate(double low, double pmtgate, double evgate)
 	{
-		// M Fechner; april 2005
-		// assumes that time has already been sorted
-		std::vector<G4float>::iterator tfirst = time.begin();
-		std::vector<G4float>::iterator tlast = time.end();
+		SortHitTimes();
 		// select min time
 		G4float mintime = (pmtgate < evgate) ? pmtgate : evgate;
 
 		// return number of hits in the time window...
-
-		G4int number = std::count_if(tfirst, tlast,
-									 compose2(std::logical_and<bool>(), std::bind2nd(std::greater_equal<G4float>(), low),
-											  std::bind2nd(std::less_equal<G4float>(), mintime)));
+		std::vector<G4float>::const_iterator first = std::lower_bound(time.begin(), time.end(), (G4float)low);
+		std::vector<G4float>::const_iterator last = std::upper_bound(time.begin(), time.end(), mintime);
+		G4int number = (last > first) ? (last - first) : 0;
 
 		totalPeInGate = number;
-		//    G4cout << "numer = " <<  number <<"\n";
 		return number;
 	}
 
 private:
 	std::string fTubeName;
 	G4int tubeID;
+	G4int tubeType;
 	G4int trackID;
 	G4double edep;
 	G4ThreeVector pos;
@@ -244,26 +215,32 @@ private:
 	// This is temporarily used for the drawing scale
 	// Since its static *every* WChit sees the same value for this.
 
-	static G4int maxPe;
+	static G4ThreadLocal G4int maxPe;
 
 	G4int totalPe;
 	std::vector<G4float> time;
 	std::vector<G4int> primaryParentID;
+	G4bool timesSorted;
 	G4int totalPeInGate;
 };
 
 typedef G4THitsCollection<WCSimWCHit> WCSimWCHitsCollection;
 
-extern G4Allocator<WCSimWCHit> WCSimWCHitAllocator;
+// One allocator per thread, created on first use
+extern G4ThreadLocal G4Allocator<WCSimWCHit> *WCSimWCHitAllocator;
 
 inline void *WCSimWCHit::operator new(size_t)
 {
 	void *aHit;
-	aHit = (void *)WCSimWCHitAllocator.MallocSingle();
+	if (!WCSimWCHitAllocator)
+	{
+		WCSimWCHitAllocator = new G4Allocator<WCSimWCHit>;
+	}
+	aHit = (void *)WCSimWCHitAllocator->MallocSingle();
 	return aHit;
 }
 
 inline void WCSimWCHit::operator delete(void *aHit)
 {
-	WCSimWCHitAllocator.FreeSingle((WCSimWCHit *)aHit);
+	WCSimWCHitAllocator->FreeSingle((WCSimWCHit *)aHit);
 }
\ No newline at end of file
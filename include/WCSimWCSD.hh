@@ -6,6 +6,7 @@
 
 class G4Step;
 class G4HCofThisEvent;
+class G4VTouchable;
 
 class WCSimWCSD : public G4VSensitiveDetector
 {
@@ -20,8 +21,20 @@ public:
 	void EndOfEvent(G4HCofThisEvent *);
 
 private:
+	// Look the tube up with both the integer key and the tube tag string
+	G4int ValidateTubeLookup(const G4VTouchable *touchable);
+
 	G4int HCID;
 	WCSimDetectorConstruction *fdet;
 	WCSimWCHitsCollection *hitsCollection;
 	std::map<int, int> PMTHitMap; // Whether a PMT was hit already
+
+	// Tube lookup validation counters, only filled when validating
+	G4int fNumLookups;
+	G4int fNumLookupMismatches;
+	G4double fKeyLookupTime; // s
+	G4double fTagLookupTime; // s
+
+	// Is the photon ntuple being saved this event?
+	G4bool fRecordPhotons;
 };
@@ -0,0 +1,404 @@
+// Digitize the saved Cherenkov hits of a chipssim output file again without
+// any Geant4 tracking, so that the PMT simulation, timing resolution, dark
+// noise or trigger can be changed without simulating the photons again. The
+// detector is built from the same geometry macro as chipssim so that the
+// digitizer sees the same PMTs, then a second macro can change the digitizer
+// settings (/WCSim/PMTSim, /WCSim/PMTDarkRate, /WCSim/TriggerType...). The input
+// must have been made with /WCSimIO/SaveRawHits true.
+//
+// Each event is digitized with the seed saved in its header, so with the same
+// settings the digits are exactly those of the original file. Events are split
+// into contiguous blocks between worker processes and the files they write are
+// merged into the output in event order.
+//
+// Usage: chipsdigi [-g geo.mac] [-m settings.mac] [-j workers] [-s seed] <input.root> <output.root>
+
+#include "G4RunManager.hh"
+#include "G4UImanager.hh"
+#include "WCSimCherenkovBuilder.hh"
+#include "WCSimPhysicsListFactory.hh"
+#include "WCSimTuningParameters.hh"
+#include "WCSimWCDigitizer.hh"
+#include "WCSimWCHit.hh"
+#include "WCSimWCDigi.hh"
+#include "WCSimPmtInfo.hh"
+#include "WCSimPMTConfig.hh"
+#include "WCSimDigiRandom.hh"
+#include "WCSimRootEvent.hh"
+
+#include <TFile.h>
+#include <TTree.h>
+#include <TClonesArray.h>
+#include <TFileMerger.h>
+#include <TSystem.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include <sys/wait.h>
+
+void usage();
+long Redigitize(WCSimDetectorConstruction *det, const std::string &inName, const std::string &outName, long first,
+				long last, long baseSeed, bool writeGeometry);
+
+int main(int argc, char **argv)
+{
+	// Setup the paths to the default files, as chipssim
+	G4String geoMacFile = getenv("CHIPSSIM");
+	geoMacFile.append("/config/example/example_geo_setup.mac");
+
+	G4String tuningFile = getenv("CHIPSSIM");
+	tuningFile.append("/config/tuning_parameters.mac");
+
+	G4String jobOptionsFile = getenv("CHIPSSIM");
+	jobOptionsFile.append("/config/job_options.mac");
+
+	G4String settingsFile = "";
+	int nWorkers = 1;
+	long baseSeed = 0;
+	std::vector<std::string> files;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		bool hasValue = (i + 1 < argc);
+		if (std::strcmp(argv[i], "-g") == 0 && hasValue)
+		{
+			geoMacFile = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "-m") == 0 && hasValue)
+		{
+			settingsFile = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "-j") == 0 && hasValue)
+		{
+			nWorkers = std::atoi(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "-s") == 0 && hasValue)
+		{
+			baseSeed = std::atol(argv[++i]);
+		}
+		else if (argv[i][0] == '-')
+		{
+			std::cerr << "Unrecognised flag " << argv[i] << std::endl;
+			usage();
+			return 1;
+		}
+		else
+		{
+			files.push_back(argv[i]);
+		}
+	}
+	if (files.size() != 2)
+	{
+		usage();
+		return 1;
+	}
+	const std::string &inName = files[0];
+	const std::string &outName = files[1];
+
+	// Count the events before setting up Geant4, in case the file is no good
+	long nEvents = 0;
+	{
+		TFile file(inName.c_str(), "READ");
+		TTree *tree = (TTree *)file.Get("wcsimT");
+		if (!tree)
+		{
+			std::cerr << inName << " is not a chipssim output file" << std::endl;
+			return 1;
+		}
+		nEvents = tree->GetEntries();
+	}
+	if (nEvents == 0)
+	{
+		std::cerr << "No events in " << inName << std::endl;
+		return 1;
+	}
+	if (nWorkers < 1)
+	{
+		nWorkers = 1;
+	}
+	if (nWorkers > nEvents)
+	{
+		nWorkers = nEvents;
+	}
+
+	// Build the detector so the digitizer knows the PMTs. The physics list is
+	// only needed to initialise the run manager, nothing is ever tracked.
+	G4RunManager *runManager = new G4RunManager;
+	G4UImanager *UI = G4UImanager::GetUIpointer();
+	G4String execute = "/control/execute ";
+
+	WCSimTuningParameters::Instance();
+	UI->ApplyCommand(execute + tuningFile);
+
+	WCSimCherenkovBuilder *detector = new WCSimCherenkovBuilder(2);
+	runManager->SetUserInitialization(detector);
+	UI->ApplyCommand(execute + geoMacFile);
+
+	WCSimPhysicsListFactory *physics = new WCSimPhysicsListFactory();
+	UI->ApplyCommand(execute + jobOptionsFile);
+	physics->InitializeList();
+	runManager->SetUserInitialization(physics);
+
+	runManager->Initialize();
+
+	if (settingsFile != "")
+	{
+		UI->ApplyCommand(execute + settingsFile);
+	}
+
+	std::cout << "== Digitizing " << nEvents << " events of " << inName << " into " << outName << " with " << nWorkers
+			  << " worker(s)" << std::endl;
+
+	std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+	long nDigitized = 0;
+	int failed = 0;
+	if (nWorkers == 1)
+	{
+		nDigitized = Redigitize(detector, inName, outName, 0, nEvents - 1, baseSeed, true);
+		failed = (nDigitized < 0) ? 1 : 0;
+	}
+	else
+	{
+		// Contiguous blocks of events so the merged file keeps the event order
+		std::vector<std::string> workerFiles;
+		std::vector<pid_t> workers;
+		long blockSize = (nEvents + nWorkers - 1) / nWorkers;
+		for (int w = 0; w < nWorkers; ++w)
+		{
+			std::stringstream name;
+			name << outName << ".worker" << w;
+			workerFiles.push_back(name.str());
+			long first = w * blockSize;
+			long last = std::min(nEvents, first + blockSize) - 1;
+
+			pid_t pid = fork();
+			if (pid == 0)
+			{
+				// Only the first worker copies the geometry so the merge doesn't repeat it
+				long n = Redigitize(detector, inName, workerFiles[w], first, last, baseSeed, w == 0);
+				std::cout.flush();
+				_exit((n < 0) ? 1 : 0);
+			}
+			else if (pid < 0)
+			{
+				std::cerr << "== Could not start worker " << w << std::endl;
+				++failed;
+			}
+			else
+			{
+				workers.push_back(pid);
+			}
+		}
+		for (unsigned int w = 0; w < workers.size(); ++w)
+		{
+			int status = 0;
+			waitpid(workers[w], &status, 0);
+			if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+			{
+				++failed;
+			}
+		}
+
+		if (failed == 0)
+		{
+			TFileMerger merger(kFALSE);
+			merger.SetFastMethod(kTRUE);
+			merger.OutputFile(outName.c_str(), "RECREATE");
+			for (unsigned int f = 0; f < workerFiles.size(); ++f)
+			{
+				merger.AddFile(workerFiles[f].c_str(), kFALSE);
+			}
+			if (!merger.Merge())
+			{
+				std::cerr << "== Failed to merge the worker files into " << outName << std::endl;
+				++failed;
+			}
+		}
+		// Keep the worker files if anything went wrong
+		if (failed == 0)
+		{
+			for (unsigned int f = 0; f < workerFiles.size(); ++f)
+			{
+				gSystem->Unlink(workerFiles[f].c_str());
+			}
+			nDigitized = nEvents;
+		}
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+	delete runManager;
+
+	if (failed > 0)
+	{
+		std::cerr << "== " << failed << " worker(s) failed, " << outName << " is incomplete" << std::endl;
+		return 1;
+	}
+	std::cout << "== Digitized " << nDigitized << " events in " << seconds << " s: " << nDigitized / seconds
+			  << " events/s" << std::endl;
+	return 0;
+}
+
+// Digitize the events in [first, last] of the input and write them to the
+// output. Returns the number of events written, or -1 if the files couldn't
+// be opened.
+long Redigitize(WCSimDetectorConstruction *det, const std::string &inName, const std::string &outName, long first,
+				long last, long baseSeed, bool writeGeometry)
+{
+	TFile inFile(inName.c_str(), "READ");
+	TTree *inTree = (TTree *)inFile.Get("wcsimT");
+	if (!inTree)
+	{
+		return -1;
+	}
+	WCSimRootEvent *event = 0;
+	inTree->SetBranchAddress("wcsimrootevent", &event);
+	// Force deletion to prevent memory leak
+	inTree->GetBranch("wcsimrootevent")->SetAutoDelete(kTRUE);
+
+	TFile outFile(outName.c_str(), "RECREATE", "WCSim ROOT file");
+	if (outFile.IsZombie())
+	{
+		return -1;
+	}
+	if (writeGeometry)
+	{
+		TTree *inGeoTree = (TTree *)inFile.Get("wcsimGeoT");
+		if (inGeoTree)
+		{
+			outFile.cd();
+			inGeoTree->CloneTree(-1, "fast");
+		}
+	}
+	outFile.cd();
+	TTree *outTree = new TTree("wcsimT", "WCSim Tree");
+	outTree->Branch("wcsimrootevent", "WCSimRootEvent", &event, 64000, 2);
+
+	WCSimWCDigitizer digitizer("WCReadout", det);
+	WCSimPMTConfig pmt = det->GetPMTVector()[0];
+	digitizer.SetPMTSize(pmt.GetRadius());
+	std::vector<WCSimPmtInfo *> *pmts = det->Get_Pmts();
+
+	long nWritten = 0;
+	long nNoHits = 0;
+	std::vector<Int_t> rawTubes, rawNumPe, rawParents;
+	std::vector<Float_t> rawTimes;
+	for (long e = first; e <= last; ++e)
+	{
+		inTree->GetEntry(e);
+		WCSimRootTrigger *rawTrigger = event->GetTrigger(0);
+		WCSimRootEventHeader *header = rawTrigger->GetHeader();
+		rawTrigger->GetRawHits(rawTubes, rawNumPe, rawTimes, rawParents);
+		if (rawTubes.empty())
+		{
+			++nNoHits;
+		}
+
+		// Rebuild the hits collection from the photon hits. The dark noise the
+		// original digitizer added is left out and made again with the new settings.
+		WCSimWCHitsCollection *hits = new WCSimWCHitsCollection("glassFaceWCPMT", "chipsdigi");
+		unsigned int photon = 0;
+		for (unsigned int h = 0; h < rawTubes.size(); ++h)
+		{
+			int tube = rawTubes[h];
+			WCSimWCHit *hit = 0;
+			for (int p = 0; p < rawNumPe[h]; ++p, ++photon)
+			{
+				if (rawParents[photon] == -1)
+				{
+					continue;
+				}
+				if (!hit)
+				{
+					hit = new WCSimWCHit();
+					hit->SetTubeName(pmts->at(tube - 1)->Get_name());
+					hit->SetTubeID(tube);
+					hit->SetTubeType(det->GetTubePMTType(tube));
+					hit->SetEdep(0.);
+					hits->insert(hit);
+				}
+				hit->AddPe(rawTimes[photon]);
+				hit->AddParentID(rawParents[photon]);
+			}
+		}
+
+		// The saved seed gives back the original digits, a new base seed makes new ones
+		UInt_t seed = header->GetDigiSeed();
+		if (baseSeed != 0 || seed == 0)
+		{
+			seed = WCSimDigiRandom::GetEventSeed(baseSeed, header->GetRun(), header->GetEvtNum());
+		}
+		digitizer.ReInitialize();
+		digitizer.SetEventSeed(seed);
+		digitizer.DigitizeHits(hits);
+		WCSimWCDigitsCollection *digits = digitizer.GetDigitsCollection();
+
+		// Replace the digits, keeping the tracks and raw hits, in the same way as
+		// WCSimEventAction::FillRootEvent()
+		event->ClearDigits();
+		header->SetDigiSeed(seed);
+		int ngates = digitizer.NumberOfGatesInThisEvent();
+		for (int g = 1; g < ngates; ++g)
+		{
+			event->AddSubEvent();
+			WCSimRootTrigger *trigger = event->GetTrigger(g);
+			trigger->SetHeader(header->GetEvtNum(), 0, 0, g + 1);
+			trigger->SetMode(rawTrigger->GetMode());
+		}
+		for (int g = 0; g < ngates; ++g)
+		{
+			WCSimRootTrigger *trigger = event->GetTrigger(g);
+			float sumQ = 0.;
+			int nDigits = 0;
+			for (int d = 0; d < digits->entries(); ++d)
+			{
+				if ((*digits)[d]->HasHitsInGate(g))
+				{
+					trigger->AddCherenkovDigiHit((*digits)[d]->GetPe(g), (*digits)[d]->GetTime(g), (*digits)[d]->GetTubeID());
+					sumQ += (*digits)[d]->GetPe(g);
+					++nDigits;
+				}
+			}
+			trigger->SetNumDigitizedTubes(nDigits);
+			trigger->SetSumQ(sumQ);
+			trigger->GetHeader()->SetDate(int(digitizer.GetTriggerTime(g)));
+		}
+
+		outTree->Fill();
+		++nWritten;
+		delete digits;
+		delete hits;
+	}
+
+	outFile.cd();
+	outFile.Write("", TObject::kOverwrite);
+	outFile.Close();
+	inTree->ResetBranchAddresses();
+	delete event;
+
+	if (nNoHits > 0)
+	{
+		std::cout << "== " << nNoHits << " events had no raw hits, was chipssim run with /WCSimIO/SaveRawHits true?"
+				  << std::endl;
+	}
+	return nWritten;
+}
+
+void usage()
+{
+	std::cout << "Usage: chipsdigi [-g geo.mac] [-m settings.mac] [-j workers] [-s seed] <input.root> <output.root>"
+			  << std::endl;
+	std::cout << "Digitizes the raw hits saved by chipssim (/WCSimIO/SaveRawHits true) again" << std::endl;
+	std::cout << "   -g  Geometry macro used to make the input (default $CHIPSSIM/config/example/example_geo_setup.mac)"
+			  << std::endl;
+	std::cout << "   -m  Macro with the new digitizer settings, e.g. /WCSim/PMTSim or /WCSim/PMTDarkRate" << std::endl;
+	std::cout << "   -j  Number of worker processes (default 1)" << std::endl;
+	std::cout << "   -s  New base seed, by default each event uses the seed saved with it" << std::endl;
+}
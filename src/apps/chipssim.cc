@@ -1,5 +1,8 @@
 #include "G4ios.hh"
 #include "G4RunManager.hh"
+#ifdef G4MULTITHREADED
+#include "G4MTRunManager.hh"
+#endif
 #include "G4UImanager.hh"
 #include "G4UIterminal.hh"
 #include "G4UItcsh.hh"
@@ -8,17 +11,14 @@
 #include "WCSimPhysicsListFactoryMessenger.hh"
 #include "WCSimTuningParameters.hh"
 #include "WCSimTuningMessenger.hh"
-#include "WCSimPrimaryGeneratorAction.hh"
-#include "WCSimEventAction.hh"
-#include "WCSimRunAction.hh"
-#include "WCSimStackingAction.hh"
-#include "WCSimTrackingAction.hh"
-#include "WCSimSteppingAction.hh"
+#include "WCSimActionInitialization.hh"
 #include "WCSimVisManager.hh"
 #include "WCSimRandomParameters.hh"
+#include "TROOT.h"
 #include <iostream>
 #include <cstring>
 #include <string>
+#include <cstdlib>
 
 void usage();
 
@@ -37,6 +37,9 @@ int main(int argc, char **argv)
 	G4String jobOptionsFile = getenv("CHIPSSIM");
 	jobOptionsFile.append("/config/job_options.mac");
 
+	// Number of worker threads, 0 means run sequentially
+	int nThreads = 0;
+
 	if (argc > 1)
 	{
 		for (int i = 1; i < argc; ++i)
@@ -59,6 +62,22 @@ int main(int argc, char **argv)
 					return 0;
 				}
 			}
+			// Number of threads switch
+			else if (std::strcmp(argv[i], "-t") == 0)
+			{
+				if (argc > i + 1)
+				{
+					nThreads = std::atoi(argv[i + 1]);
+					std::cout << "== Number of threads = " << nThreads << std::endl;
+					++i;
+				}
+				else
+				{
+					std::cerr << "== Flag -t expects an argument == " << std::endl;
+					usage();
+					return 0;
+				}
+			}
 			else if (!G4String(argv[i]).compare(0, dash.size(), dash))
 			{
 				std::cerr << "Unrecognised flag " << argv[i] << std::endl;
@@ -79,7 +98,26 @@ int main(int argc, char **argv)
 	G4String execute = "/control/execute ";
 
 	// Construct the run manager
-	G4RunManager *runManager = new G4RunManager;
+	G4RunManager *runManager = 0;
+#ifdef G4MULTITHREADED
+	if (nThreads > 0)
+	{
+		// Each thread writes its own ROOT files
+		ROOT::EnableThreadSafety();
+		G4MTRunManager *mtRunManager = new G4MTRunManager;
+		mtRunManager->SetNumberOfThreads(nThreads);
+		runManager = mtRunManager;
+	}
+#else
+	if (nThreads > 0)
+	{
+		std::cerr << "== Geant4 was built without multithreading, running sequentially ==" << std::endl;
+	}
+#endif
+	if (!runManager)
+	{
+		runManager = new G4RunManager;
+	}
 
 	// get the pointer to the UI manager
 	G4UImanager *UI = G4UImanager::GetUIpointer();
@@ -103,17 +141,8 @@ int main(int argc, char **argv)
 	G4VisManager *visManager = new WCSimVisManager;
 	visManager->Initialize();
 
-	// Set the WCSim user action classes
-	WCSimPrimaryGeneratorAction *myGeneratorAction = new WCSimPrimaryGeneratorAction(WCSimdetector);
-	runManager->SetUserAction(myGeneratorAction);
-
-	WCSimRunAction *myRunAction = new WCSimRunAction(WCSimdetector);
-	runManager->SetUserAction(myRunAction);
-
-	runManager->SetUserAction(new WCSimEventAction(myRunAction, WCSimdetector, myGeneratorAction));
-	runManager->SetUserAction(new WCSimTrackingAction);
-	runManager->SetUserAction(new WCSimStackingAction(WCSimdetector));
-	runManager->SetUserAction(new WCSimSteppingAction);
+	// Set the WCSim user action classes, built once per thread in multithreaded mode
+	runManager->SetUserInitialization(new WCSimActionInitialization(WCSimdetector));
 
 	runManager->Initialize(); // Initialize G4 kernel, this actually sets everything up
 
@@ -139,11 +168,16 @@ int main(int argc, char **argv)
 void usage()
 {
 	std::cout << "--- WCSim usage instructions ---" << std::endl;
-	std::cout << "WCSim [-g arg] path_to_some_file.mac (where the mac file contains the GEANT4 run configuration)"
+	std::cout << "WCSim [-g arg] [-t arg] path_to_some_file.mac (where the mac file contains the GEANT4 run configuration)"
 			  << std::endl;
 	std::cout << " -- Optional flags -- " << std::endl;
 	std::cout << "   -g path_to_geo_file.mac" << std::endl
 			  << "       Use a different mac file to specify geometry options" << std::endl
 			  << "       such as which geometry or PMT simulation to use (default " << std::endl
 			  << "       is $CHIPSSIM/config/example/example_geo_setup.mac" << std::endl;
+	std::cout << "   -t number_of_threads" << std::endl
+			  << "       Process events on this many worker threads. Each thread" << std::endl
+			  << "       writes its own output file, which are merged into the" << std::endl
+			  << "       requested file at the end of the run (default is to run" << std::endl
+			  << "       sequentially)" << std::endl;
 }
@@ -0,0 +1,166 @@
+// Compare saving the raw Cherenkov hits as one WCSimRootCherenkovHitTime per
+// photon with the packed form of WCSimRootTrigger::AddPackedCherenkovHit().
+// Both are filled with the same made up events, written to a file and read
+// back, printing the time taken, the file size and whether the hits read back
+// are exactly the ones written.
+//
+// Usage: rawhitbenchmark [events] [tubes per event] [pe per tube]
+
+#include "WCSimRootEvent.hh"
+
+#include <TFile.h>
+#include <TTree.h>
+#include <TRandom3.h>
+#include <TStopwatch.h>
+#include <TSystem.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+// The hits of one tube, sorted in time as the digitizer leaves them. Most
+// photons on a tube come from one or two tracks and a few are dark noise.
+void MakeTube(TRandom3 &rand, int nPe, std::vector<Float_t> &times, std::vector<Int_t> &parents)
+{
+	times.clear();
+	parents.clear();
+	Int_t mainParent = 1 + rand.Integer(20);
+	for (int p = 0; p < nPe; ++p)
+	{
+		double u = rand.Rndm();
+		if (u < 0.05)
+		{
+			times.push_back(rand.Uniform(0., 2000.));
+			parents.push_back(-1);
+		}
+		else
+		{
+			times.push_back(950. + rand.Exp(15.));
+			parents.push_back(u < 0.85 ? mainParent : 1 + rand.Integer(20));
+		}
+	}
+	std::vector<size_t> order(nPe);
+	for (int p = 0; p < nPe; ++p)
+	{
+		order[p] = p;
+	}
+	std::stable_sort(order.begin(), order.end(), [&times](size_t a, size_t b) { return times[a] < times[b]; });
+	std::vector<Float_t> sortedTimes(nPe);
+	std::vector<Int_t> sortedParents(nPe);
+	for (int p = 0; p < nPe; ++p)
+	{
+		sortedTimes[p] = times[order[p]];
+		sortedParents[p] = parents[order[p]];
+	}
+	times.swap(sortedTimes);
+	parents.swap(sortedParents);
+}
+
+void RunTest(bool packed, const char *fileName, int nEvents, int nTubes, int nPe)
+{
+	std::vector<Float_t> times;
+	std::vector<Int_t> parents;
+
+	// Fill and write
+	TStopwatch fillTimer;
+	fillTimer.Start();
+	{
+		TFile file(fileName, "RECREATE");
+		WCSimRootEvent *event = new WCSimRootEvent();
+		event->Initialize();
+		TTree *tree = new TTree("wcsimT", "WCSim Tree");
+		tree->Branch("wcsimrootevent", "WCSimRootEvent", &event, 64000, 2);
+
+		TRandom3 rand(1);
+		for (int e = 0; e < nEvents; ++e)
+		{
+			WCSimRootTrigger *trigger = event->GetTrigger(0);
+			trigger->SetHeader(e, 0, 0);
+			trigger->SetNumTubesHit(nTubes);
+			for (int t = 0; t < nTubes; ++t)
+			{
+				MakeTube(rand, nPe, times, parents);
+				if (packed)
+				{
+					trigger->AddPackedCherenkovHit(t + 1, times, parents);
+				}
+				else
+				{
+					trigger->AddCherenkovHit(t + 1, times, parents);
+				}
+			}
+			tree->Fill();
+			event->ReInitialize();
+		}
+		file.Write();
+		file.Close();
+		delete event;
+	}
+	fillTimer.Stop();
+
+	FileStat_t stat;
+	gSystem->GetPathInfo(fileName, stat);
+
+	// Read back, decode and check against the same made up hits
+	TStopwatch readTimer;
+	readTimer.Start();
+	long nWrong = 0;
+	{
+		TFile file(fileName, "READ");
+		TTree *tree = (TTree *)file.Get("wcsimT");
+		WCSimRootEvent *event = new WCSimRootEvent();
+		tree->SetBranchAddress("wcsimrootevent", &event);
+		// Force deletion to prevent memory leak
+		tree->GetBranch("wcsimrootevent")->SetAutoDelete(kTRUE);
+
+		TRandom3 rand(1);
+		std::vector<Int_t> rawTubes, rawNumPe, rawParents;
+		std::vector<Float_t> rawTimes;
+		for (int e = 0; e < nEvents; ++e)
+		{
+			tree->GetEntry(e);
+			event->GetTrigger(0)->GetRawHits(rawTubes, rawNumPe, rawTimes, rawParents);
+			if ((int)rawTubes.size() != nTubes || (int)rawTimes.size() != nTubes * nPe)
+			{
+				++nWrong;
+				continue;
+			}
+			for (int t = 0; t < nTubes; ++t)
+			{
+				MakeTube(rand, nPe, times, parents);
+				if (rawTubes[t] != t + 1 || rawNumPe[t] != nPe)
+				{
+					++nWrong;
+				}
+				for (int p = 0; p < nPe; ++p)
+				{
+					if (rawTimes[t * nPe + p] != times[p] || rawParents[t * nPe + p] != parents[p])
+					{
+						++nWrong;
+					}
+				}
+			}
+		}
+		delete event;
+	}
+	readTimer.Stop();
+	gSystem->Unlink(fileName);
+
+	std::cout << (packed ? "Packed:        " : "TClonesArray:  ") << stat.fSize / 1048576. << " MB, "
+			  << 1000. * fillTimer.RealTime() / nEvents << " ms/event to fill and write, "
+			  << 1000. * readTimer.RealTime() / nEvents << " ms/event to read and decode, " << nWrong
+			  << " wrong hits" << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+	int nEvents = (argc > 1) ? atoi(argv[1]) : 1000;
+	int nTubes = (argc > 2) ? atoi(argv[2]) : 2000;
+	int nPe = (argc > 3) ? atoi(argv[3]) : 5;
+	std::cout << nEvents << " events with " << nTubes << " tubes of " << nPe << " pe" << std::endl;
+
+	RunTest(false, "rawhitbenchmark_clones.root", nEvents, nTubes, nPe);
+	RunTest(true, "rawhitbenchmark_packed.root", nEvents, nTubes, nPe);
+	return 0;
+}
@@ -0,0 +1,98 @@
+// Time reading the digits of a chipssim output file through the WCSimRootEvent
+// tree and through the flat tree written with /WCSimIO/SaveFlatNtuple true.
+// Both passes add up the digits, charge and time so the results can be checked
+// against each other.
+//
+// Usage: readbenchmark <file.root>
+
+#include "WCSimRootEvent.hh"
+
+#include <TFile.h>
+#include <TTree.h>
+#include <TClonesArray.h>
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+int main(int argc, char **argv)
+{
+	if (argc < 2)
+	{
+		std::cout << "Usage: " << argv[0] << " <file.root>" << std::endl;
+		return 1;
+	}
+
+	TFile file(argv[1], "READ");
+	TTree *tree = (TTree *)file.Get("wcsimT");
+	TTree *flatTree = (TTree *)file.Get("flatT");
+	if (!tree || !flatTree)
+	{
+		std::cout << "Could not find wcsimT and flatT in " << argv[1] << ", was /WCSimIO/SaveFlatNtuple set?"
+				  << std::endl;
+		return 1;
+	}
+
+	// The WCSimRootEvent objects
+	WCSimRootEvent *event = 0;
+	tree->SetBranchAddress("wcsimrootevent", &event);
+	long nDigits = 0;
+	double sumQ = 0., sumT = 0.;
+	std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+	long nEvents = tree->GetEntries();
+	for (long e = 0; e < nEvents; ++e)
+	{
+		tree->GetEntry(e);
+		for (int t = 0; t < event->GetNumberOfEvents(); ++t)
+		{
+			WCSimRootTrigger *trigger = event->GetTrigger(t);
+			TClonesArray *digits = trigger->GetCherenkovDigiHits();
+			for (int d = 0; d < trigger->GetNcherenkovdigihits(); ++d)
+			{
+				WCSimRootCherenkovDigiHit *digit = (WCSimRootCherenkovDigiHit *)digits->At(d);
+				sumQ += digit->GetQ();
+				sumT += digit->GetT();
+				++nDigits;
+			}
+		}
+	}
+	double eventTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+	// The flat vectors, only reading the digit branches
+	std::vector<int> *tubes = 0;
+	std::vector<float> *charges = 0;
+	std::vector<float> *times = 0;
+	flatTree->SetBranchStatus("*", 0);
+	flatTree->SetBranchStatus("digiTube", 1);
+	flatTree->SetBranchStatus("digiQ", 1);
+	flatTree->SetBranchStatus("digiT", 1);
+	flatTree->SetBranchAddress("digiTube", &tubes);
+	flatTree->SetBranchAddress("digiQ", &charges);
+	flatTree->SetBranchAddress("digiT", &times);
+	long nFlatDigits = 0;
+	double sumFlatQ = 0., sumFlatT = 0.;
+	begin = std::chrono::steady_clock::now();
+	long nFlatEvents = flatTree->GetEntries();
+	for (long e = 0; e < nFlatEvents; ++e)
+	{
+		flatTree->GetEntry(e);
+		for (unsigned int d = 0; d < tubes->size(); ++d)
+		{
+			sumFlatQ += (*charges)[d];
+			sumFlatT += (*times)[d];
+			++nFlatDigits;
+		}
+	}
+	double flatTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+	std::cout << "WCSimRootEvent: " << nEvents << " events, " << nDigits << " digits in " << eventTime << " s ("
+			  << nEvents / eventTime << " events/s), sum q " << sumQ << ", sum t " << sumT << std::endl;
+	std::cout << "Flat ntuple:    " << nFlatEvents << " events, " << nFlatDigits << " digits in " << flatTime << " s ("
+			  << nFlatEvents / flatTime << " events/s), sum q " << sumFlatQ << ", sum t " << sumFlatT << std::endl;
+	if (nDigits != nFlatDigits)
+	{
+		std::cout << "The number of digits does not match!" << std::endl;
+		return 1;
+	}
+	return 0;
+}
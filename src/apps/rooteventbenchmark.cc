@@ -0,0 +1,58 @@
+// Time filling and clearing WCSimRootEvents with several triggers, as in
+// beam spill overlay events, with and without the sub-event triggers being
+// kept for reuse between events.
+//
+// Usage: rooteventbenchmark [events] [triggers per event] [digits per trigger]
+
+#include "WCSimRootEvent.hh"
+
+#include <TStopwatch.h>
+
+#include <cstdlib>
+#include <iostream>
+
+double FillEvents(bool reuse, int nEvents, int nTriggers, int nDigits)
+{
+	WCSimRootEvent event;
+	event.Initialize();
+	event.SetReuseTriggers(reuse);
+
+	TStopwatch timer;
+	timer.Start();
+	for (int e = 0; e < nEvents; ++e)
+	{
+		event.GetTrigger(0)->SetHeader(e, 0, 0);
+		for (int t = 0; t < nTriggers; ++t)
+		{
+			if (t >= 1)
+			{
+				event.AddSubEvent();
+			}
+			WCSimRootTrigger *trigger = event.GetTrigger(t);
+			for (int d = 0; d < nDigits; ++d)
+			{
+				trigger->AddCherenkovDigiHit(1.0, 10.0 * d, d);
+			}
+		}
+		event.ReInitialize();
+	}
+	timer.Stop();
+
+	std::cout << (reuse ? "Reused triggers:    " : "Allocated triggers: ") << nEvents / timer.RealTime()
+			  << " events/s, " << 1000. * timer.RealTime() / nEvents << " ms/event, final capacity hint "
+			  << event.GetCapacityHint() << std::endl;
+	return timer.RealTime();
+}
+
+int main(int argc, char **argv)
+{
+	int nEvents = (argc > 1) ? atoi(argv[1]) : 10000;
+	int nTriggers = (argc > 2) ? atoi(argv[2]) : 8;
+	int nDigits = (argc > 3) ? atoi(argv[3]) : 500;
+	std::cout << nEvents << " events with " << nTriggers << " triggers of " << nDigits << " digits" << std::endl;
+
+	double allocTime = FillEvents(false, nEvents, nTriggers, nDigits);
+	double reuseTime = FillEvents(true, nEvents, nTriggers, nDigits);
+	std::cout << "Speed up from reusing the triggers: " << allocTime / reuseTime << std::endl;
+	return 0;
+}
@@ -1,11 +1,21 @@
 #include <iostream>
 #include <string>
 #include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <vector>
+#include <unistd.h>
+#include <sys/wait.h>
 #include "TEnv.h"
+#include "TROOT.h"
+#include "TFile.h"
+#include "TTree.h"
 #include "TApplication.h"
 #include "WCSimEvDisplay.hh"
-#include <cstring>
+#include "WCSimEvDisplayBatch.hh"
 void PrintHelp();
+int RunBatch(std::string filename, int first, int last, int nWorkers, std::string prefix, std::string format);
 
 int main(int argc, char *argv[])
 {
@@ -14,6 +24,14 @@ int main(int argc, char *argv[])
 	std::string filename = "";
 	bool useTTF = false;
 
+	// Batch rendering options
+	bool batch = false;
+	int first = 0;
+	int last = -1;
+	int nWorkers = 1;
+	std::string prefix = "event";
+	std::string format = "png";
+
 	if (argc > 1)
 	{
 		for (int i = 1; i < argc; ++i)
@@ -39,6 +57,38 @@ int main(int argc, char *argv[])
 				std::cout << "== Using TTF Fonts" << std::endl;
 				useTTF = true;
 			}
+			// Batch rendering switch
+			else if (std::strcmp(argv[i], "-b") == 0)
+			{
+				batch = true;
+			}
+			// Batch options that take a value
+			else if ((std::strcmp(argv[i], "-r") == 0 || std::strcmp(argv[i], "-j") == 0 ||
+					  std::strcmp(argv[i], "-o") == 0 || std::strcmp(argv[i], "-e") == 0) &&
+					 i + 1 < argc)
+			{
+				if (std::strcmp(argv[i], "-r") == 0)
+				{
+					// Either a single event or first:last
+					if (std::sscanf(argv[i + 1], "%d:%d", &first, &last) == 1)
+					{
+						last = first;
+					}
+				}
+				else if (std::strcmp(argv[i], "-j") == 0)
+				{
+					nWorkers = std::atoi(argv[i + 1]);
+				}
+				else if (std::strcmp(argv[i], "-o") == 0)
+				{
+					prefix = argv[i + 1];
+				}
+				else
+				{
+					format = argv[i + 1];
+				}
+				++i;
+			}
 			// Help switch
 			else if (std::strcmp(argv[i], "-h") == 0)
 			{
@@ -62,6 +112,17 @@ int main(int argc, char *argv[])
 	{
 		gEnv->SetValue("Unix.*.Root.UseTTFonts", "false");
 	}
+
+	if (batch)
+	{
+		if (filename == "")
+		{
+			std::cout << "== Batch mode requires a file name, use -f" << std::endl;
+			return 1;
+		}
+		return RunBatch(filename, first, last, nWorkers, prefix, format);
+	}
+
 	TApplication theApp("App", &argc, argv);
 
 	// Popup the GUI...
@@ -74,10 +135,122 @@ int main(int argc, char *argv[])
 	return 0;
 }
 
+// Render the events in [first, last] to image files. Each worker is a separate
+// process that opens the file itself and renders every nWorkers-th event, so
+// nothing from ROOT is shared between them.
+int RunBatch(std::string filename, int first, int last, int nWorkers, std::string prefix, std::string format)
+{
+	gROOT->SetBatch(kTRUE);
+
+	// Find the number of events without keeping anything open across the fork
+	int nEvents = 0;
+	{
+		TFile file(filename.c_str(), "READ");
+		TTree *tree = (TTree *)file.Get("wcsimT");
+		if (!tree)
+		{
+			std::cout << filename << " is not a WCSim file." << std::endl;
+			return 1;
+		}
+		nEvents = tree->GetEntries();
+	}
+	if (last < 0 || last >= nEvents)
+	{
+		last = nEvents - 1;
+	}
+	if (first < 0)
+	{
+		first = 0;
+	}
+	if (nWorkers < 1)
+	{
+		nWorkers = 1;
+	}
+	int nRequested = last - first + 1;
+	if (nRequested <= 0)
+	{
+		std::cout << "== No events to render in " << filename << std::endl;
+		return 1;
+	}
+	if (nWorkers > nRequested)
+	{
+		nWorkers = nRequested;
+	}
+	std::cout << "== Rendering events " << first << " to " << last << " with " << nWorkers << " worker(s) as "
+			  << prefix << "_<event>_{charge,time}." << format << std::endl;
+
+	std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+	int failed = 0;
+	if (nWorkers == 1)
+	{
+		WCSimEvDisplayBatch renderer;
+		if (!renderer.OpenFile(filename))
+		{
+			return 1;
+		}
+		int nRendered = renderer.RenderEvents(first, last, 0, 1, prefix, format);
+		std::cout << "== Rendered " << nRendered << " events with hits" << std::endl;
+	}
+	else
+	{
+		std::vector<pid_t> workers;
+		for (int w = 0; w < nWorkers; ++w)
+		{
+			pid_t pid = fork();
+			if (pid == 0)
+			{
+				WCSimEvDisplayBatch renderer;
+				if (!renderer.OpenFile(filename))
+				{
+					_exit(1);
+				}
+				int nRendered = renderer.RenderEvents(first, last, w, nWorkers, prefix, format);
+				std::cout << "== Worker " << w << " rendered " << nRendered << " events with hits" << std::endl;
+				std::cout.flush();
+				_exit(0);
+			}
+			else if (pid < 0)
+			{
+				std::cout << "== Could not start worker " << w << std::endl;
+				++failed;
+			}
+			else
+			{
+				workers.push_back(pid);
+			}
+		}
+		for (unsigned int w = 0; w < workers.size(); ++w)
+		{
+			int status = 0;
+			waitpid(workers[w], &status, 0);
+			if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+			{
+				++failed;
+			}
+		}
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+	std::cout << "== Processed " << nRequested << " events in " << seconds << " s: " << nRequested / seconds
+			  << " events/s" << std::endl;
+	if (failed > 0)
+	{
+		std::cout << "== " << failed << " worker(s) failed, their events are missing" << std::endl;
+		return 1;
+	}
+	return 0;
+}
+
 void PrintHelp()
 {
 	std::cout << "Usage instructions for evDisplay" << std::endl;
 	std::cout << "\t-h Displays the help message" << std::endl;
 	std::cout << "\t-f <filename> Supply an input file" << std::endl;
 	std::cout << "\t-t Enable useage of TTF fonts (slow over ssh)" << std::endl;
+	std::cout << "Batch rendering, no window is opened:" << std::endl;
+	std::cout << "\t-b Render the events of the -f file to image files" << std::endl;
+	std::cout << "\t-r <first>:<last> Range of events to render, default all" << std::endl;
+	std::cout << "\t-j <n> Number of worker processes, default 1" << std::endl;
+	std::cout << "\t-o <prefix> Output files are <prefix>_<event>_charge and _time, default event" << std::endl;
+	std::cout << "\t-e <format> Image format, png or pdf, default png" << std::endl;
 }
@@ -0,0 +1,139 @@
+// Replay the saved Cherenkov hits of a chipssim output file through each of
+// the trigger algorithms and report the number of triggers and the time taken
+// per event. The file needs the raw hits, so chipssim must be run with
+// /WCSimIO/SaveRawHits true.
+//
+// Usage: triggerreplay <file.root> [threshold] [window (ns)] [dead time (ns)]
+
+#include "WCSimRootEvent.hh"
+#include "WCSimRootGeom.hh"
+#include "WCSimTrigger.hh"
+
+#include <TFile.h>
+#include <TTree.h>
+#include <TClonesArray.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+int main(int argc, char **argv)
+{
+	if (argc < 2)
+	{
+		std::cout << "Usage: " << argv[0] << " <file.root> [threshold] [window (ns)] [dead time (ns)]" << std::endl;
+		return 1;
+	}
+
+	int threshold = (argc > 2) ? atoi(argv[2]) : 25;
+	double window = (argc > 3) ? atof(argv[3]) : 200.0;
+	double deadTime = (argc > 4) ? atof(argv[4]) : 950.0;
+
+	TFile file(argv[1], "READ");
+	TTree *tree = (TTree *)file.Get("wcsimT");
+	TTree *geoTree = (TTree *)file.Get("wcsimGeoT");
+	if (!tree || !geoTree)
+	{
+		std::cout << "Could not find wcsimT and wcsimGeoT in " << argv[1] << std::endl;
+		return 1;
+	}
+
+	// The veto PMTs are left out of the trigger, as in the digitizer
+	WCSimRootGeom *geo = 0;
+	geoTree->SetBranchAddress("wcsimrootgeom", &geo);
+	geoTree->GetEntry(0);
+	std::map<int, int> cylLoc;
+	for (int p = 0; p < geo->GetWCNumPMT(); ++p)
+	{
+		WCSimRootPMT pmt = geo->GetPMT(p);
+		cylLoc[pmt.GetTubeNo()] = pmt.GetCylLoc();
+	}
+
+	WCSimRootEvent *event = 0;
+	tree->SetBranchAddress("wcsimrootevent", &event);
+
+	std::vector<WCSimTrigger *> triggers;
+	triggers.push_back(WCSimTrigger::Create("gap", threshold, window, deadTime));
+	triggers.push_back(WCSimTrigger::Create("nhits", threshold, window, deadTime));
+	triggers.push_back(WCSimTrigger::Create("ndigits", threshold, window, deadTime));
+
+	std::vector<long> nTriggers(triggers.size(), 0);
+	std::vector<double> totalTime(triggers.size(), 0.);
+	std::vector<double> maxTime(triggers.size(), 0.);
+	std::vector<double> firstHits, allHits, triggerTimes;
+	std::vector<Int_t> rawTubes, rawNumPe, rawParents;
+	std::vector<Float_t> rawTimes;
+
+	long nEvents = tree->GetEntries();
+	long nHitEvents = 0;
+	for (long e = 0; e < nEvents; ++e)
+	{
+		tree->GetEntry(e);
+		WCSimRootTrigger *rawTrigger = event->GetTrigger(0);
+		rawTrigger->GetRawHits(rawTubes, rawNumPe, rawTimes, rawParents);
+		if (rawTubes.empty())
+		{
+			continue;
+		}
+		++nHitEvents;
+
+		firstHits.clear();
+		allHits.clear();
+		unsigned int photon = 0;
+		for (unsigned int h = 0; h < rawTubes.size(); ++h)
+		{
+			unsigned int start = photon;
+			photon += rawNumPe[h];
+			if (cylLoc[rawTubes[h]] == 3)
+			{
+				continue;
+			}
+			double first = 0.;
+			for (int p = 0; p < rawNumPe[h]; ++p)
+			{
+				double time = rawTimes[start + p];
+				first = (p == 0) ? time : std::min(first, time);
+				allHits.push_back(time);
+			}
+			if (rawNumPe[h] > 0)
+			{
+				firstHits.push_back(first);
+			}
+		}
+
+		// Time the sort too, as the digitizer has to do it for every event
+		for (unsigned int t = 0; t < triggers.size(); ++t)
+		{
+			std::vector<double> times = triggers[t]->UsesAllHitTimes() ? allHits : firstHits;
+			std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+			std::sort(times.begin(), times.end());
+			triggers[t]->FindTriggers(times, triggerTimes);
+			double elapsed = std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - start).count();
+
+			nTriggers[t] += triggerTimes.size();
+			totalTime[t] += elapsed;
+			maxTime[t] = std::max(maxTime[t], elapsed);
+		}
+	}
+
+	std::cout << "Replayed " << nHitEvents << " of " << nEvents << " events with a threshold of " << threshold
+			  << " hits, a window of " << window << " ns and a dead time of " << deadTime << " ns" << std::endl;
+	for (unsigned int t = 0; t < triggers.size(); ++t)
+	{
+		double meanTime = (nHitEvents > 0) ? totalTime[t] / nHitEvents : 0.;
+		double meanTriggers = (nHitEvents > 0) ? nTriggers[t] / static_cast<double>(nHitEvents) : 0.;
+		std::cout << "  " << triggers[t]->GetName() << ": " << nTriggers[t] << " triggers (" << meanTriggers
+				  << " per event), " << meanTime << " us per event (max " << maxTime[t] << " us)" << std::endl;
+		delete triggers[t];
+	}
+
+	if (nHitEvents == 0)
+	{
+		std::cout << "No raw hits found, was chipssim run with /WCSimIO/SaveRawHits true?" << std::endl;
+	}
+	return 0;
+}
@@ -0,0 +1,49 @@
+// Convert NUANCE text vector files into the binary format read by
+// WCSimBinaryVectorReader. The output can be given to /mygen/vecfile and
+// /mygen/overlayfile in place of the text files.
+//
+// Usage: vectorconvert <input.vec> [more.vec ...] <output.vecb>
+
+#include "WCSimVectorFileReader.hh"
+
+#include <iostream>
+#include <string>
+
+int main(int argc, char **argv)
+{
+	if (argc < 3)
+	{
+		std::cout << "Usage: " << argv[0] << " <input.vec> [more.vec ...] <output.vecb>" << std::endl;
+		return 1;
+	}
+
+	std::string outputName = argv[argc - 1];
+	WCSimBinaryVectorWriter writer;
+	if (!writer.Open(outputName))
+	{
+		std::cout << "Could not open " << outputName << " for writing" << std::endl;
+		return 1;
+	}
+
+	WCSimTextVectorReader reader;
+	WCSimVectorEvent event;
+	for (int i = 1; i < argc - 1; ++i)
+	{
+		if (!reader.Open(argv[i]))
+		{
+			std::cout << "Could not open " << argv[i] << std::endl;
+			return 1;
+		}
+		int nEvents = 0;
+		while (reader.ReadEvent(event))
+		{
+			writer.WriteEvent(event);
+			++nEvents;
+		}
+		std::cout << "Read " << nEvents << " events from " << argv[i] << std::endl;
+	}
+	writer.Close();
+
+	std::cout << "Wrote " << writer.GetNumberOfEvents() << " events to " << outputName << std::endl;
+	return 0;
+}
@@ -0,0 +1,36 @@
+#include "WCSimActionInitialization.hh"
+
+#include "WCSimDetectorConstruction.hh"
+#include "WCSimPrimaryGeneratorAction.hh"
+#include "WCSimRunAction.hh"
+#include "WCSimEventAction.hh"
+#include "WCSimTrackingAction.hh"
+#include "WCSimStackingAction.hh"
+#include "WCSimSteppingAction.hh"
+
+WCSimActionInitialization::WCSimActionInitialization(WCSimDetectorConstruction *detector) : fDetector(detector)
+{
+}
+
+WCSimActionInitialization::~WCSimActionInitialization()
+{
+}
+
+void WCSimActionInitialization::BuildForMaster() const
+{
+	SetUserAction(new WCSimRunAction(fDetector));
+}
+
+void WCSimActionInitialization::Build() const
+{
+	WCSimPrimaryGeneratorAction *generatorAction = new WCSimPrimaryGeneratorAction(fDetector);
+	SetUserAction(generatorAction);
+
+	WCSimRunAction *runAction = new WCSimRunAction(fDetector);
+	SetUserAction(runAction);
+
+	SetUserAction(new WCSimEventAction(runAction, fDetector, generatorAction));
+	SetUserAction(new WCSimTrackingAction);
+	SetUserAction(new WCSimStackingAction(fDetector, runAction, generatorAction));
+	SetUserAction(new WCSimSteppingAction);
+}
@@ -1,5 +1,7 @@
 // C++ headers
 #include <iostream>
+#include <cmath>
+#include <chrono>
 // GEANT headers
 #include "globals.hh"
 // Root headers
@@ -39,6 +41,7 @@ WCSimCHIPSPMT::WCSimCHIPSPMT()
 	// Remember roughly that gain is proportional to V^0.7, so need to raise
 	// multisum to the power 0.7.
 	fDynodeGain = pow(fTotalGain / pow(multisum, 0.7), 0.1);
+	CalculateStageGains();
 
 	fNonLinAlpha = GetNonLinFuncAlpha();
 	fNonLinBeta = GetNonLinFuncBeta();
@@ -49,8 +52,6 @@ WCSimCHIPSPMT::WCSimCHIPSPMT()
 
 	fProbCathodeSkip = 0.0;
 	fProbDynode1Skip = 0.0;
-
-	fRand = TRandom3(0);
 }
 
 WCSimCHIPSPMT::WCSimCHIPSPMT(const WCSimCHIPSPMT &rhs)
@@ -58,11 +59,11 @@ WCSimCHIPSPMT::WCSimCHIPSPMT(const WCSimCHIPSPMT &rhs)
 	fDynodeStages = rhs.GetDynodeStages();
 	fTotalGain = rhs.GetTotalGain();
 	fDamping = 0.; // So we get the right gain, update later.
-	fDynodeGain = rhs.GetDynodeGain(0);
-	for (int i = 0; i < 10; ++i)
-	{
-		fDynodeGainMod[i] = rhs.GetDynodeGainMod(i);
-	}
+	fDynodeGain = rhs.fDynodeGain;
+	fDynodeGainMod = rhs.fDynodeGainMod;
+	CalculateStageGains();
+	fProbCathodeSkip = rhs.GetProbCathodeSkip();
+	fProbDynode1Skip = rhs.GetProbDynode1Skip();
 	fNonLinAlpha = rhs.GetNonLinFuncAlpha();
 	fNonLinBeta = rhs.GetNonLinFuncBeta();
 
@@ -91,12 +92,17 @@ double WCSimCHIPSPMT::CalculateCharge(int pe, double start, double end)
 	// 2) Electron misses the first dynode.
 	double nSkipCathode = 0.;
 	double nSkipDynode1 = 0.;
-	for (int i = 0; i < pe; ++i)
+	// Both probabilities are zero by default, in which case don't spend two
+	// random numbers per pe to find out nothing happens.
+	if (fProbCathodeSkip > 0. || fProbDynode1Skip > 0.)
 	{
-		if (fRand.Rndm() < fProbCathodeSkip)
-			++nSkipCathode;
-		else if (fRand.Rndm() < fProbDynode1Skip)
-			++nSkipDynode1;
+		for (int i = 0; i < pe; ++i)
+		{
+			if (fRand.Rndm() < fProbCathodeSkip)
+				++nSkipCathode;
+			else if (fRand.Rndm() < fProbDynode1Skip)
+				++nSkipDynode1;
+		}
 	}
 	currentPE -= nSkipCathode; // We will treat these separately.
 	currentPE -= nSkipDynode1; // We will treat these separately.
@@ -140,6 +146,107 @@ double WCSimCHIPSPMT::CalculateCharge(int pe, double start, double end)
 	return currentPE;
 }
 
+void WCSimCHIPSPMT::CalculateCharges(const std::vector<int> &pe, const std::vector<double> &start,
+									 const std::vector<double> &end, std::vector<double> &charges)
+{
+	unsigned int nTubes = pe.size();
+	charges.resize(nTubes);
+
+	// The skipped dynode cases need the full treatment for each tube
+	if (fProbCathodeSkip > 0. || fProbDynode1Skip > 0.)
+	{
+		for (unsigned int t = 0; t < nTubes; ++t)
+		{
+			charges[t] = CalculateCharge(pe[t], start[t], end[t]);
+		}
+		return;
+	}
+
+	// Damping of the gain of each tube from its pe rate
+	fBatchDamping.resize(nTubes);
+	for (unsigned int t = 0; t < nTubes; ++t)
+	{
+		double rate = (end[t] != start[t]) ? pe[t] / (end[t] - start[t]) : 0.0;
+		fBatchDamping[t] = CalculateDamping(rate);
+		charges[t] = pe[t];
+	}
+
+	// Take every tube through the cascade one dynode at a time
+	for (int d = 0; d < fDynodeStages; ++d)
+	{
+		double stageGain = fStageGain[d];
+		for (unsigned int t = 0; t < nTubes; ++t)
+		{
+			charges[t] = GetChargeRandom(charges[t] * stageGain * fBatchDamping[t]);
+		}
+	}
+
+	// Now we scale the charge by the gain in order to get back to sensible units.
+	double invTotalGain = 1. / fTotalGain;
+	for (unsigned int t = 0; t < nTubes; ++t)
+	{
+		charges[t] *= invTotalGain;
+	}
+
+	// Leave the damping as the single tube method would have done
+	if (nTubes > 0)
+	{
+		fDamping = fBatchDamping[nTubes - 1];
+	}
+}
+
+void WCSimCHIPSPMT::BenchmarkCharge(int nTubes, int nRepeats)
+{
+	// A shower-like gate: most tubes see a few pe, a tail sees hundreds,
+	// with the photons spread over up to 20ns.
+	std::vector<int> pe(nTubes);
+	std::vector<double> start(nTubes);
+	std::vector<double> end(nTubes);
+	for (int t = 0; t < nTubes; ++t)
+	{
+		pe[t] = 1 + static_cast<int>(fRand.Exp(20.));
+		start[t] = 0.;
+		end[t] = (pe[t] > 1) ? fRand.Uniform(1., 20.) : 0.;
+	}
+
+	std::vector<double> charges;
+	double sumSingle = 0., sumSqSingle = 0.;
+	std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+	for (int r = 0; r < nRepeats; ++r)
+	{
+		for (int t = 0; t < nTubes; ++t)
+		{
+			double q = CalculateCharge(pe[t], start[t], end[t]) / pe[t];
+			sumSingle += q;
+			sumSqSingle += q * q;
+		}
+	}
+	double timeSingle = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+	double sumBatch = 0., sumSqBatch = 0.;
+	begin = std::chrono::steady_clock::now();
+	for (int r = 0; r < nRepeats; ++r)
+	{
+		CalculateCharges(pe, start, end, charges);
+		for (int t = 0; t < nTubes; ++t)
+		{
+			double q = charges[t] / pe[t];
+			sumBatch += q;
+			sumSqBatch += q * q;
+		}
+	}
+	double timeBatch = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+	double n = static_cast<double>(nTubes) * nRepeats;
+	double meanSingle = sumSingle / n;
+	double meanBatch = sumBatch / n;
+	std::cout << "WCSimCHIPSPMT::BenchmarkCharge: " << nRepeats << " gates of " << nTubes << " tubes" << std::endl;
+	std::cout << "  CalculateCharge : " << n / timeSingle << " tubes/s, charge/pe mean " << meanSingle << " RMS "
+			  << sqrt(sumSqSingle / n - meanSingle * meanSingle) << std::endl;
+	std::cout << "  CalculateCharges: " << n / timeBatch << " tubes/s, charge/pe mean " << meanBatch << " RMS "
+			  << sqrt(sumSqBatch / n - meanBatch * meanBatch) << std::endl;
+}
+
 double WCSimCHIPSPMT::GetChargeRandom(double pe)
 {
 
@@ -162,11 +269,21 @@ double WCSimCHIPSPMT::GetDynodeGain(int dynode) const
 {
 
 	// Used the electonrics schematic in the icecube paper to look at the individual gains for the dynodes. Decided to set them all relative to dynode one.
-	double gain = fDynodeGain * pow(fDynodeGainMod[dynode], 0.7) * fDamping;
+	double gain = fStageGain[dynode] * fDamping;
 
 	return gain;
 }
 
+void WCSimCHIPSPMT::CalculateStageGains()
+{
+	fDynodeStages = fDynodeGainMod.size();
+	fStageGain.resize(fDynodeStages);
+	for (int d = 0; d < fDynodeStages; ++d)
+	{
+		fStageGain[d] = fDynodeGain * pow(fDynodeGainMod[d], 0.7);
+	}
+}
+
 double WCSimCHIPSPMT::CalculateDamping(double peRate)
 {
 
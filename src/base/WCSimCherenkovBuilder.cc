@@ -258,7 +258,8 @@ void WCSimCherenkovBuilder::ConstructDetectorWrapper()
 		ConstructEndCaps();
 		ConstructPMTs();
 		PlacePMTs();
-		CreateSensitiveDetector();
+		// The sensitive detector is made in ConstructSDandField(), since
+		// each thread needs its own.
 
 		// std::cout << "Top cap logical volume: " << fCapLogicTop->GetName() << std::endl;
 	}
@@ -2485,14 +2486,28 @@ void WCSimCherenkovBuilder::ConstructEndCapPhysicalVolumes()
 void WCSimCherenkovBuilder::CreateSensitiveDetector()
 {
 
+	// The SD manager belongs to this thread, so look the detector up there
+	// rather than reusing one made by another thread.
 	G4SDManager *SDman = G4SDManager::GetSDMpointer();
-	if (!aWCPMT)
+	WCSimWCSD *sensDet = (WCSimWCSD *)SDman->FindSensitiveDetector("/WCSim/glassFaceWCPMT", false);
+	if (!sensDet)
 	{
-		aWCPMT = new WCSimWCSD("/WCSim/glassFaceWCPMT", this);
-		SDman->AddNewDetector(aWCPMT);
+		sensDet = new WCSimWCSD("/WCSim/glassFaceWCPMT", this);
+		SDman->AddNewDetector(sensDet);
 	}
 
-	fPMTBuilder.SetSensitiveDetector(aWCPMT);
+	fPMTBuilder.SetSensitiveDetector(sensDet);
+}
+
+void WCSimCherenkovBuilder::ConstructSDandField()
+{
+	// The mailbox geometry is still built by WCSimDetectorConstruction
+	if (GetIsMailbox())
+	{
+		WCSimDetectorConstruction::ConstructSDandField();
+		return;
+	}
+	CreateSensitiveDetector();
 }
 
 G4LogicalVolume *WCSimCherenkovBuilder::ConstructWC()
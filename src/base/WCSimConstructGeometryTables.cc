@@ -14,6 +14,7 @@
 #include "G4VisAttributes.hh"
 #include "G4Tubs.hh"
 #include "G4Sphere.hh"
+#include "G4VTouchable.hh"
 #include "CLHEP/Units/SystemOfUnits.h"
 
 #include <sstream>
@@ -138,6 +139,8 @@ void WCSimDetectorConstruction::DescribeAndRegisterPMT(G4VPhysicalVolume *aPV, i
 													   const G4Transform3D &aTransform)
 {
 	static std::string replicaNoString[20];
+	static G4VPhysicalVolume *replicaPV[20];
+	static int replicaCopyNo[20];
 
 	std::stringstream depth;
 	std::stringstream pvname;
@@ -146,6 +149,8 @@ void WCSimDetectorConstruction::DescribeAndRegisterPMT(G4VPhysicalVolume *aPV, i
 	pvname << aPV->GetName();
 
 	replicaNoString[aDepth] = pvname.str() + "-" + depth.str();
+	replicaPV[aDepth] = aPV;
+	replicaCopyNo[aDepth] = replicaNo;
 
 	//aah original line->
 	//if ((aPV->GetName() == "GlassFaceWCPMT"))
@@ -183,6 +188,23 @@ void WCSimDetectorConstruction::DescribeAndRegisterPMT(G4VPhysicalVolume *aPV, i
 		tubeTag += ":GlassFaceWCPMT-0";
 		tubeLocationMap[tubeTag] = totalNumPMTs;
 
+		// Build the integer key from the same chain of volumes, finishing with
+		// the glass face which is where the sensitive detector sees the hit.
+		unsigned long tubeKey = 0;
+		for (int i = 0; i <= aDepth; i++)
+			tubeKey = AddTubeKeyLevel(tubeKey, replicaPV[i], replicaCopyNo[i]);
+		G4LogicalVolume *pmtLogic = aPV->GetLogicalVolume();
+		for (int iDaughter = 0; iDaughter < pmtLogic->GetNoDaughters(); iDaughter++)
+		{
+			G4VPhysicalVolume *daughter = pmtLogic->GetDaughter(iDaughter);
+			if (daughter->GetName() == "GlassFaceWCPMT")
+			{
+				tubeKey = AddTubeKeyLevel(tubeKey, daughter, daughter->GetCopyNo());
+				break;
+			}
+		}
+		tubeKeyMap[totalNumPMTs] = tubeKey;
+
 		// Record where tube is in the cylinder
 		// (JF) This distinction was useful for 2km detector
 		// not so much for DUSEL
@@ -304,10 +326,12 @@ void WCSimDetectorConstruction::DumpGeometryTableToFile()
 	{
 		fpmts.push_back(0x0);
 	}
+	fTubePMTType.assign(totalNumPMTs, 0);
 
 	// A new hash map to re-order the PMTs. This is needed by
 	// the sensitive detector class later in the simulation.
 	hash_map<std::string, int, hash<std::string>> newLocHashMap;
+	hash_map<unsigned long, int, hash<unsigned long>> newKeyHashMap;
 
 	// Grab the tube information from the tubeID Map and dump to file.
 	int pmtNo = 0; // Will increment before using so first PMT is 1.
@@ -358,6 +382,11 @@ void WCSimDetectorConstruction::DumpGeometryTableToFile()
 		}
 		// Fill a new hash map based on the pmt ordering we need.
 		newLocHashMap[tubeTagMap[tubeID]] = tubeNumber;
+		if (newKeyHashMap.count(tubeKeyMap[tubeID]))
+		{
+			tubeKeyCollision = true;
+		}
+		newKeyHashMap[tubeKeyMap[tubeID]] = tubeNumber;
 
 		geoFile.precision(9);
 		geoFile << setw(4) << tubeNumber << " " << setw(8) << newTransform.getTranslation().getX() / CLHEP::cm << " "
@@ -371,12 +400,78 @@ void WCSimDetectorConstruction::DumpGeometryTableToFile()
 												 pmtOrientation.x(), pmtOrientation.y(), pmtOrientation.z(), tubeNumber, pmtName);
 
 		fpmts[tubeNumber - 1] = new_pmt;
+
+		// Resolve the PMT type now so nothing needs to compare names per hit
+		G4int pmtType = fPMTQE.GetType(pmtName);
+		if (pmtType < 0)
+		{
+			G4cout << "WCSimDetectorConstruction: unknown PMT type " << pmtName << ", using " << fPMTConfigs[0].GetPMTName()
+				   << G4endl;
+			pmtType = 0;
+		}
+		fTubePMTType[tubeNumber - 1] = pmtType;
 	}
 
 	tubeLocationMap = newLocHashMap;
+	tubeKeyLocationMap = newKeyHashMap;
+	if (tubeKeyCollision)
+	{
+		G4cout << "WCSimDetectorConstruction: tube key collision, falling back to tube tag lookup" << G4endl;
+	}
 	geoFile.close();
 }
 
+// Fast tube lookup used by the sensitive detector. Walks the touchable
+// history with the same volumes and copy numbers as the tube tag, but only
+// combines pointers and integers, so there is no string building per photon.
+G4int WCSimDetectorConstruction::GetTubeID(const G4VTouchable *touchable)
+{
+	if (tubeKeyCollision)
+	{
+		return GetTubeID(GetTubeTag(touchable));
+	}
+
+	unsigned long tubeKey = 0;
+	for (G4int i = touchable->GetHistoryDepth() - 1; i >= 0; i--)
+	{
+		tubeKey = AddTubeKeyLevel(tubeKey, touchable->GetVolume(i), touchable->GetCopyNumber(i));
+	}
+
+	hash_map<unsigned long, int, hash<unsigned long>>::const_iterator found = tubeKeyLocationMap.find(tubeKey);
+	if (found == tubeKeyLocationMap.end())
+	{
+		return 0;
+	}
+	return found->second;
+}
+
+// See DescribeAndRegisterPMT() for the matching tag construction.
+std::string WCSimDetectorConstruction::GetTubeTag(const G4VTouchable *touchable)
+{
+	std::stringstream tubeTag;
+	for (G4int i = touchable->GetHistoryDepth() - 1; i >= 0; i--)
+	{
+		tubeTag << ":" << touchable->GetVolume(i)->GetName();
+		tubeTag << "-" << touchable->GetCopyNumber(i);
+	}
+	return tubeTag.str();
+}
+
+// 64-bit FNV-1a style mixing of the volume address and copy number.
+// Collisions are checked for when the tube maps are built.
+unsigned long WCSimDetectorConstruction::AddTubeKeyLevel(unsigned long key, const G4VPhysicalVolume *pv,
+														 G4int copyNo)
+{
+	const unsigned long prime = 1099511628211UL;
+	if (key == 0)
+	{
+		key = 14695981039346656037UL;
+	}
+	key = (key ^ (unsigned long)pv) * prime;
+	key = (key ^ (unsigned long)copyNo) * prime;
+	return key;
+}
+
 // Code for traversing the geometry tree.  This code is very general you pass
 // it a function and it will call the function with the information on each
 // object it finds.
@@ -36,6 +36,9 @@
 #include "WCSimPMTConfig.hh"
 #include "WCSimPolygonTools.hh"
 #include "WCSimTuningParameters.hh" //jl145
+#include "Randomize.hh"
+
+#include <chrono>
 
 G4float WCSimDetectorConstruction::GetPMTQE(G4float PhotonWavelength, G4int flag, G4float low_wl, G4float high_wl,
 											G4float ratio)
@@ -105,6 +108,46 @@ G4float WCSimDetectorConstruction::GetPMTQE(G4float PhotonWavelength, G4int flag
 	return newWave;
 }
 
+void WCSimDetectorConstruction::BenchmarkPMTQE(G4int nCalls)
+{
+	// Fixed set of random wavelengths between 200 and 700nm so both methods see the same photons
+	std::vector<G4float> wavelengths(nCalls);
+	for (G4int i = 0; i < nCalls; ++i)
+	{
+		wavelengths[i] = 200. + 500. * G4UniformRand();
+	}
+
+	// Old method, as called per photon by the stacking action
+	G4double sumOld = 0.;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (G4int i = 0; i < nCalls; ++i)
+	{
+		sumOld += GetPMTQE(wavelengths[i], 1, 240, 660, 1.0);
+	}
+	G4double timeOld = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	// Tabulated method for the same PMT type
+	G4double sumNew = 0.;
+	start = std::chrono::steady_clock::now();
+	for (G4int i = 0; i < nCalls; ++i)
+	{
+		sumNew += fPMTQE.GetQE(wavelengths[i], 0);
+	}
+	G4double timeNew = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	// Largest difference between the two
+	G4double maxDiff = 0.;
+	for (G4int i = 0; i < nCalls; ++i)
+	{
+		maxDiff = std::max(maxDiff, fabs(GetPMTQE(wavelengths[i], 1, 240, 660, 1.0) - fPMTQE.GetQE(wavelengths[i], 0)));
+	}
+
+	G4cout << "BenchmarkPMTQE: " << nCalls << " calls for PMT type " << fPMTConfigs[0].GetPMTName() << G4endl;
+	G4cout << "  GetPMTQE      : " << nCalls / timeOld << " calls/s (mean QE " << sumOld / nCalls << ")" << G4endl;
+	G4cout << "  QE table      : " << nCalls / timeNew << " calls/s (mean QE " << sumNew / nCalls << ")" << G4endl;
+	G4cout << "  Max difference: " << maxDiff << G4endl;
+}
+
 // Geometry definitions for the detectors moved to WCSimDefineGeometry.cc
 
 //PMT logical volume construction is moved to seperate file, WCSimConstructPMT.
@@ -908,17 +951,8 @@ G4LogicalVolume *WCSimDetectorConstruction::ConstructMailboxWC()
 					  false,								// no boolean operations
 					  5);									// copy number
 
-	// Make sensitive detectors in the six faces
-
-	G4SDManager *SDman = G4SDManager::GetSDMpointer();
-
-	if (!aWCPMT)
-	{
-		aWCPMT = new WCSimWCSD("/WCSim/glassFaceWCPMT", this);
-		SDman->AddNewDetector(aWCPMT);
-		G4cout << "Got to sensitive detector code \n";
-	}
-	logicGlassFaceWCPMT->SetSensitiveDetector(aWCPMT);
+	// The sensitive detector in the six faces is made in ConstructSDandField(),
+	// since each thread needs its own.
 
 	//Put Fiducial into WaterTank, and WaterTank into "Cavern"
 	new G4PVPlacement(0, G4ThreeVector(), logic_WC_MB_Fiducial, "physiMB_Fiducial", logic_WC_MB_tank_H20, false, 0,
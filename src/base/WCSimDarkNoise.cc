@@ -0,0 +1,142 @@
+#include "WCSimDarkNoise.hh"
+#include "WCSimDetectorConstruction.hh"
+#include "WCSimPmtInfo.hh"
+#include "WCSimWCDigitizer.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+WCSimDarkNoise::WCSimDarkNoise(WCSimDetectorConstruction *det)
+{
+	fDet = det;
+	fDarkRate = 0.;
+}
+
+WCSimDarkNoise::~WCSimDarkNoise()
+{
+}
+
+void WCSimDarkNoise::BuildTubeTable()
+{
+	std::vector<WCSimPmtInfo *> *pmts = fDet->Get_Pmts();
+	if (fTubeIDs.size() == pmts->size())
+	{
+		return;
+	}
+
+	fTubeIDs.resize(pmts->size());
+	fTubeTypes.resize(pmts->size());
+	G4int maxTubeID = 0;
+	for (unsigned int p = 0; p < pmts->size(); ++p)
+	{
+		fTubeIDs[p] = pmts->at(p)->Get_tubeid();
+		fTubeTypes[p] = fDet->GetTubePMTType(fTubeIDs[p]);
+		maxTubeID = std::max(maxTubeID, fTubeIDs[p]);
+	}
+	fTubeToHit.assign(maxTubeID + 1, 0);
+}
+
+G4int WCSimDarkNoise::AddDarkNoise(WCSimWCHitsCollection *hits, G4double start, G4double end)
+{
+	if (fDarkRate <= 0. || end <= start)
+	{
+		return 0;
+	}
+
+	BuildTubeTable();
+	if (fTubeIDs.empty())
+	{
+		return 0;
+	}
+
+	// kHz to hits per ns, summed over every tube
+	G4double mean = fDarkRate * 1e-6 * fTubeIDs.size() * (end - start);
+	G4int nDark = fRand.Poisson(mean);
+	if (nDark == 0)
+	{
+		return 0;
+	}
+
+	// Draw all of the tubes and times in one go
+	fRandomTubes.resize(nDark);
+	fRandomTimes.resize(nDark);
+	fRand.RndmArray(nDark, &fRandomTubes[0]);
+	fRand.RndmArray(nDark, &fRandomTimes[0]);
+	for (G4int d = 0; d < nDark; ++d)
+	{
+		fRandomTubes[d] *= fTubeIDs.size();
+		fRandomTimes[d] = start + fRandomTimes[d] * (end - start);
+	}
+
+	// Adding them in time order means the hits only need sorting again when
+	// the noise lands before existing photons
+	std::sort(fRandomTimes.begin(), fRandomTimes.end());
+
+	for (G4int h = 0; h < hits->entries(); ++h)
+	{
+		fTubeToHit[(*hits)[h]->GetTubeID()] = h + 1;
+	}
+
+	for (G4int d = 0; d < nDark; ++d)
+	{
+		G4int index = std::min(static_cast<G4int>(fRandomTubes[d]), static_cast<G4int>(fTubeIDs.size()) - 1);
+		G4int tube = fTubeIDs[index];
+		if (fTubeToHit[tube] == 0)
+		{
+			WCSimWCHit *newHit = new WCSimWCHit();
+			newHit->SetTubeName(fDet->Get_Pmts()->at(index)->Get_name());
+			newHit->SetTubeID(tube);
+			newHit->SetTubeType(fTubeTypes[index]);
+			newHit->SetTrackID(-1);
+			newHit->SetEdep(0.);
+			fTubeToHit[tube] = hits->insert(newHit);
+		}
+		(*hits)[fTubeToHit[tube] - 1]->AddPe(fRandomTimes[d]);
+		(*hits)[fTubeToHit[tube] - 1]->AddParentID(-1);
+	}
+
+	// Leave the table empty for the next call
+	for (G4int h = 0; h < hits->entries(); ++h)
+	{
+		fTubeToHit[(*hits)[h]->GetTubeID()] = 0;
+	}
+
+	return nDark;
+}
+
+void WCSimDarkNoise::Benchmark(G4int nEvents)
+{
+	G4double start = WCSimWCDigitizer::GetEventGateDown();
+	G4double end = WCSimWCDigitizer::GetEventGateUp();
+	G4double oldRate = fDarkRate;
+
+	BuildTubeTable();
+	std::cout << "WCSimDarkNoise::Benchmark: " << nEvents << " events of " << fTubeIDs.size() << " PMTs in a "
+			  << end - start << " ns gate" << std::endl;
+
+	const G4double rates[] = {0.5, 1., 2., 4., 8., 16.};
+	for (unsigned int r = 0; r < sizeof(rates) / sizeof(rates[0]); ++r)
+	{
+		fDarkRate = rates[r];
+		long nDark = 0;
+		double elapsed = 0.;
+		for (G4int e = 0; e < nEvents; ++e)
+		{
+			WCSimWCHitsCollection *hits = new WCSimWCHitsCollection("glassFaceWCPMT", "darkNoiseBenchmark");
+			std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+			nDark += AddDarkNoise(hits, start, end);
+			// Include the sort that the trigger finding would do
+			for (G4int h = 0; h < hits->entries(); ++h)
+			{
+				(*hits)[h]->SortHitTimes();
+			}
+			elapsed += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count();
+			delete hits;
+		}
+		std::cout << "  " << fDarkRate << " kHz: " << nDark / static_cast<double>(nEvents) << " dark hits, "
+				  << elapsed / nEvents << " us per event" << std::endl;
+	}
+
+	fDarkRate = oldRate;
+}
@@ -19,6 +19,8 @@
 #include "G4PhysicalVolumeStore.hh"
 #include "G4LogicalVolumeStore.hh"
 #include "G4SolidStore.hh"
+#include "G4SDManager.hh"
+#include "WCSimWCSD.hh"
 #include <map>
 
 std::map<int, G4Transform3D> WCSimDetectorConstruction::tubeIDMap;
@@ -26,6 +28,9 @@ std::map<int, std::string> WCSimDetectorConstruction::tubeNameMap;
 std::map<int, std::string> WCSimDetectorConstruction::tubeTagMap;
 //std::map<int, cyl_location>  WCSimDetectorConstruction::tubeCylLocation;
 hash_map<std::string, int, hash<std::string>> WCSimDetectorConstruction::tubeLocationMap;
+std::map<int, unsigned long> WCSimDetectorConstruction::tubeKeyMap;
+hash_map<unsigned long, int, hash<unsigned long>> WCSimDetectorConstruction::tubeKeyLocationMap;
+G4bool WCSimDetectorConstruction::tubeKeyCollision = false;
 
 WCSimDetectorConstruction::WCSimDetectorConstruction(G4int DetConfig) : fPMTBuilder()
 {
@@ -70,6 +75,8 @@ WCSimDetectorConstruction::WCSimDetectorConstruction(G4int DetConfig) : fPMTBuil
 	WCSimDetectorConstruction::tubeNameMap.clear();
 	//WCSimDetectorConstruction::tubeCylLocation.clear();// (JF) Removed
 	WCSimDetectorConstruction::tubeLocationMap.clear();
+	WCSimDetectorConstruction::tubeKeyMap.clear();
+	WCSimDetectorConstruction::tubeKeyLocationMap.clear();
 	totalNumPMTs = 0;
 	//  WCPMTExposeHeight= 0.;
 	//-----------------------------------------------------
@@ -107,6 +114,26 @@ WCSimDetectorConstruction::WCSimDetectorConstruction(G4int DetConfig) : fPMTBuil
 	// Set the default method as the WCSim default for now
 	//-----------------------------------------------------
 	SetPMTSim(0);
+	SetPMTGaussianThreshold(0);
+
+	//-----------------------------------------------------
+	// No dark noise by default
+	//-----------------------------------------------------
+	SetPMTDarkRate(0.0);
+	SetDigiSeed(0);
+
+	//-----------------------------------------------------
+	// Default trigger is the original gap trigger
+	//-----------------------------------------------------
+	SetTriggerType("gap");
+	SetTriggerThreshold(25);
+	SetTriggerWindow(200.0);
+	SetTriggerVerbose(false);
+
+	//-----------------------------------------------------
+	// Only use the integer tube lookup by default
+	//-----------------------------------------------------
+	SetValidateTubeLookup(false);
 
 	//-----------------------------------------------------
 	// Make the detector messenger to allow changing geometry
@@ -146,6 +173,28 @@ void WCSimDetectorConstruction::Update()
 {
 	G4bool geomChanged = true;
 	G4RunManager::GetRunManager()->DefineWorldVolume(this->Construct(), geomChanged);
+	// The run manager only does this itself when it is initialised
+	this->ConstructSDandField();
+}
+
+void WCSimDetectorConstruction::ConstructSDandField()
+{
+	// Only the mailbox photocathodes are made here, the cylinder is built by
+	// WCSimCherenkovBuilder which attaches its own
+	if (!isMailbox || !logicGlassFaceWCPMT)
+	{
+		return;
+	}
+
+	// The SD manager belongs to this thread, so look the detector up there
+	G4SDManager *SDman = G4SDManager::GetSDMpointer();
+	WCSimWCSD *sensDet = (WCSimWCSD *)SDman->FindSensitiveDetector("/WCSim/glassFaceWCPMT", false);
+	if (!sensDet)
+	{
+		sensDet = new WCSimWCSD("/WCSim/glassFaceWCPMT", this);
+		SDman->AddNewDetector(sensDet);
+	}
+	logicGlassFaceWCPMT->SetSensitiveDetector(sensDet);
 }
 
 WCSimDetectorConstruction::~WCSimDetectorConstruction()
@@ -168,6 +217,8 @@ G4VPhysicalVolume *WCSimDetectorConstruction::Construct()
 	G4LogicalSkinSurface::CleanSurfaceTable();
 
 	totalNumPMTs = 0;
+	tubeKeyMap.clear();
+	tubeKeyCollision = false;
 
 	//-----------------------------------------------------
 	// Create Logical Volumes
@@ -189,6 +240,9 @@ G4VPhysicalVolume *WCSimDetectorConstruction::Construct()
 		logicWCBox = ConstructWC();
 	}
 
+	// The PMT types are known now, so tabulate their efficiencies
+	fPMTQE.Build(fPMTConfigs);
+
 	G4cout << " WCLength (base)      = " << WCLength / CLHEP::m << " CLHEP::m" << G4endl;
 
 	//-------------------------------
@@ -1,16 +1,22 @@
 #include "WCSimDetectorMessenger.hh"
 
 #include "WCSimDetectorConstruction.hh"
+#include "WCSimCHIPSPMT.hh"
+#include "WCSimSK1pePMT.hh"
+#include "WCSimDarkNoise.hh"
 
 #include "G4UIdirectory.hh"
 #include "G4UIcommand.hh"
 #include "G4UIparameter.hh"
 #include "G4UIcmdWithAString.hh"
 #include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAnInteger.hh"
 
 WCSimDetectorMessenger::WCSimDetectorMessenger(WCSimDetectorConstruction *WCSimDet) : WCSimDetector(WCSimDet)
 {
-	WCSimDir = new G4UIdirectory("/WCSim/");
+	// The detector is shared by all threads, so these commands only need to
+	// run on the master rather than being broadcast to the workers.
+	WCSimDir = new G4UIdirectory("/WCSim/", false);
 	WCSimDir->SetGuidance("Commands to change the geometry of the simulation");
 
 	PMTConfig = new G4UIcmdWithAString("/WCSim/WCgeom", this);
@@ -80,6 +86,97 @@ WCSimDetectorMessenger::WCSimDetectorMessenger(WCSimDetectorConstruction *WCSimD
 	PMTPerfectTiming->SetParameterName("PMTPerfectTiming", true); // Omittable, default to false
 	PMTPerfectTiming->SetDefaultValue(false);
 
+	PMTGaussianThreshold = new G4UIcmdWithAnInteger("/WCSim/PMTGaussianThreshold", this);
+	PMTGaussianThreshold->SetGuidance("Number of pe above which the default PMT simulation draws the charge from a Gaussian\n"
+									  " - The mean and width come from the SuperK 1pe spectrum\n"
+									  " - 0 (the default) always sums the single pe charges\n");
+	PMTGaussianThreshold->SetParameterName("PMTGaussianThreshold", true);
+	PMTGaussianThreshold->SetDefaultValue(0);
+	PMTGaussianThreshold->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+	PMTDarkRate = new G4UIcmdWithADouble("/WCSim/PMTDarkRate", this);
+	PMTDarkRate->SetGuidance("Dark noise rate of every PMT in kHz\n"
+							 " - The default value of 0 adds no dark noise\n");
+	PMTDarkRate->SetParameterName("PMTDarkRate", true);
+	PMTDarkRate->SetDefaultValue(0.0);
+	PMTDarkRate->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+	DigiSeed = new G4UIcmdWithAnInteger("/WCSim/DigiSeed", this);
+	DigiSeed->SetGuidance("Base seed of the digitization, combined with the run and event numbers\n"
+						  " - The PMT charges, timing and dark noise of an event then only depend on its hits\n"
+						  " - The default value of 0 draws the base seed from the Geant4 engine each event\n");
+	DigiSeed->SetParameterName("DigiSeed", true);
+	DigiSeed->SetDefaultValue(0);
+	DigiSeed->SetRange("DigiSeed >= 0");
+	DigiSeed->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+	BenchmarkDarkNoise = new G4UIcmdWithAnInteger("/WCSim/BenchmarkDarkNoise", this);
+	BenchmarkDarkNoise->SetGuidance("Print the time per event taken to add dark noise over one gate for a range of rates");
+	BenchmarkDarkNoise->SetParameterName("nEvents", true);
+	BenchmarkDarkNoise->SetDefaultValue(1000);
+	BenchmarkDarkNoise->AvailableForStates(G4State_Idle);
+
+	TriggerType = new G4UIcmdWithAString("/WCSim/TriggerType", this);
+	TriggerType->SetGuidance("Set the trigger used to find the event gates");
+	TriggerType->SetGuidance(
+		"Available options are:\
+          \n gap (chain of PMT first hits with no gap longer than the window - default)\
+          \n nhits (PMT first hits inside a sliding window)\
+          \n ndigits (every photoelectron inside a sliding window)");
+	TriggerType->SetParameterName("TriggerType", true);
+	TriggerType->SetDefaultValue("gap");
+	TriggerType->SetCandidates("gap nhits ndigits");
+	TriggerType->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+	TriggerThreshold = new G4UIcmdWithAnInteger("/WCSim/TriggerThreshold", this);
+	TriggerThreshold->SetGuidance("Number of hits needed to trigger, the default is 25");
+	TriggerThreshold->SetParameterName("TriggerThreshold", true);
+	TriggerThreshold->SetDefaultValue(25);
+	TriggerThreshold->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+	TriggerWindow = new G4UIcmdWithADouble("/WCSim/TriggerWindow", this);
+	TriggerWindow->SetGuidance("Trigger window in ns, the default is 200\n"
+							   " - gap: the longest gap allowed between hits\n"
+							   " - nhits/ndigits: the length of the sliding window\n");
+	TriggerWindow->SetParameterName("TriggerWindow", true);
+	TriggerWindow->SetDefaultValue(200.0);
+	TriggerWindow->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+	TriggerVerbose = new G4UIcmdWithABool("/WCSim/TriggerVerbose", this);
+	TriggerVerbose->SetGuidance("Bool to print the trigger times of every event\n"
+								" - The default value is false.\n");
+	TriggerVerbose->SetParameterName("TriggerVerbose", true);
+	TriggerVerbose->SetDefaultValue(false);
+
+	ValidateSK1peSampler = new G4UIcmdWithAnInteger("/WCSim/ValidateSK1peSampler", this);
+	ValidateSK1peSampler->SetGuidance("Print the chi-square between the SuperK 1pe samplers for a number of draws\n"
+									  " - Guide table against the original linear search\n"
+									  " - Gaussian approximation against the summed spectrum\n");
+	ValidateSK1peSampler->SetParameterName("nSamples", true);
+	ValidateSK1peSampler->SetDefaultValue(1000000);
+	ValidateSK1peSampler->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+	ValidateTubeLookup = new G4UIcmdWithABool("/WCSim/ValidateTubeLookup", this);
+	ValidateTubeLookup->SetGuidance("Bool to check the integer PMT lookup against the tube tag strings\n"
+									" - Prints mismatches and the time per lookup of both methods\n"
+									" - The default value is false.\n");
+	ValidateTubeLookup->SetParameterName("ValidateTubeLookup", true); // Omittable, default to false
+	ValidateTubeLookup->SetDefaultValue(false);
+
+	BenchmarkPMTQE = new G4UIcmdWithAnInteger("/WCSim/BenchmarkPMTQE", this);
+	BenchmarkPMTQE->SetGuidance("Print the calls/s of the old and tabulated PMT QE for a number of random wavelengths");
+	BenchmarkPMTQE->SetParameterName("nCalls", true);
+	BenchmarkPMTQE->SetDefaultValue(10000000);
+	BenchmarkPMTQE->AvailableForStates(G4State_Idle);
+
+	BenchmarkPMTCharge = new G4UIcmdWithAnInteger("/WCSim/BenchmarkPMTCharge", this);
+	BenchmarkPMTCharge->SetGuidance("Compare the CHIPS PMT charge calculated tube by tube and for a whole gate at once\n"
+									" - The parameter is the number of hit tubes in the gate\n"
+									" - Prints the tubes/s and the charge/pe mean and RMS of both methods\n");
+	BenchmarkPMTCharge->SetParameterName("nTubes", true);
+	BenchmarkPMTCharge->SetDefaultValue(5000);
+	BenchmarkPMTCharge->AvailableForStates(G4State_PreInit, G4State_Idle);
+
 	WCConstruct = new G4UIcmdWithoutParameter("/WCSim/Construct", this);
 	WCConstruct->SetGuidance("Update detector construction with new settings.");
 }
@@ -93,6 +190,18 @@ WCSimDetectorMessenger::~WCSimDetectorMessenger()
 	delete PMTSim;
 	delete PMTTime;
 	delete PMTPerfectTiming;
+	delete PMTGaussianThreshold;
+	delete PMTDarkRate;
+	delete DigiSeed;
+	delete BenchmarkDarkNoise;
+	delete TriggerType;
+	delete TriggerThreshold;
+	delete TriggerWindow;
+	delete TriggerVerbose;
+	delete ValidateSK1peSampler;
+	delete ValidateTubeLookup;
+	delete BenchmarkPMTQE;
+	delete BenchmarkPMTCharge;
 	delete tubeCmd;
 	delete distortionCmd;
 	delete WCSimDir;
@@ -308,4 +417,55 @@ void WCSimDetectorMessenger::SetNewValue(G4UIcommand *command, G4String newValue
 		}
 		WCSimDetector->SetPMTPerfectTiming(val);
 	}
+	if (command == ValidateTubeLookup)
+	{
+		WCSimDetector->SetValidateTubeLookup(ValidateTubeLookup->GetNewBoolValue(newValue));
+	}
+	if (command == BenchmarkPMTQE)
+	{
+		WCSimDetector->BenchmarkPMTQE(BenchmarkPMTQE->GetNewIntValue(newValue));
+	}
+	if (command == PMTGaussianThreshold)
+	{
+		WCSimDetector->SetPMTGaussianThreshold(PMTGaussianThreshold->GetNewIntValue(newValue));
+	}
+	if (command == PMTDarkRate)
+	{
+		WCSimDetector->SetPMTDarkRate(PMTDarkRate->GetNewDoubleValue(newValue));
+	}
+	if (command == DigiSeed)
+	{
+		WCSimDetector->SetDigiSeed(DigiSeed->GetNewIntValue(newValue));
+	}
+	if (command == BenchmarkDarkNoise)
+	{
+		WCSimDarkNoise noise(WCSimDetector);
+		noise.Benchmark(BenchmarkDarkNoise->GetNewIntValue(newValue));
+	}
+	if (command == TriggerType)
+	{
+		WCSimDetector->SetTriggerType(newValue);
+	}
+	if (command == TriggerThreshold)
+	{
+		WCSimDetector->SetTriggerThreshold(TriggerThreshold->GetNewIntValue(newValue));
+	}
+	if (command == TriggerWindow)
+	{
+		WCSimDetector->SetTriggerWindow(TriggerWindow->GetNewDoubleValue(newValue));
+	}
+	if (command == TriggerVerbose)
+	{
+		WCSimDetector->SetTriggerVerbose(TriggerVerbose->GetNewBoolValue(newValue));
+	}
+	if (command == ValidateSK1peSampler)
+	{
+		WCSimSK1pePMT pmt;
+		pmt.ValidateSampler(ValidateSK1peSampler->GetNewIntValue(newValue));
+	}
+	if (command == BenchmarkPMTCharge)
+	{
+		WCSimCHIPSPMT pmt;
+		pmt.BenchmarkCharge(BenchmarkPMTCharge->GetNewIntValue(newValue), 100);
+	}
 }
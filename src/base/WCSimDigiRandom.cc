@@ -0,0 +1,28 @@
+#include "WCSimDigiRandom.hh"
+
+UInt_t WCSimDigiRandom::GetEventSeed(ULong64_t baseSeed, Int_t run, Int_t event)
+{
+	ULong64_t key = Mix(baseSeed);
+	key = Mix(key ^ static_cast<UInt_t>(run));
+	key = Mix(key ^ static_cast<UInt_t>(event));
+	return Fold(key);
+}
+
+UInt_t WCSimDigiRandom::GetStreamSeed(UInt_t eventSeed, Stream stream)
+{
+	return Fold(Mix((static_cast<ULong64_t>(eventSeed) << 32) | static_cast<UInt_t>(stream)));
+}
+
+ULong64_t WCSimDigiRandom::Mix(ULong64_t x)
+{
+	x += 0x9e3779b97f4a7c15ULL;
+	x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+	return x ^ (x >> 31);
+}
+
+UInt_t WCSimDigiRandom::Fold(ULong64_t x)
+{
+	UInt_t seed = static_cast<UInt_t>(x ^ (x >> 32));
+	return (seed != 0) ? seed : 1;
+}
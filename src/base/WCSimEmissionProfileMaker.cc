@@ -5,11 +5,11 @@
  *      Author: ajperch
  */
 
-#include "G4TrajectoryContainer.hh"
+#include "G4Track.hh"
+#include "G4VProcess.hh"
 #include "globals.hh"
 
 #include "WCSimEmissionProfileMaker.hh"
-#include "WCSimTrajectory.hh"
 #include "WCSimTruthSummary.hh"
 #include "CLHEP/Units/SystemOfUnits.h"
 
@@ -20,16 +20,18 @@
 #include "TFile.h"
 
 #include <cassert>
-#include <numeric>
-#include <vector>
+#include <cstdlib>
 
-static WCSimEmissionProfileMaker *fgEmissionProfile = 0x0;
+// One profile maker per thread, each writing its own file
+static G4ThreadLocal WCSimEmissionProfileMaker *fgEmissionProfile = 0x0;
 
 WCSimEmissionProfileMaker::WCSimEmissionProfileMaker(G4String filename) : fRho(0x0), fGFine(0x0), fGCoarse(0x0)
 {
 	// TODO Auto-generated constructor stub
 	fNumEvents = 0;
 	fNumPhotons = 0;
+	fPDG = 0;
+	fEnergy = 0;
 	fPhotonTree = 0x0;
 
 	fSaveFile = 0x0;
@@ -150,80 +152,79 @@ void WCSimEmissionProfileMaker::CloseFile()
 	return;
 }
 
-void WCSimEmissionProfileMaker::Fill(G4TrajectoryContainer *trajCont, WCSimTruthSummary *truth)
+void WCSimEmissionProfileMaker::BeginEvent(const WCSimTruthSummary &truth)
 {
-	WCSimEmissionProfileMaker::Instance()->FillEvent(trajCont, truth);
+	WCSimEmissionProfileMaker::Instance()->StartEvent(truth);
 }
 
-void WCSimEmissionProfileMaker::FillEvent(G4TrajectoryContainer *trajCont, WCSimTruthSummary *truth)
+void WCSimEmissionProfileMaker::AddPhoton(const G4Track *track)
 {
-	std::cout << "Filling event " << fNumEvents << std::endl;
-	fNumPhotons = 0;
-	const float mm_to_cm = 0.1;
-	int nTraj = trajCont->size();
-	int primaryPDG = truth->GetBeamPDG();
-	TVector3 primaryDir = truth->GetBeamDir().Unit();
-	TVector3 primaryVtx = truth->GetVertex() * mm_to_cm;
-
-	fPhotonDirections.clear();
-	fPhotonVertices.clear();
-	for (int i = 0; i < nTraj; ++i)
-	{
-		WCSimTrajectory *trj = (WCSimTrajectory *)((*trajCont)[i]);
+	WCSimEmissionProfileMaker::Instance()->FillPhoton(track);
+}
 
-		// We only want optical photons and if the primary particle was a muon we want them to have the muon as their parent
-		if (trj->IsOpticalPhoton() && !trj->IsScatteredPhoton() && (abs(primaryPDG) != 13 || trj->GetParentID() == 1))
-		{
-			fPhotonDirections.push_back(TVector3(trj->GetVtxDirX(), trj->GetVtxDirY(), trj->GetVtxDirZ()));
-			fPhotonVertices.push_back(TVector3(trj->GetVtxX(), trj->GetVtxY(), trj->GetVtxZ()) * (mm_to_cm));
+void WCSimEmissionProfileMaker::EndEvent()
+{
+	WCSimEmissionProfileMaker::Instance()->FinishEvent();
+}
 
-			double scale = (CLHEP::joule / CLHEP::MeV) * (CLHEP::nm / CLHEP::m) * (1.0 / (CLHEP::h_Planck * CLHEP::c_light));
-			float wavelength = ((CLHEP::h_Planck * CLHEP::c_light) / (trj->GetEnergy())) / CLHEP::nm;
-			fWavelengths->Fill(wavelength);
-		}
+void WCSimEmissionProfileMaker::StartEvent(const WCSimTruthSummary &truth)
+{
+	const float mm_to_cm = 0.1;
+	fNumPhotons = 0;
+	fPDG = truth.GetBeamPDG();
+	fEnergy = truth.GetBeamEnergy();
+	fPrimaryDir = truth.GetBeamDir().Unit();
+	fPrimaryVtx = truth.GetVertex() * mm_to_cm;
+}
+
+void WCSimEmissionProfileMaker::FillPhoton(const G4Track *track)
+{
+	// We only want optical photons that haven't come from another optical photon, and if the
+	// primary particle was a muon we want them to have the muon as their parent
+	const G4VProcess *creator = track->GetCreatorProcess();
+	if ((creator != 0x0 && creator->GetProcessType() == 3) || (abs(fPDG) == 13 && track->GetParentID() != 1))
+	{
+		return;
 	}
 
-	TVector3 meanDirection = AverageVector(fPhotonVertices).Unit();
+	const float mm_to_cm = 0.1;
+	const G4ThreeVector &pos = track->GetPosition();
+	const G4ThreeVector &dir = track->GetMomentumDirection();
+	TVector3 vtx = TVector3(pos.x(), pos.y(), pos.z()) * mm_to_cm;
 
-	// Now loop through and fill the histograms
-	assert(fPhotonDirections.size() == fPhotonVertices.size());
-	std::vector<TVector3>::const_iterator vtxItr = fPhotonVertices.begin();
-	std::vector<TVector3>::const_iterator dirItr = fPhotonDirections.begin();
-	while (vtxItr != fPhotonVertices.end() && dirItr != fPhotonDirections.end())
-	{
-		float distance = (*vtxItr).Z();
-		float cosDirection = TMath::Cos((*dirItr).Angle(meanDirection));
+	// Distance along the primary from its vertex, and the photon angle to the primary
+	float distance = (vtx - fPrimaryVtx).Dot(fPrimaryDir);
+	float cosDirection = TVector3(dir.x(), dir.y(), dir.z()).Dot(fPrimaryDir);
 
-		fS->Fill(distance);
-		if (cosDirection < fSCosThetaFine->GetXaxis()->GetXmin())
-		{
-			fSCosThetaCoarse->Fill(cosDirection, distance);
-		}
-		else
-		{
-			fSCosThetaFine->Fill(cosDirection, distance);
-		}
+	float wavelength = ((CLHEP::h_Planck * CLHEP::c_light) / (track->GetTotalEnergy())) / CLHEP::nm;
+	fWavelengths->Fill(wavelength);
 
-		if (fabs(cosDirection) > 0.01)
-		{
-			double secTheta = 1.0 / cosDirection;
-			if (secTheta > 100 || secTheta < -100)
-			{
-				std::cout << "cosDirection = " << cosDirection << " and secTheta = " << secTheta << std::endl;
-			}
-			fSSecTheta->Fill(1.0 / cosDirection, distance);
-			fSCosThetaCheckBinning->Fill(cosDirection, distance);
-		}
-		else
-		{
-			fSSecTheta->Fill(fSSecTheta->GetXaxis()->GetXmax() + 1, distance);
-			fSCosThetaCheckBinning->Fill(2, distance);
-		}
+	fS->Fill(distance);
+	if (cosDirection < fSCosThetaFine->GetXaxis()->GetXmin())
+	{
+		fSCosThetaCoarse->Fill(cosDirection, distance);
+	}
+	else
+	{
+		fSCosThetaFine->Fill(cosDirection, distance);
+	}
 
-		++vtxItr;
-		++dirItr;
-		fNumPhotons++;
+	if (fabs(cosDirection) > 0.01)
+	{
+		fSSecTheta->Fill(1.0 / cosDirection, distance);
+		fSCosThetaCheckBinning->Fill(cosDirection, distance);
 	}
+	else
+	{
+		fSSecTheta->Fill(fSSecTheta->GetXaxis()->GetXmax() + 1, distance);
+		fSCosThetaCheckBinning->Fill(2, distance);
+	}
+	fNumPhotons++;
+}
+
+void WCSimEmissionProfileMaker::FinishEvent()
+{
+	std::cout << "Filled event " << fNumEvents << " with " << fNumPhotons << " photons" << std::endl;
 	fNumEvents++;
 }
 
@@ -325,17 +326,6 @@ void WCSimEmissionProfileMaker::MakeHistograms()
 									  fSMin, fSMax);
 }
 
-template <class T>
-T WCSimEmissionProfileMaker::AverageVector(const std::vector<T> &vec)
-{
-	if (vec.size() == 0)
-	{
-		return T();
-	}
-	T total = std::accumulate(vec.begin(), vec.end(), T());
-	return total * (1.0 / vec.size());
-}
-
 void WCSimEmissionProfileMaker::SmoothRho()
 {
 	fS->Smooth(1);
@@ -2,6 +2,7 @@
 #include <string>
 #include <sstream>
 #include <cstdlib>
+#include <algorithm>
 //#include <TGClient.h>
 #include <TROOT.h>
 #include <TStyle.h>
@@ -48,16 +49,10 @@ ClassImp(WCSimEvDisplay)
 WCSimEvDisplay::WCSimEvDisplay(const TGWindow *p, UInt_t w, UInt_t h) : TGMainFrame(p, w, h)
 {
 
-	// Initialise some histogram pointers
-	fBarrelHist = 0x0;
-	fTopHist = 0x0;
-	fBottomHist = 0x0;
-	fChargeHist = 0x0;
-	fTimeHist = 0x0;
-
 	// Initialise the TChain pointers
 	fChain = 0x0;
 	fGeomTree = 0x0;
+	fWCSimEvent = 0x0;
 
 	// Initialise the truth object
 	fTruthSummary = 0x0;
@@ -72,22 +67,6 @@ WCSimEvDisplay::WCSimEvDisplay(const TGWindow *p, UInt_t w, UInt_t h) : TGMainFr
 	// Initialise the TGNumberEntry
 	fEventInput = 0x0;
 	fPEInput = 0x0;
-	fChargeCut = 0;
-
-	fLogZCharge = false;
-
-	// Create the TGraph vectors with default TGraphs
-	this->MakeGraphColours();
-	for (unsigned int g = 0; g < fColours.size(); ++g)
-	{
-		fTopGraphs.push_back(new TGraph());
-		fBarrelGraphs.push_back(new TGraph());
-		fBottomGraphs.push_back(new TGraph());
-		// Initialise the graphs
-		this->InitialiseGraph(fTopGraphs[g], g);
-		this->InitialiseGraph(fBarrelGraphs[g], g);
-		this->InitialiseGraph(fBottomGraphs[g], g);
-	}
 
 	// Set up some plot style
 	this->SetStyle();
@@ -152,8 +131,6 @@ WCSimEvDisplay::WCSimEvDisplay(const TGWindow *p, UInt_t w, UInt_t h) : TGMainFr
 	fCurrentEvent = 0;
 	fFileType = -1;
 	this->HideFrame(hWCSimButtons);
-	fViewType = 0; // Look at charge by default
-	fViewVeto = 0; // Don't look at veto by default
 
 	// By default show the 1D plots
 	fShow1DHists = 1;
@@ -252,19 +229,10 @@ void WCSimEvDisplay::FillPlotsFromWCSimEvent()
 	// First things first, clear the histograms.
 	this->ClearPlots();
 
-	// Need to load the events.
-	WCSimRootEvent *wcSimEvt = new WCSimRootEvent();
-	fChain->SetBranchAddress("wcsimrootevent", &wcSimEvt);
-	// Force deletion to prevent memory leak
-	fChain->GetBranch("wcsimrootevent")->SetAutoDelete(kTRUE);
-
-	// Get the geometry
-	WCSimRootGeom *geo = new WCSimRootGeom();
-	fGeomTree->SetBranchAddress("wcsimrootgeom", &geo);
-	fGeomTree->GetEntry(0);
-
-	// Get the current event;
+	// Get the current event. The branch address and the geometry cache were
+	// set up when the file was opened, so only the event branch is read here.
 	fChain->GetEntry(fCurrentEvent);
+	WCSimRootEvent *wcSimEvt = fWCSimEvent;
 	if (wcSimEvt == 0x0)
 		std::cout << "Null pointer :( " << std::endl;
 
@@ -305,140 +273,15 @@ void WCSimEvDisplay::FillPlotsFromWCSimEvent()
 		int nDigiHits = wcSimTrigger->GetNcherenkovdigihits();
 		std::cout << "Number of PMTs hit: " << nDigiHits << std::endl;
 
-		// Need to loop through the hits once to find the charge and time ranges
-		fQMin = 1e10;
-		fQMax = -1e10;
-		fTMin = 1e10;
-		fTMax = -1e10;
-		for (int i = 0; i < nDigiHits; ++i)
-		{
-			TObject *element = (wcSimTrigger->GetCherenkovDigiHits())->At(i);
-			WCSimRootCherenkovDigiHit *hit = dynamic_cast<WCSimRootCherenkovDigiHit *>(element);
-			if (fViewVeto)
-			{
-				if (geo->GetPMTFromTubeID(hit->GetTubeId()).GetCylLoc() != 3)
-					continue;
-			}
-			else
-			{
-				if (geo->GetPMTFromTubeID(hit->GetTubeId()).GetCylLoc() == 3)
-					continue;
-			}
-			double q = hit->GetQ();
-			double t = hit->GetT();
-			if (q < fQMin)
-				fQMin = q;
-			if (q > fQMax)
-				fQMax = q;
-			if (t < fTMin)
-				fTMin = t;
-			if (t > fTMax)
-				fTMax = t;
-		}
-		// For now, always want charge to start at 0.
-		fQMin = 0;
-		this->CalculateChargeAndTimeBins();
+		// Take the graphs off the pads before the hit maps refill them
 		this->ResetGraphs();
-
-		// Now loop through again and fill things
-		for (int i = 0; i < nDigiHits; i++)
-		{
-			// Loop through elements in the TClonesArray of WCSimRootCherenkovDigHits
-			TObject *element = (wcSimTrigger->GetCherenkovDigiHits())->At(i);
-
-			WCSimRootCherenkovDigiHit *wcSimDigiHit = dynamic_cast<WCSimRootCherenkovDigiHit *>(element);
-
-			WCSimRootPMT pmt = geo->GetPMTFromTubeID(wcSimDigiHit->GetTubeId());
-			if (fViewVeto)
-			{
-				if (geo->GetPMTFromTubeID(wcSimDigiHit->GetTubeId()).GetCylLoc() != 3)
-					continue;
-			}
-			else
-			{
-				if (geo->GetPMTFromTubeID(wcSimDigiHit->GetTubeId()).GetCylLoc() == 3)
-					continue;
-			}
-
-			double pmtX = pmt.GetPosition(0) * 0.01; // convert to m
-			double pmtY = pmt.GetPosition(1) * 0.01; // convert to m
-			double pmtZ = pmt.GetPosition(2) * 0.01; // convert to m
-			double pmtPhi = TMath::ATan2(pmtY, pmtX);
-			double pmtQ = wcSimDigiHit->GetQ();
-			double pmtT = wcSimDigiHit->GetT();
-
-			fBarrelHist->GetZaxis()->SetTitle("Charge (p.e.)");
-			fTopHist->GetZaxis()->SetTitle("Charge (p.e.)");
-			fBottomHist->GetZaxis()->SetTitle("Charge (p.e.)");
-			if (fViewType == 1)
-			{
-				fBarrelHist->GetZaxis()->SetTitle("Time (ns)");
-				fTopHist->GetZaxis()->SetTitle("Time (ns)");
-				fBottomHist->GetZaxis()->SetTitle("Time (ns)");
-			}
-
-			// Make sure we pass the charge cut
-			if (pmtQ > fChargeCut)
-			{
-				unsigned int bin;
-				if (fViewType == 0)
-					bin = this->GetChargeBin(pmtQ);
-				else
-					bin = this->GetTimeBin(pmtT);
-
-				// Set the underflow bin of the histograms to make sure the colour axis shows
-				fTopHist->SetBinContent(0, 1);
-				fBarrelHist->SetBinContent(0, 1);
-				fBottomHist->SetBinContent(0, 1);
-
-				// Top cap
-				if (pmt.GetCylLoc() == 0)
-				{
-					fTopGraphs[bin]->SetPoint(fTopGraphs[bin]->GetN(), pmtY, pmtX);
-				}
-				// Bottom cap
-				else if (pmt.GetCylLoc() == 2)
-				{
-					fBottomGraphs[bin]->SetPoint(fBottomGraphs[bin]->GetN(), pmtY, pmtX);
-				}
-				// Barrel
-				else if (pmt.GetCylLoc() == 1)
-				{
-					fBarrelGraphs[bin]->SetPoint(fBarrelGraphs[bin]->GetN(), pmtPhi, pmtZ);
-				}
-				// Otherwise these are veto PMTs. Don't display, but say stuff for now.
-				else
-				{
-					//        std::cout << "Veto PMT hit: " <<  pmtX << ", " << pmtY << ", " << pmtZ << " :: " << pmtPhi << ", " << pmtQ << ", " << pmtT << std::endl;
-					if (pmt.GetOrientation(2) > 0.99)
-					{
-						fTopGraphs[bin]->SetPoint(fTopGraphs[bin]->GetN(), pmtY, pmtX);
-					}
-					else if (pmt.GetOrientation(2) < -0.99)
-					{
-						fBottomGraphs[bin]->SetPoint(fBottomGraphs[bin]->GetN(), pmtY, pmtX);
-					}
-					else
-					{
-						fBarrelGraphs[bin]->SetPoint(fBarrelGraphs[bin]->GetN(), pmtPhi, pmtZ);
-					}
-				}
-
-				// Now fill the 1D histograms
-				fChargeHist->Fill(pmtQ);
-				fTimeHist->Fill(pmtT);
-			}
-
-		} // End of loop over Cherenkov digihits
+		this->FillHitMaps(wcSimTrigger);
 	}
 	else
 	{
 		std::cout << "NO HITS SKIP THE EVENT!!!" << std::endl;
 	}
 
-	delete geo;
-	geo = 0x0;
-
 	// Update the pads
 	this->UpdateRecoPads();
 	this->UpdateTruthPad();
@@ -447,102 +290,6 @@ void WCSimEvDisplay::FillPlotsFromWCSimEvent()
 	this->UpdateCanvases();
 }
 
-void WCSimEvDisplay::InitialiseGraph(TGraph *g, int i)
-{
-
-	g->SetMarkerColor(fColours.at(i));
-	g->SetMarkerStyle(7);
-	g->SetEditable(0);
-}
-
-// Series of functions to take care of the TGraphs
-void WCSimEvDisplay::CalculateChargeAndTimeBins()
-{
-	// Firstly, clear the existing vectors
-	fChargeBins.clear();
-	fTimeBins.clear();
-
-	// In order to prevent massive hits causing a problem, have a dummy max of 100pe.
-	double dummyMax = 100.;
-	if (fQMax < dummyMax)
-		dummyMax = fQMax;
-
-	double deltaQ = 0;
-	if (!fLogZCharge)
-	{
-		deltaQ = (dummyMax - fQMin) / static_cast<Double_t>(fColours.size());
-	}
-	else
-	{
-		deltaQ = TMath::Log10(dummyMax - fQMin) / static_cast<Double_t>(fColours.size());
-	}
-	double deltaT = (fTMax - fTMin) / static_cast<Double_t>(fColours.size());
-
-	for (size_t i = 0; i < fColours.size(); ++i)
-	{
-		if (!fLogZCharge)
-		{
-			fChargeBins.push_back(fQMin + i * deltaQ);
-		}
-		else
-		{
-			fChargeBins.push_back(fQMin + pow(10, i * deltaQ));
-		}
-		fTimeBins.push_back(fTMin + i * deltaT);
-	}
-}
-
-unsigned int WCSimEvDisplay::GetChargeBin(double charge) const
-{
-	unsigned int bin = fChargeBins.size() - 1;
-	for (unsigned int i = 1; i < fChargeBins.size(); ++i)
-	{
-		if (charge < fChargeBins[i])
-		{
-			bin = i - 1;
-			break;
-		}
-	}
-	return bin;
-}
-
-unsigned int WCSimEvDisplay::GetTimeBin(double time) const
-{
-	unsigned int bin = fTimeBins.size() - 1;
-	for (unsigned int i = 0; i < fTimeBins.size(); ++i)
-	{
-		if (time < fTimeBins.at(i))
-		{
-			bin = i - 1;
-			break;
-		}
-	}
-	return bin;
-}
-
-void WCSimEvDisplay::MakeGraphColours()
-{
-
-	// Black Body palette
-	const Int_t nRGBs = 9;
-	const Int_t nContours = 100;
-	Double_t stops[nRGBs] = {0.0000, 0.1250, 0.2500, 0.3750, 0.5000, 0.6250, 0.7500, 0.8750, 1.0000};
-	Double_t red[nRGBs] = {33. / 255., 31. / 255., 42. / 255., 68. / 255., 86. / 255., 111. / 255., 141. / 255., 172. / 255., 227. / 255.};
-	Double_t green[nRGBs] = {255. / 255., 175. / 255., 145. / 255., 106. / 255., 88. / 255., 55. / 255., 15. / 255., 0. / 255., 0. / 255.};
-	Double_t blue[nRGBs] = {255. / 255., 205. / 255., 202. / 255., 203. / 255., 208. / 255., 205. / 255., 203. / 255.,
-							206. / 255., 231. / 255.};
-	Int_t startColour = TColor::CreateGradientColorTable(nRGBs, stops, red, green, blue, nContours);
-
-	// Make a palette
-	fColours.clear();
-	for (int i = 0; i < nContours; ++i)
-	{
-		fColours.push_back(startColour + i);
-	}
-
-	gStyle->SetNumberContours(nContours);
-}
-
 void WCSimEvDisplay::ResetGraphs()
 {
 
@@ -565,23 +312,10 @@ void WCSimEvDisplay::ResetGraphs()
 		{
 			listBottom->Remove(fBottomGraphs[i]);
 		}
-
-		// Now reset the plots
-		fTopGraphs[i]->Set(0);
-		fBottomGraphs[i]->Set(0);
-		fBarrelGraphs[i]->Set(0);
 	}
-}
 
-void WCSimEvDisplay::DrawHitGraphs(std::vector<TGraph *> vec)
-{
-	for (unsigned int i = 0; i < vec.size(); ++i)
-	{
-		if (vec[i]->GetN() > 0)
-		{
-			vec[i]->Draw("P");
-		}
-	}
+	// Now reset the plots
+	this->ClearGraphs();
 }
 
 // Switch to the veto view
@@ -669,105 +403,6 @@ void WCSimEvDisplay::Toggle1DHists()
 	}
 	this->ResizePads();
 }
-void WCSimEvDisplay::ClearPlots()
-{
-
-	fBarrelHist->Reset();
-	fTopHist->Reset();
-	fBottomHist->Reset();
-	fChargeHist->Reset();
-	fTimeHist->Reset();
-}
-
-void WCSimEvDisplay::MakePlotsPretty(TH1 *h)
-{
-
-	h->GetXaxis()->CenterTitle();
-	h->GetYaxis()->CenterTitle();
-	h->GetZaxis()->CenterTitle();
-	h->GetXaxis()->SetTitleSize(0.05);
-	h->GetYaxis()->SetTitleSize(0.05);
-	h->GetZaxis()->SetTitleSize(0.05);
-	h->GetXaxis()->SetLabelSize(0.05);
-	h->GetYaxis()->SetLabelSize(0.05);
-	h->GetZaxis()->SetLabelSize(0.05);
-	h->GetXaxis()->SetNdivisions(507);
-	h->GetYaxis()->SetNdivisions(507);
-}
-
-void WCSimEvDisplay::AdjustBarrelZAxis()
-{
-
-	TPaletteAxis *zAxis = 0x0;
-	zAxis = (TPaletteAxis *)(fBarrelHist->GetListOfFunctions()->FindObject("palette"));
-	if (zAxis != 0x0)
-	{
-		zAxis->SetX1NDC(0.927);
-		zAxis->SetX2NDC(0.950);
-		zAxis->SetTitleOffset(0.52);
-		zAxis->GetAxis()->SetTickSize(0.015);
-	}
-
-	// Also adjust the bottom plot label
-	zAxis = 0x0;
-	zAxis = (TPaletteAxis *)(fBottomHist->GetListOfFunctions()->FindObject("palette"));
-	if (zAxis != 0x0)
-	{
-		zAxis->GetAxis()->SetTitleOffset(1.03);
-		zAxis->GetAxis()->SetLabelOffset(0.012);
-	}
-}
-
-// Function mostly to account for the offset in the time origin. In
-// WCSim this offset is around 950ns.
-void WCSimEvDisplay::GetMinColourAxis(TH2D *h)
-{
-	h->SetMinimum(0);
-	double min = 1e6;
-	// Find the minimum value that isn't zero
-	for (int x = 1; x <= h->GetNbinsX(); ++x)
-	{
-		for (int y = 1; y <= h->GetNbinsY(); ++y)
-		{
-			double temp = h->GetBinContent(x, y);
-			if (temp == 0.0)
-				continue;
-			if (temp < min)
-			{
-				min = temp;
-			}
-		}
-	}
-	// Only bother to change the z minumum if we aren't close to 0 anyway.
-	if (min > 100)
-	{
-		h->SetMinimum(0.95 * min);
-	}
-}
-
-void WCSimEvDisplay::SetPlotZAxes()
-{
-
-	double min = fQMin;
-	double max = fQMax;
-	if (max > 100)
-		max = 100;
-
-	if (fViewType == 1)
-	{
-		min = fTMin;
-		max = fTMax;
-	}
-
-	// Make sure the histogram max / min are correct
-	fBarrelHist->SetMaximum(max);
-	fBarrelHist->SetMinimum(min);
-	fTopHist->SetMaximum(max);
-	fTopHist->SetMinimum(min);
-	fBottomHist->SetMaximum(max);
-	fBottomHist->SetMinimum(min);
-}
-
 // Resize the pads when hiding / showing the 1D plots
 void WCSimEvDisplay::ResizePads()
 {
@@ -874,51 +509,7 @@ void WCSimEvDisplay::UpdateCanvases()
 // Draw the reco plots to the reco pads
 void WCSimEvDisplay::UpdateRecoPads()
 {
-
-	this->SetPlotZAxes();
-
-	// Set the styles how we want them
-	this->MakePlotsPretty(fBarrelHist);
-	this->MakePlotsPretty(fTopHist);
-	this->MakePlotsPretty(fBottomHist);
-	this->MakePlotsPretty(fChargeHist);
-	this->MakePlotsPretty(fTimeHist);
-
-	// Take the plots one by one and draw them.
-	fBarrelPad->cd();
-	fBarrelHist->Draw("colz");
-	fBarrelTitle->Draw();
-	this->DrawHitGraphs(fBarrelGraphs);
-	fBarrelPad->Modified();
-	fBarrelPad->Update();
-
-	fTopPad->cd();
-	//  fTopHist->Draw("colz");
-	fTopHist->Draw();
-	fTopTitle->Draw();
-	this->DrawHitGraphs(fTopGraphs);
-	fTopPad->Modified();
-	fTopPad->Update();
-
-	fBottomPad->cd();
-	fBottomHist->Draw("colz");
-	fBottomTitle->Draw();
-	this->DrawHitGraphs(fBottomGraphs);
-	fBottomPad->Modified();
-	fBottomPad->Update();
-
-	this->AdjustBarrelZAxis();
-
-	fChargePad->cd();
-	fChargeHist->Draw();
-	fChargePad->Modified();
-	fChargePad->Update();
-
-	fTimePad->cd();
-	fTimeHist->Draw();
-	fTimePad->Modified();
-	fTimePad->Update();
-
+	this->DrawHitMaps(fBarrelPad, fTopPad, fBottomPad, fChargePad, fTimePad);
 	fHitMapCanvas->GetCanvas()->cd();
 }
 
@@ -1170,6 +761,21 @@ void WCSimEvDisplay::OpenWCSimFile(std::string name)
 	fChain = new TChain("wcsimT");
 	fChain->Reset();
 	fChain->Add(name.c_str());
+	// Set the event branch up once for the whole file.
+	if (fWCSimEvent != 0x0)
+	{
+		delete fWCSimEvent;
+	}
+	fWCSimEvent = new WCSimRootEvent();
+	fChain->SetBranchAddress("wcsimrootevent", &fWCSimEvent);
+	// Force deletion to prevent memory leak
+	fChain->GetBranch("wcsimrootevent")->SetAutoDelete(kTRUE);
+	// Only the event branch is ever read, so let the tree cache fetch its baskets
+	// for the entries around the current one in a single read instead of one
+	// read per basket when stepping through the events.
+	fChain->SetCacheSize(10000000);
+	fChain->AddBranchToCache("wcsimrootevent", kTRUE);
+	fChain->StopCacheLearningPhase();
 	// Now the geometry
 	if (fGeomTree != 0x0)
 	{
@@ -1214,35 +820,6 @@ void WCSimEvDisplay::CloseWindow()
 	gApplication->Terminate(0);
 }
 
-void WCSimEvDisplay::SetStyle()
-{
-
-	gStyle->SetOptStat(0000);
-
-	// Make sure all backgrounds are white
-	gStyle->SetFillColor(10);
-	gStyle->SetFrameFillColor(10);
-	gStyle->SetCanvasColor(10);
-	gStyle->SetPadColor(10);
-	gStyle->SetTitleFillColor(10);
-	gStyle->SetStatColor(10);
-
-	// Use nice fonts
-	const int kMinosFont = 42;
-	//	const int kMinosFont = 40;
-
-	gStyle->SetStatFont(kMinosFont);
-	gStyle->SetLabelFont(kMinosFont, "xyz");
-	gStyle->SetTitleFont(kMinosFont, "xyz");
-	gStyle->SetTitleFont(kMinosFont, "");
-	gStyle->SetTextFont(kMinosFont);
-
-	gStyle->SetTitleFontSize(0.05);
-
-	//	gROOT->SetStyle("eds");
-	gROOT->ForceStyle();
-}
-
 void WCSimEvDisplay::ShowTruth()
 {
 
@@ -1712,17 +1289,6 @@ WCSimEvDisplay::~WCSimEvDisplay()
 {
 	// Clean up used widgets: frames, buttons, layouthints
 	this->Cleanup();
-
-	if (fBarrelHist)
-		delete fBarrelHist;
-	if (fTopHist)
-		delete fTopHist;
-	if (fBottomHist)
-		delete fBottomHist;
-	if (fChargeHist)
-		delete fChargeHist;
-	if (fTimeHist)
-		delete fTimeHist;
 }
 
 void WCSimEvDisplay::ResizePlotsFromGeometry()
@@ -1733,124 +1299,15 @@ void WCSimEvDisplay::ResizePlotsFromGeometry()
 	// Only a single entry
 	fGeomTree->GetEntry(0);
 
-	fWCRadius = geo->GetWCCylRadius();
-	fWCLength = geo->GetWCCylLength();
-	fPMTRadius = geo->GetWCPMTRadius();
-	std::cout << "== Geometry information: " << std::endl;
-	std::cout << "- Radius: " << fWCRadius << std::endl;
-	std::cout << "- Height: " << fWCLength << std::endl;
-	std::cout << "- NumPMT: " << geo->GetWCNumPMT() << std::endl;
-
-	// Count number of PMTs in each section.
-	fPMTTop = 0;
-	fPMTBarrel = 0;
-	fPMTBottom = 0;
-	fPMTVeto = 0;
-	for (int p = 0; p < geo->GetWCNumPMT(); ++p)
-	{
-		WCSimRootPMT pmt = geo->GetPMT(p);
-		if (pmt.GetCylLoc() == 0)
-		{
-			++fPMTTop;
-		}
-		else if (pmt.GetCylLoc() == 1)
-		{
-			++fPMTBarrel;
-		}
-		else if (pmt.GetCylLoc() == 2)
-		{
-			++fPMTBottom;
-		}
-		else
-		{
-			++fPMTVeto;
-		}
-	}
-
-	std::cout << "\t- Barrel : " << fPMTBarrel << std::endl;
-	std::cout << "\t- Top    : " << fPMTTop << std::endl;
-	std::cout << "\t- Bottom : " << fPMTBottom << std::endl;
-	std::cout << "\t- Veto : " << fPMTVeto << std::endl;
+	this->LoadGeometry(geo);
+	this->MakeHitHistograms();
 
-	// How many bins do we need?
-	// For x and y, round up sqrt of number of Top PMTs
-	int nBinsX = 1;
-	int nBinsY = 1;
-	int nBinsZ = 1;
-	int nBinsPhi = 1;
-
-	// Now with phi, sort the vector then make a variably binned array from it
-	double phiMin = TMath::Pi() * (-1);
-	double phiMax = TMath::Pi();
-
-	// Convert all distances from cm into m
-	double xMin = -geo->GetWCCylRadius() * 0.01;
-	double xMax = geo->GetWCCylRadius() * 0.01;
-	double yMin = -geo->GetWCCylRadius() * 0.01;
-	double yMax = geo->GetWCCylRadius() * 0.01;
-	double zMin = -0.5 * geo->GetWCCylLength() * 0.01;
-	double zMax = 0.5 * geo->GetWCCylLength() * 0.01;
-
-	if (fBarrelHist)
-	{
-		delete fBarrelHist;
-	}
-	fBarrelHist = new TH2D("barrelHist", ";#phi = atan(y/x);z (m)", nBinsPhi, phiMin, phiMax, nBinsZ, zMin, zMax);
-	fBarrelHist->SetDirectory(0);
-	fBarrelHist->GetYaxis()->SetTitleOffset(0.5);
-	fBarrelHist->GetYaxis()->SetTickLength(0.013);
-	if (fTopHist)
-	{
-		delete fTopHist;
-	}
-	fTopHist = new TH2D("topHist", ";y (m);x (m)", nBinsX, xMin, xMax, nBinsY, yMin, yMax);
-	fTopHist->SetDirectory(0);
-	if (fBottomHist)
-	{
-		delete fBottomHist;
-	}
-	fBottomHist = new TH2D("bottomHist", ";y (m);x (m)", nBinsX, xMin, xMax, nBinsY, yMin, yMax);
-	fBottomHist->SetDirectory(0);
-	if (fChargeHist)
-	{
-		delete fChargeHist;
-	}
-	fChargeHist = new TH1D("chargeHist", ";Charge (pe)", 100, 0, 25);
-	fChargeHist->SetDirectory(0);
-	if (fTimeHist)
-	{
-		delete fTimeHist;
-	}
-	fTimeHist = new TH1D("timeHist", ";Time (ns)", 100, 0, 10000);
-	fTimeHist->SetDirectory(0);
 	// Clean up.
+	fGeomTree->ResetBranchAddresses();
 	delete geo;
 	geo = 0x0;
 }
 
-void WCSimEvDisplay::MakeDefaultPlots()
-{
-	fBarrelHist = new TH2D("barrelHist", ";#phi = atan(y/x);z/cm", 1, 0, 1, 1, 0, 1);
-	fTopHist = new TH2D("topHist", ";y/cm;x/cm", 1, 0, 1, 1, 0, 1);
-	fBottomHist = new TH2D("BottomHist", ";y/cm;x/cm", 1, 0, 1, 1, 0, 1);
-	fChargeHist = new TH1D("chargeHist", ";Charge / PE", 1, 0, 1);
-	fTimeHist = new TH1D("timeHist", ";Time / ns", 1, 0, 1);
-
-	fBarrelTitle = new TText(0.465, 0.915, "Barrel");
-	fTopTitle = new TText(0.49, 0.915, "Top Cap");
-	fBottomTitle = new TText(0.35, 0.915, "Bottom Cap");
-	this->FormatTitles(fBarrelTitle);
-	this->FormatTitles(fTopTitle);
-	this->FormatTitles(fBottomTitle);
-}
-
-void WCSimEvDisplay::FormatTitles(TText *t)
-{
-	t->SetNDC();
-	t->SetTextFont(42);
-	t->SetTextSize(0.06);
-}
-
 // Draw the truth ring corresponding to primary particle number particleNo
 void WCSimEvDisplay::DrawTruthRing(unsigned int particleNo, int colour)
 {
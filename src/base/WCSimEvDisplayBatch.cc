@@ -0,0 +1,154 @@
+#include <iostream>
+#include <sstream>
+#include <TFile.h>
+#include <TTree.h>
+#include <TChain.h>
+#include <TCanvas.h>
+#include <TPad.h>
+#include <TH1D.h>
+#include <TH2D.h>
+#include "WCSimEvDisplayBatch.hh"
+#include "WCSimRootGeom.hh"
+#include "WCSimRootEvent.hh"
+
+WCSimEvDisplayBatch::WCSimEvDisplayBatch(int width, int height)
+{
+	fChain = 0x0;
+	fWCSimEvent = 0x0;
+
+	this->SetStyle();
+	this->MakeDefaultPlots();
+
+	// Same pads as the reco view of WCSimEvDisplay
+	fCanvas = new TCanvas("batchCanvas", "", width, height);
+	fCanvas->cd();
+	fBarrelPad = new TPad("fBarrelPad", "", 0.0, 0.6, 1.0, 1.0);
+	fTopPad = new TPad("fTopPad", "", 0.0, 0.2, 0.487, 0.6);
+	fBottomPad = new TPad("fBottomPad", "", 0.487, 0.2, 1.0, 0.6);
+	fChargePad = new TPad("fChargePad", "", 0.0, 0.0, 0.5, 0.2);
+	fTimePad = new TPad("fTimePad", "", 0.5, 0.0, 1.0, 0.2);
+	fBarrelPad->SetLeftMargin(0.05);
+	fBarrelPad->SetRightMargin(0.075);
+	fBarrelPad->SetBottomMargin(0.12);
+	fTopPad->SetRightMargin(0.0);
+	fTopPad->SetBottomMargin(0.12);
+	fBottomPad->SetLeftMargin(0.0);
+	fBottomPad->SetRightMargin(0.147);
+	fBottomPad->SetBottomMargin(0.12);
+	fBarrelPad->SetTicks(1, 1);
+	fTopPad->SetTicks(1, 1);
+	fBottomPad->SetTicks(1, 1);
+	fBarrelPad->Draw();
+	fTopPad->Draw();
+	fBottomPad->Draw();
+	fChargePad->Draw();
+	fTimePad->Draw();
+}
+
+WCSimEvDisplayBatch::~WCSimEvDisplayBatch()
+{
+	if (fChain != 0x0)
+	{
+		delete fChain;
+	}
+	if (fWCSimEvent != 0x0)
+	{
+		delete fWCSimEvent;
+	}
+	delete fCanvas;
+}
+
+bool WCSimEvDisplayBatch::OpenFile(const std::string &name)
+{
+	// Read the geometry once
+	TFile file(name.c_str(), "READ");
+	TTree *geomTree = (TTree *)file.Get("wcsimGeoT");
+	if (!file.Get("wcsimT") || !geomTree)
+	{
+		std::cout << name << " is not a WCSim file." << std::endl;
+		return false;
+	}
+	WCSimRootGeom *geo = new WCSimRootGeom();
+	geomTree->SetBranchAddress("wcsimrootgeom", &geo);
+	geomTree->GetEntry(0);
+	this->LoadGeometry(geo);
+	this->MakeHitHistograms();
+	geomTree->ResetBranchAddresses();
+	delete geo;
+	file.Close();
+
+	if (fChain != 0x0)
+	{
+		delete fChain;
+	}
+	fChain = new TChain("wcsimT");
+	fChain->Add(name.c_str());
+	if (fWCSimEvent != 0x0)
+	{
+		delete fWCSimEvent;
+	}
+	fWCSimEvent = new WCSimRootEvent();
+	fChain->SetBranchAddress("wcsimrootevent", &fWCSimEvent);
+	// Force deletion to prevent memory leak
+	fChain->GetBranch("wcsimrootevent")->SetAutoDelete(kTRUE);
+	fChain->SetCacheSize(10000000);
+	fChain->AddBranchToCache("wcsimrootevent", kTRUE);
+	fChain->StopCacheLearningPhase();
+	return true;
+}
+
+int WCSimEvDisplayBatch::GetNEvents() const
+{
+	return fChain ? fChain->GetEntries() : 0;
+}
+
+bool WCSimEvDisplayBatch::RenderEvent(int event, const std::string &prefix, const std::string &format)
+{
+	fChain->GetEntry(event);
+	WCSimRootTrigger *trigger = fWCSimEvent->GetTrigger(0);
+	if (trigger == 0x0 || trigger->GetNcherenkovdigihits() == 0)
+	{
+		return false;
+	}
+
+	std::stringstream name;
+	name << prefix << "_" << event;
+	this->SaveView(trigger, 0, name.str() + "_charge." + format);
+	this->SaveView(trigger, 1, name.str() + "_time." + format);
+	return true;
+}
+
+int WCSimEvDisplayBatch::RenderEvents(int first, int last, int worker, int nWorkers, const std::string &prefix,
+									  const std::string &format)
+{
+	int nRendered = 0;
+	for (int event = first + worker; event <= last; event += nWorkers)
+	{
+		if (this->RenderEvent(event, prefix, format))
+		{
+			++nRendered;
+		}
+	}
+	return nRendered;
+}
+
+void WCSimEvDisplayBatch::SaveView(WCSimRootTrigger *trigger, int viewType, const std::string &fileName)
+{
+	// The colour bins depend on the view, so fill the hit maps for each one
+	fViewType = viewType;
+	this->ClearPlots();
+	this->FillHitMaps(trigger);
+
+	// Nothing on the pads is owned by them, so this just takes the last event off
+	fBarrelPad->Clear();
+	fTopPad->Clear();
+	fBottomPad->Clear();
+	fChargePad->Clear();
+	fTimePad->Clear();
+	this->DrawHitMaps(fBarrelPad, fTopPad, fBottomPad, fChargePad, fTimePad);
+
+	fCanvas->cd();
+	fCanvas->Modified();
+	fCanvas->Update();
+	fCanvas->Print(fileName.c_str());
+}
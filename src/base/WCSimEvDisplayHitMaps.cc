@@ -0,0 +1,657 @@
+#include <algorithm>
+#include <iostream>
+#include <TROOT.h>
+#include <TStyle.h>
+#include <TMath.h>
+#include <TH1D.h>
+#include <TH2D.h>
+#include <TPad.h>
+#include <TList.h>
+#include <TText.h>
+#include <TGraph.h>
+#include <TColor.h>
+#include <TPaletteAxis.h>
+#include <TClonesArray.h>
+#include "WCSimEvDisplayHitMaps.hh"
+#include "WCSimRootGeom.hh"
+#include "WCSimRootEvent.hh"
+
+WCSimEvDisplayHitMaps::WCSimEvDisplayHitMaps()
+{
+	// Initialise some histogram pointers
+	fBarrelHist = 0x0;
+	fTopHist = 0x0;
+	fBottomHist = 0x0;
+	fChargeHist = 0x0;
+	fTimeHist = 0x0;
+	fBarrelTitle = 0x0;
+	fTopTitle = 0x0;
+	fBottomTitle = 0x0;
+
+	fViewType = 0;	   // Look at charge by default
+	fViewVeto = false; // Don't look at veto by default
+	fLogZCharge = false;
+	fChargeCut = 0;
+
+	fQMin = 0;
+	fQMax = 0;
+	fTMin = 0;
+	fTMax = 0;
+
+	fWCRadius = 0;
+	fWCLength = 0;
+	fPMTRadius = 0;
+	fPMTBarrel = 0;
+	fPMTTop = 0;
+	fPMTBottom = 0;
+	fPMTVeto = 0;
+
+	// Create the TGraph vectors with default TGraphs
+	this->MakeGraphColours();
+	for (unsigned int g = 0; g < fColours.size(); ++g)
+	{
+		fTopGraphs.push_back(new TGraph());
+		fBarrelGraphs.push_back(new TGraph());
+		fBottomGraphs.push_back(new TGraph());
+		// Initialise the graphs
+		this->InitialiseGraph(fTopGraphs[g], g);
+		this->InitialiseGraph(fBarrelGraphs[g], g);
+		this->InitialiseGraph(fBottomGraphs[g], g);
+	}
+}
+
+WCSimEvDisplayHitMaps::~WCSimEvDisplayHitMaps()
+{
+	if (fBarrelHist)
+		delete fBarrelHist;
+	if (fTopHist)
+		delete fTopHist;
+	if (fBottomHist)
+		delete fBottomHist;
+	if (fChargeHist)
+		delete fChargeHist;
+	if (fTimeHist)
+		delete fTimeHist;
+}
+
+void WCSimEvDisplayHitMaps::LoadGeometry(WCSimRootGeom *geo)
+{
+	fWCRadius = geo->GetWCCylRadius();
+	fWCLength = geo->GetWCCylLength();
+	fPMTRadius = geo->GetWCPMTRadius();
+	std::cout << "== Geometry information: " << std::endl;
+	std::cout << "- Radius: " << fWCRadius << std::endl;
+	std::cout << "- Height: " << fWCLength << std::endl;
+	std::cout << "- NumPMT: " << geo->GetWCNumPMT() << std::endl;
+
+	// Keep the PMT positions for the rest of the file
+	this->LoadGeometryCache(geo);
+
+	// Count number of PMTs in each section.
+	fPMTTop = 0;
+	fPMTBarrel = 0;
+	fPMTBottom = 0;
+	fPMTVeto = 0;
+	for (unsigned int p = 0; p < fPMTCylLoc.size(); ++p)
+	{
+		if (fPMTCylLoc[p] == 0)
+		{
+			++fPMTTop;
+		}
+		else if (fPMTCylLoc[p] == 1)
+		{
+			++fPMTBarrel;
+		}
+		else if (fPMTCylLoc[p] == 2)
+		{
+			++fPMTBottom;
+		}
+		else if (fPMTCylLoc[p] > 2)
+		{
+			++fPMTVeto;
+		}
+	}
+
+	std::cout << "\t- Barrel : " << fPMTBarrel << std::endl;
+	std::cout << "\t- Top    : " << fPMTTop << std::endl;
+	std::cout << "\t- Bottom : " << fPMTBottom << std::endl;
+	std::cout << "\t- Veto : " << fPMTVeto << std::endl;
+}
+
+void WCSimEvDisplayHitMaps::MakeHitHistograms()
+{
+	// How many bins do we need?
+	// For x and y, round up sqrt of number of Top PMTs
+	int nBinsX = 1;
+	int nBinsY = 1;
+	int nBinsZ = 1;
+	int nBinsPhi = 1;
+
+	// Now with phi, sort the vector then make a variably binned array from it
+	double phiMin = TMath::Pi() * (-1);
+	double phiMax = TMath::Pi();
+
+	// Convert all distances from cm into m
+	double xMin = -fWCRadius * 0.01;
+	double xMax = fWCRadius * 0.01;
+	double yMin = -fWCRadius * 0.01;
+	double yMax = fWCRadius * 0.01;
+	double zMin = -0.5 * fWCLength * 0.01;
+	double zMax = 0.5 * fWCLength * 0.01;
+
+	if (fBarrelHist)
+	{
+		delete fBarrelHist;
+	}
+	fBarrelHist = new TH2D("barrelHist", ";#phi = atan(y/x);z (m)", nBinsPhi, phiMin, phiMax, nBinsZ, zMin, zMax);
+	fBarrelHist->SetDirectory(0);
+	fBarrelHist->GetYaxis()->SetTitleOffset(0.5);
+	fBarrelHist->GetYaxis()->SetTickLength(0.013);
+	if (fTopHist)
+	{
+		delete fTopHist;
+	}
+	fTopHist = new TH2D("topHist", ";y (m);x (m)", nBinsX, xMin, xMax, nBinsY, yMin, yMax);
+	fTopHist->SetDirectory(0);
+	if (fBottomHist)
+	{
+		delete fBottomHist;
+	}
+	fBottomHist = new TH2D("bottomHist", ";y (m);x (m)", nBinsX, xMin, xMax, nBinsY, yMin, yMax);
+	fBottomHist->SetDirectory(0);
+	if (fChargeHist)
+	{
+		delete fChargeHist;
+	}
+	fChargeHist = new TH1D("chargeHist", ";Charge (pe)", 100, 0, 25);
+	fChargeHist->SetDirectory(0);
+	if (fTimeHist)
+	{
+		delete fTimeHist;
+	}
+	fTimeHist = new TH1D("timeHist", ";Time (ns)", 100, 0, 10000);
+	fTimeHist->SetDirectory(0);
+}
+
+int WCSimEvDisplayHitMaps::FillHitMaps(WCSimRootTrigger *wcSimTrigger)
+{
+	int nDigiHits = wcSimTrigger->GetNcherenkovdigihits();
+
+	// Need to loop through the hits once to find the charge and time ranges
+	fQMin = 1e10;
+	fQMax = -1e10;
+	fTMin = 1e10;
+	fTMax = -1e10;
+	for (int i = 0; i < nDigiHits; ++i)
+	{
+		TObject *element = (wcSimTrigger->GetCherenkovDigiHits())->At(i);
+		WCSimRootCherenkovDigiHit *hit = dynamic_cast<WCSimRootCherenkovDigiHit *>(element);
+		int p = this->GetPMTIndex(hit->GetTubeId());
+		if (p < 0 || (fPMTCylLoc[p] == 3) != fViewVeto)
+			continue;
+		double q = hit->GetQ();
+		double t = hit->GetT();
+		if (q < fQMin)
+			fQMin = q;
+		if (q > fQMax)
+			fQMax = q;
+		if (t < fTMin)
+			fTMin = t;
+		if (t > fTMax)
+			fTMax = t;
+	}
+	// For now, always want charge to start at 0.
+	fQMin = 0;
+	this->CalculateChargeAndTimeBins();
+	this->ClearGraphs();
+
+	fBarrelHist->GetZaxis()->SetTitle("Charge (p.e.)");
+	fTopHist->GetZaxis()->SetTitle("Charge (p.e.)");
+	fBottomHist->GetZaxis()->SetTitle("Charge (p.e.)");
+	if (fViewType == 1)
+	{
+		fBarrelHist->GetZaxis()->SetTitle("Time (ns)");
+		fTopHist->GetZaxis()->SetTitle("Time (ns)");
+		fBottomHist->GetZaxis()->SetTitle("Time (ns)");
+	}
+
+	// Now loop through again and fill things
+	int nFilled = 0;
+	for (int i = 0; i < nDigiHits; i++)
+	{
+		// Loop through elements in the TClonesArray of WCSimRootCherenkovDigHits
+		TObject *element = (wcSimTrigger->GetCherenkovDigiHits())->At(i);
+
+		WCSimRootCherenkovDigiHit *wcSimDigiHit = dynamic_cast<WCSimRootCherenkovDigiHit *>(element);
+
+		int p = this->GetPMTIndex(wcSimDigiHit->GetTubeId());
+		if (p < 0 || (fPMTCylLoc[p] == 3) != fViewVeto)
+			continue;
+
+		double pmtX = fPMTX[p];
+		double pmtY = fPMTY[p];
+		double pmtZ = fPMTZ[p];
+		double pmtPhi = fPMTPhi[p];
+		int pmtCylLoc = fPMTCylLoc[p];
+		double pmtQ = wcSimDigiHit->GetQ();
+		double pmtT = wcSimDigiHit->GetT();
+
+		// Make sure we pass the charge cut
+		if (pmtQ > fChargeCut)
+		{
+			unsigned int bin;
+			if (fViewType == 0)
+				bin = this->GetChargeBin(pmtQ);
+			else
+				bin = this->GetTimeBin(pmtT);
+
+			// Top cap
+			if (pmtCylLoc == 0)
+			{
+				fTopGraphs[bin]->SetPoint(fTopGraphs[bin]->GetN(), pmtY, pmtX);
+			}
+			// Bottom cap
+			else if (pmtCylLoc == 2)
+			{
+				fBottomGraphs[bin]->SetPoint(fBottomGraphs[bin]->GetN(), pmtY, pmtX);
+			}
+			// Barrel
+			else if (pmtCylLoc == 1)
+			{
+				fBarrelGraphs[bin]->SetPoint(fBarrelGraphs[bin]->GetN(), pmtPhi, pmtZ);
+			}
+			// Otherwise these are veto PMTs, put them on the view they face
+			else
+			{
+				if (fPMTOrientZ[p] > 0.99)
+				{
+					fTopGraphs[bin]->SetPoint(fTopGraphs[bin]->GetN(), pmtY, pmtX);
+				}
+				else if (fPMTOrientZ[p] < -0.99)
+				{
+					fBottomGraphs[bin]->SetPoint(fBottomGraphs[bin]->GetN(), pmtY, pmtX);
+				}
+				else
+				{
+					fBarrelGraphs[bin]->SetPoint(fBarrelGraphs[bin]->GetN(), pmtPhi, pmtZ);
+				}
+			}
+
+			// Now fill the 1D histograms
+			fChargeHist->Fill(pmtQ);
+			fTimeHist->Fill(pmtT);
+			++nFilled;
+		}
+
+	} // End of loop over Cherenkov digihits
+
+	if (nFilled > 0)
+	{
+		// Set the underflow bin of the histograms to make sure the colour axis shows
+		fTopHist->SetBinContent(0, 1);
+		fBarrelHist->SetBinContent(0, 1);
+		fBottomHist->SetBinContent(0, 1);
+	}
+	return nFilled;
+}
+
+void WCSimEvDisplayHitMaps::DrawHitMaps(TPad *barrelPad, TPad *topPad, TPad *bottomPad, TPad *chargePad,
+										TPad *timePad)
+{
+	this->SetPlotZAxes();
+
+	// Set the styles how we want them
+	this->MakePlotsPretty(fBarrelHist);
+	this->MakePlotsPretty(fTopHist);
+	this->MakePlotsPretty(fBottomHist);
+	this->MakePlotsPretty(fChargeHist);
+	this->MakePlotsPretty(fTimeHist);
+
+	barrelPad->SetLogz(fLogZCharge);
+	topPad->SetLogz(fLogZCharge);
+	bottomPad->SetLogz(fLogZCharge);
+
+	// Take the plots one by one and draw them.
+	barrelPad->cd();
+	fBarrelHist->Draw("colz");
+	fBarrelTitle->Draw();
+	this->DrawHitGraphs(fBarrelGraphs);
+	barrelPad->Modified();
+	barrelPad->Update();
+
+	topPad->cd();
+	//  fTopHist->Draw("colz");
+	fTopHist->Draw();
+	fTopTitle->Draw();
+	this->DrawHitGraphs(fTopGraphs);
+	topPad->Modified();
+	topPad->Update();
+
+	bottomPad->cd();
+	fBottomHist->Draw("colz");
+	fBottomTitle->Draw();
+	this->DrawHitGraphs(fBottomGraphs);
+	bottomPad->Modified();
+	bottomPad->Update();
+
+	this->AdjustBarrelZAxis();
+
+	if (chargePad)
+	{
+		chargePad->cd();
+		fChargeHist->Draw();
+		chargePad->Modified();
+		chargePad->Update();
+	}
+
+	if (timePad)
+	{
+		timePad->cd();
+		fTimeHist->Draw();
+		timePad->Modified();
+		timePad->Update();
+	}
+}
+
+void WCSimEvDisplayHitMaps::ClearGraphs()
+{
+	for (unsigned int i = 0; i < fTopGraphs.size(); ++i)
+	{
+		fTopGraphs[i]->Set(0);
+		fBottomGraphs[i]->Set(0);
+		fBarrelGraphs[i]->Set(0);
+	}
+}
+
+void WCSimEvDisplayHitMaps::InitialiseGraph(TGraph *g, int i)
+{
+
+	g->SetMarkerColor(fColours.at(i));
+	g->SetMarkerStyle(7);
+	g->SetEditable(0);
+}
+
+// Series of functions to take care of the TGraphs
+void WCSimEvDisplayHitMaps::CalculateChargeAndTimeBins()
+{
+	// Firstly, clear the existing vectors
+	fChargeBins.clear();
+	fTimeBins.clear();
+
+	// In order to prevent massive hits causing a problem, have a dummy max of 100pe.
+	double dummyMax = 100.;
+	if (fQMax < dummyMax)
+		dummyMax = fQMax;
+
+	double deltaQ = 0;
+	if (!fLogZCharge)
+	{
+		deltaQ = (dummyMax - fQMin) / static_cast<Double_t>(fColours.size());
+	}
+	else
+	{
+		deltaQ = TMath::Log10(dummyMax - fQMin) / static_cast<Double_t>(fColours.size());
+	}
+	double deltaT = (fTMax - fTMin) / static_cast<Double_t>(fColours.size());
+
+	for (size_t i = 0; i < fColours.size(); ++i)
+	{
+		if (!fLogZCharge)
+		{
+			fChargeBins.push_back(fQMin + i * deltaQ);
+		}
+		else
+		{
+			fChargeBins.push_back(fQMin + pow(10, i * deltaQ));
+		}
+		fTimeBins.push_back(fTMin + i * deltaT);
+	}
+}
+
+unsigned int WCSimEvDisplayHitMaps::GetChargeBin(double charge) const
+{
+	unsigned int bin = fChargeBins.size() - 1;
+	for (unsigned int i = 1; i < fChargeBins.size(); ++i)
+	{
+		if (charge < fChargeBins[i])
+		{
+			bin = i - 1;
+			break;
+		}
+	}
+	return bin;
+}
+
+unsigned int WCSimEvDisplayHitMaps::GetTimeBin(double time) const
+{
+	unsigned int bin = fTimeBins.size() - 1;
+	for (unsigned int i = 0; i < fTimeBins.size(); ++i)
+	{
+		if (time < fTimeBins.at(i))
+		{
+			bin = i - 1;
+			break;
+		}
+	}
+	return bin;
+}
+
+void WCSimEvDisplayHitMaps::MakeGraphColours()
+{
+
+	// Black Body palette
+	const Int_t nRGBs = 9;
+	const Int_t nContours = 100;
+	Double_t stops[nRGBs] = {0.0000, 0.1250, 0.2500, 0.3750, 0.5000, 0.6250, 0.7500, 0.8750, 1.0000};
+	Double_t red[nRGBs] = {33. / 255., 31. / 255., 42. / 255., 68. / 255., 86. / 255., 111. / 255., 141. / 255., 172. / 255., 227. / 255.};
+	Double_t green[nRGBs] = {255. / 255., 175. / 255., 145. / 255., 106. / 255., 88. / 255., 55. / 255., 15. / 255., 0. / 255., 0. / 255.};
+	Double_t blue[nRGBs] = {255. / 255., 205. / 255., 202. / 255., 203. / 255., 208. / 255., 205. / 255., 203. / 255.,
+							206. / 255., 231. / 255.};
+	Int_t startColour = TColor::CreateGradientColorTable(nRGBs, stops, red, green, blue, nContours);
+
+	// Make a palette
+	fColours.clear();
+	for (int i = 0; i < nContours; ++i)
+	{
+		fColours.push_back(startColour + i);
+	}
+
+	gStyle->SetNumberContours(nContours);
+}
+
+void WCSimEvDisplayHitMaps::DrawHitGraphs(std::vector<TGraph *> vec)
+{
+	for (unsigned int i = 0; i < vec.size(); ++i)
+	{
+		if (vec[i]->GetN() > 0)
+		{
+			vec[i]->Draw("P");
+		}
+	}
+}
+
+void WCSimEvDisplayHitMaps::LoadGeometryCache(WCSimRootGeom *geo)
+{
+	// The tube IDs start from 1 but need not be in order in the PMT array, so
+	// make room for the largest one. Any gaps get a location of -1.
+	int maxTubeId = 0;
+	for (int p = 0; p < geo->GetWCNumPMT(); ++p)
+	{
+		maxTubeId = std::max(maxTubeId, geo->GetPMTPointerFromArray(p)->GetTubeNo());
+	}
+
+	fPMTX.assign(maxTubeId, 0.);
+	fPMTY.assign(maxTubeId, 0.);
+	fPMTZ.assign(maxTubeId, 0.);
+	fPMTPhi.assign(maxTubeId, 0.);
+	fPMTOrientZ.assign(maxTubeId, 0.);
+	fPMTCylLoc.assign(maxTubeId, -1);
+
+	for (int p = 0; p < geo->GetWCNumPMT(); ++p)
+	{
+		WCSimRootPMT *pmt = geo->GetPMTPointerFromArray(p);
+		int i = pmt->GetTubeNo() - 1;
+		if (i < 0)
+		{
+			continue;
+		}
+		// Convert to m
+		fPMTX[i] = pmt->GetPosition(0) * 0.01;
+		fPMTY[i] = pmt->GetPosition(1) * 0.01;
+		fPMTZ[i] = pmt->GetPosition(2) * 0.01;
+		fPMTPhi[i] = TMath::ATan2(fPMTY[i], fPMTX[i]);
+		fPMTOrientZ[i] = pmt->GetOrientation(2);
+		fPMTCylLoc[i] = pmt->GetCylLoc();
+	}
+}
+
+void WCSimEvDisplayHitMaps::MakeDefaultPlots()
+{
+	fBarrelHist = new TH2D("barrelHist", ";#phi = atan(y/x);z/cm", 1, 0, 1, 1, 0, 1);
+	fTopHist = new TH2D("topHist", ";y/cm;x/cm", 1, 0, 1, 1, 0, 1);
+	fBottomHist = new TH2D("BottomHist", ";y/cm;x/cm", 1, 0, 1, 1, 0, 1);
+	fChargeHist = new TH1D("chargeHist", ";Charge / PE", 1, 0, 1);
+	fTimeHist = new TH1D("timeHist", ";Time / ns", 1, 0, 1);
+
+	fBarrelTitle = new TText(0.465, 0.915, "Barrel");
+	fTopTitle = new TText(0.49, 0.915, "Top Cap");
+	fBottomTitle = new TText(0.35, 0.915, "Bottom Cap");
+	this->FormatTitles(fBarrelTitle);
+	this->FormatTitles(fTopTitle);
+	this->FormatTitles(fBottomTitle);
+}
+
+void WCSimEvDisplayHitMaps::FormatTitles(TText *t)
+{
+	t->SetNDC();
+	t->SetTextFont(42);
+	t->SetTextSize(0.06);
+}
+
+void WCSimEvDisplayHitMaps::ClearPlots()
+{
+
+	fBarrelHist->Reset();
+	fTopHist->Reset();
+	fBottomHist->Reset();
+	fChargeHist->Reset();
+	fTimeHist->Reset();
+}
+
+void WCSimEvDisplayHitMaps::MakePlotsPretty(TH1 *h)
+{
+
+	h->GetXaxis()->CenterTitle();
+	h->GetYaxis()->CenterTitle();
+	h->GetZaxis()->CenterTitle();
+	h->GetXaxis()->SetTitleSize(0.05);
+	h->GetYaxis()->SetTitleSize(0.05);
+	h->GetZaxis()->SetTitleSize(0.05);
+	h->GetXaxis()->SetLabelSize(0.05);
+	h->GetYaxis()->SetLabelSize(0.05);
+	h->GetZaxis()->SetLabelSize(0.05);
+	h->GetXaxis()->SetNdivisions(507);
+	h->GetYaxis()->SetNdivisions(507);
+}
+
+void WCSimEvDisplayHitMaps::AdjustBarrelZAxis()
+{
+
+	TPaletteAxis *zAxis = 0x0;
+	zAxis = (TPaletteAxis *)(fBarrelHist->GetListOfFunctions()->FindObject("palette"));
+	if (zAxis != 0x0)
+	{
+		zAxis->SetX1NDC(0.927);
+		zAxis->SetX2NDC(0.950);
+		zAxis->SetTitleOffset(0.52);
+		zAxis->GetAxis()->SetTickSize(0.015);
+	}
+
+	// Also adjust the bottom plot label
+	zAxis = 0x0;
+	zAxis = (TPaletteAxis *)(fBottomHist->GetListOfFunctions()->FindObject("palette"));
+	if (zAxis != 0x0)
+	{
+		zAxis->GetAxis()->SetTitleOffset(1.03);
+		zAxis->GetAxis()->SetLabelOffset(0.012);
+	}
+}
+
+// Function mostly to account for the offset in the time origin. In
+// WCSim this offset is around 950ns.
+void WCSimEvDisplayHitMaps::GetMinColourAxis(TH2D *h)
+{
+	h->SetMinimum(0);
+	double min = 1e6;
+	// Find the minimum value that isn't zero
+	for (int x = 1; x <= h->GetNbinsX(); ++x)
+	{
+		for (int y = 1; y <= h->GetNbinsY(); ++y)
+		{
+			double temp = h->GetBinContent(x, y);
+			if (temp == 0.0)
+				continue;
+			if (temp < min)
+			{
+				min = temp;
+			}
+		}
+	}
+	// Only bother to change the z minumum if we aren't close to 0 anyway.
+	if (min > 100)
+	{
+		h->SetMinimum(0.95 * min);
+	}
+}
+
+void WCSimEvDisplayHitMaps::SetPlotZAxes()
+{
+
+	double min = fQMin;
+	double max = fQMax;
+	if (max > 100)
+		max = 100;
+
+	if (fViewType == 1)
+	{
+		min = fTMin;
+		max = fTMax;
+	}
+
+	// Make sure the histogram max / min are correct
+	fBarrelHist->SetMaximum(max);
+	fBarrelHist->SetMinimum(min);
+	fTopHist->SetMaximum(max);
+	fTopHist->SetMinimum(min);
+	fBottomHist->SetMaximum(max);
+	fBottomHist->SetMinimum(min);
+}
+
+void WCSimEvDisplayHitMaps::SetStyle()
+{
+
+	gStyle->SetOptStat(0000);
+
+	// Make sure all backgrounds are white
+	gStyle->SetFillColor(10);
+	gStyle->SetFrameFillColor(10);
+	gStyle->SetCanvasColor(10);
+	gStyle->SetPadColor(10);
+	gStyle->SetTitleFillColor(10);
+	gStyle->SetStatColor(10);
+
+	// Use nice fonts
+	const int kMinosFont = 42;
+	//	const int kMinosFont = 40;
+
+	gStyle->SetStatFont(kMinosFont);
+	gStyle->SetLabelFont(kMinosFont, "xyz");
+	gStyle->SetTitleFont(kMinosFont, "xyz");
+	gStyle->SetTitleFont(kMinosFont, "");
+	gStyle->SetTextFont(kMinosFont);
+
+	gStyle->SetTitleFontSize(0.05);
+
+	//	gROOT->SetStyle("eds");
+	gROOT->ForceStyle();
+}
@@ -7,12 +7,16 @@
 #include "WCSimWCHit.hh"
 #include "WCSimWCDigi.hh"
 #include "WCSimWCDigitizer.hh"
+#include "WCSimDigiRandom.hh"
 #include "WCSimDetectorConstruction.hh"
 #include "WCSimPMTConfig.hh"
 #include "WCSimTruthSummary.hh"
+#include "WCSimTrackFilter.hh"
+#include "WCSimFlatNtuple.hh"
 
 #include "G4Event.hh"
 #include "G4RunManager.hh"
+#include "G4Run.hh"
 #include "G4EventManager.hh"
 #include "G4UImanager.hh"
 #include "G4TrajectoryContainer.hh"
@@ -20,6 +24,7 @@
 #include "G4ios.hh"
 #include "globals.hh"
 #include "G4ThreeVector.hh"
+#include "Randomize.hh"
 #include "G4TransportationManager.hh"
 #include "G4Navigator.hh"
 #include "G4SDManager.hh"
@@ -45,10 +50,13 @@ WCSimEventAction::WCSimEventAction(WCSimRunAction *myRun, WCSimDetectorConstruct
 
 	WCSimWCDigitizer *WCDM = new WCSimWCDigitizer("WCReadout", detectorConstructor);
 	DMman->AddNewModule(WCDM);
+
+	fTrackFilter = new WCSimTrackFilter();
 }
 
 WCSimEventAction::~WCSimEventAction()
 {
+	delete fTrackFilter;
 }
 
 void WCSimEventAction::BeginOfEventAction(const G4Event *)
@@ -67,7 +75,17 @@ void WCSimEventAction::EndOfEventAction(const G4Event *evt)
 	G4int n_trajectories = 0;
 	if (trajectoryContainer)
 		n_trajectories = trajectoryContainer->entries();
-	std::cout << "There were " << n_trajectories << " trajectories" << std::endl;
+
+	// Rough memory held by the trajectories, to compare the summary and full trajectory modes
+	G4int n_points = 0;
+	for (G4int i = 0; i < n_trajectories; i++)
+	{
+		n_points += (*trajectoryContainer)[i]->GetPointEntries();
+	}
+	G4double trajectoryMBytes =
+		(n_trajectories * sizeof(WCSimTrajectory) + n_points * (sizeof(G4TrajectoryPoint) + sizeof(G4VTrajectoryPoint *))) / (1024. * 1024.);
+	std::cout << "There were " << n_trajectories << " trajectories with " << n_points << " points (" << trajectoryMBytes
+			  << " MB)" << std::endl;
 
 	// ----------------------------------------------------------------------
 	//  Get Event Information
@@ -111,54 +129,34 @@ void WCSimEventAction::EndOfEventAction(const G4Event *evt)
 	G4float PMTSize = pmt.GetRadius();
 	WCDM->SetPMTSize(PMTSize);
 
+	// Seed the digitization from the run and event numbers so that this event can
+	// be digitized again on its own with the seed saved in the header. Without a
+	// base seed from the macro one is drawn from the Geant4 engine, which has
+	// already been seeded for this event.
+	G4long baseSeed = detectorConstructor->GetDigiSeed();
+	if (baseSeed == 0)
+	{
+		baseSeed = CLHEP::RandFlat::shootInt(2147483647L);
+	}
+	G4int runID = G4RunManager::GetRunManager()->GetCurrentRun()->GetRunID();
+	WCDM->SetEventSeed(WCSimDigiRandom::GetEventSeed(baseSeed, runID, event_id));
+
 	// Digitize the hits
 	WCDM->Digitize();
 	// Get the digitized collection for the WC
 	G4int WCDCID = DMman->GetDigiCollectionID("WCDigitizedCollection");
 	WCSimWCDigitsCollection *WCDC = (WCSimWCDigitsCollection *)DMman->GetDigiCollection(WCDCID);
 
-	// Fill photon ntuple
-	if (GetRunAction()->GetSavePhotonNtuple() || GetRunAction()->GetSaveEmissionProfile())
+	// The emission profiles were filled by the stacking action as the photons were made
+	if (GetRunAction()->GetSaveEmissionProfile())
 	{
-		if (GetRunAction()->GetSaveEmissionProfile())
-		{
-			WCSimTruthSummary summ = generatorAction->GetTruthSummary();
-			WCSimEmissionProfileMaker::Instance()->Fill(evt->GetTrajectoryContainer(), &summ);
-		}
+		WCSimEmissionProfileMaker::EndEvent();
+	}
 
-		for (G4int i = 0; i < n_trajectories; i++)
-		{
-			WCSimTrajectory *trj = (WCSimTrajectory *)((*(evt->GetTrajectoryContainer()))[i]);
-
-			// get properties of trajectory
-			G4int trackID = trj->GetTrackID();
-			G4int parentID = trj->GetParentID();
-			G4int processID = trj->GetProcessID();
-			G4int pdgCode = trj->GetPDGEncoding();
-			G4double energy = trj->GetEnergy();
-			G4double momentum = trj->GetInitialMomentum().mag();
-			G4double lambda = trj->GetWavelength();
-			G4bool opticalPhoton = trj->IsOpticalPhoton();
-			G4bool scatteredPhoton = trj->IsScatteredPhoton();
-			G4double vtxX = trj->GetVtxX();
-			G4double vtxY = trj->GetVtxY();
-			G4double vtxZ = trj->GetVtxZ();
-			G4double vtxTime = trj->GetVtxTime();
-			G4double vtxdirX = trj->GetVtxDirX();
-			G4double vtxdirY = trj->GetVtxDirY();
-			G4double vtxdirZ = trj->GetVtxDirZ();
-			G4double endX = trj->GetEndX();
-			G4double endY = trj->GetEndY();
-			G4double endZ = trj->GetEndZ();
-			G4double endTime = trj->GetEndTime();
-
-			if (GetRunAction()->GetSavePhotonNtuple())
-			{
-				WCSimPhotonNtuple::Fill(event_id, pdgCode, trackID, parentID, processID, energy, momentum, lambda,
-										opticalPhoton, scatteredPhoton, vtxX, vtxY, vtxZ, vtxTime, endX, endY, endZ, endTime, vtxdirX,
-										vtxdirY, vtxdirZ);
-			}
-		}
+	// The photon ntuple was filled as the photons were made, write this event's block
+	if (GetRunAction()->GetSavePhotonNtuple())
+	{
+		WCSimPhotonNtuple::EndEvent(event_id);
 	}
 
 	G4cout << "Filling Root Event: " << event_id << G4endl;
@@ -167,6 +165,42 @@ void WCSimEventAction::EndOfEventAction(const G4Event *evt)
 	{
 		FillRootEvent(event_id, trajectoryContainer, WCHC, WCDC);
 	}
+
+	if (GetRunAction()->GetFlatNtuple())
+	{
+		FillFlatEvent(event_id, WCDC);
+	}
+}
+
+void WCSimEventAction::FillFlatEvent(G4int event_id, WCSimWCDigitsCollection *WCDC)
+{
+	WCSimFlatNtuple *flat = GetRunAction()->GetFlatNtuple();
+
+	WCSimTruthSummary truthSum = generatorAction->GetTruthSummary();
+	TVector3 vtx = truthSum.GetVertex();
+	flat->BeginEvent(event_id, truthSum.GetInteractionMode(), truthSum.GetBeamPDG(), truthSum.GetBeamEnergy(), vtx.X(),
+					 vtx.Y(), vtx.Z());
+
+	G4DigiManager *DMman = G4DigiManager::GetDMpointer();
+	WCSimWCDigitizer *WCDM = (WCSimWCDigitizer *)DMman->FindDigitizerModule("WCReadout");
+	int ngates = WCDM->NumberOfGatesInThisEvent();
+	for (int index = 0; index < ngates; index++)
+	{
+		flat->AddTrigger(WCDM->GetTriggerTime(index));
+		if (!WCDC)
+		{
+			continue;
+		}
+		for (int k = 0; k < WCDC->entries(); k++)
+		{
+			if ((*WCDC)[k]->HasHitsInGate(index))
+			{
+				flat->AddDigit(index, (*WCDC)[k]->GetTubeID(), (*WCDC)[k]->GetPe(index), (*WCDC)[k]->GetTime(index));
+			}
+		}
+	}
+
+	flat->FillEvent();
 }
 
 G4int WCSimEventAction::WCSimEventFindStartingVolume(G4ThreeVector vtx)
@@ -299,6 +333,7 @@ void WCSimEventAction::FillRootEvent(G4int event_id, G4TrajectoryContainer *TC,
 	// Need to add run and date
 	wcsimrootevent = wcsimrootsuperevent->GetTrigger(0);
 	wcsimrootevent->SetHeader(event_id, 0, 0); // will be set later.
+	wcsimrootevent->GetHeader()->SetDigiSeed(WCDM->GetEventSeed());
 
 	// Fill other info for this event
 	wcsimrootevent->SetMode(truthSum.GetInteractionMode());
@@ -412,14 +447,6 @@ void WCSimEventAction::FillRootEvent(G4int event_id, G4TrajectoryContainer *TC,
 
 	// the rest of the tracks come from WCSimTrajectory
 
-	std::set<int> pizeroList;
-	// added by M Fechner, dec 16th, 2004
-	std::set<int> muonList;
-	std::set<int> antimuonList;
-	// same, april 7th 2005
-	std::set<int> pionList;
-	std::set<int> antipionList;
-
 	// Pi0 specific variables
 	Float_t pi0Vtx[3];
 	Int_t gammaID[2];
@@ -427,158 +454,99 @@ void WCSimEventAction::FillRootEvent(G4int event_id, G4TrajectoryContainer *TC,
 	Float_t gammaVtx[2][3];
 	Int_t r = 0;
 
-	G4int n_trajectories = 0;
-	if (TC)
-		n_trajectories = TC->entries();
-
-	// JTINGEY: ADDED A LIMIT TO MAKE THE ROOT FILE SMALLER
-	// THIS SHOULD BE CONFIGURABLE OR ONLY STORE IMPORTANT TRACKS
-	// there is no need for this limit, but it has
-	// existed in previous versions of the code.  It also
-	// makes the ROOT file smaller.
-	if (n_trajectories > 5)
-	{
-		n_trajectories = 5;
-	}
+	// Pick out the tracks to save, see /WCSimTrack/filter/
+	fTrackFilter->Select(TC, fSelectedTracks, fSelectedParentTypes);
 
-	for (int i = 0; i < n_trajectories; i++)
+	for (unsigned int i = 0; i < fSelectedTracks.size(); i++)
 	{
-		WCSimTrajectory *trj = (WCSimTrajectory *)(*TC)[i];
-
-		// If this track is a pizero remember it for later
-		if (trj->GetPDGEncoding() == 111)
-			pizeroList.insert(trj->GetTrackID());
-		// If it is a mu+/mu- also remember it
-		if (trj->GetPDGEncoding() == 13)
-			muonList.insert(trj->GetTrackID());
-		if (trj->GetPDGEncoding() == -13)
-			antimuonList.insert(trj->GetTrackID());
-		if (trj->GetPDGEncoding() == 211)
-			pionList.insert(trj->GetTrackID());
-		if (trj->GetPDGEncoding() == -211)
-			antipionList.insert(trj->GetTrackID());
-
-		// Process primary tracks or the secondaries from pizero or muons...
-
-		if (trj->GetSaveFlag())
+		WCSimTrajectory *trj = fSelectedTracks[i];
+
+		// initial point of the trajectory
+		G4TrajectoryPoint *aa = (G4TrajectoryPoint *)trj->GetPoint(0);
+		runAction->incrementEventsGenerated();
+
+		G4int ipnu = trj->GetPDGEncoding();
+		G4int id = trj->GetTrackID();
+		G4int flag = 0; // will be set later
+		G4double mass = trj->GetParticleDefinition()->GetPDGMass();
+		G4ThreeVector mom = trj->GetInitialMomentum();
+		G4double mommag = mom.mag();
+		G4double energy = sqrt(mom.mag2() + mass * mass);
+		G4ThreeVector Stop = trj->GetStoppingPoint();
+		G4ThreeVector Start = aa->GetPosition();
+
+		G4String stopVolumeName = trj->GetStoppingVolume()->GetName();
+		G4int stopvol = WCSimEventFindStoppingVolume(stopVolumeName);
+		G4int startvol = WCSimEventFindStartingVolume(Start);
+
+		G4double ttime = trj->GetGlobalTime();
+
+		// The PDG code of the parent track, 0 for primaries and 999 if the
+		// parent's trajectory wasn't stored
+		G4int parentType = fSelectedParentTypes[i];
+		G4int parentID = trj->GetParentID();
+
+		// G4cout << parentType << " " << ipnu << " "
+		//	     << id << " " << energy << "\n";
+
+		// fill ntuple
+		float dir[3];
+		float pdir[3];
+		float stop[3];
+		float start[3];
+		for (int l = 0; l < 3; l++)
 		{
-			// initial point of the trajectory
-			G4TrajectoryPoint *aa = (G4TrajectoryPoint *)trj->GetPoint(0);
-			runAction->incrementEventsGenerated();
-
-			G4int ipnu = trj->GetPDGEncoding();
-			G4int id = trj->GetTrackID();
-			G4int flag = 0; // will be set later
-			G4double mass = trj->GetParticleDefinition()->GetPDGMass();
-			G4ThreeVector mom = trj->GetInitialMomentum();
-			G4double mommag = mom.mag();
-			G4double energy = sqrt(mom.mag2() + mass * mass);
-			G4ThreeVector Stop = trj->GetStoppingPoint();
-			G4ThreeVector Start = aa->GetPosition();
-
-			G4String stopVolumeName = trj->GetStoppingVolume()->GetName();
-			G4int stopvol = WCSimEventFindStoppingVolume(stopVolumeName);
-			G4int startvol = WCSimEventFindStartingVolume(Start);
-
-			G4double ttime = trj->GetGlobalTime();
-
-			G4int parentType;
-			G4int parentID = trj->GetParentID();
-
-			// Right now only secondaries whose parents are pi0's are stored
-			// This may change later
-			// M Fechner : dec 16, 2004 --> added decay e- from muons
-			if (trj->GetParentID() == 0)
-			{
-				parentType = 0;
-			}
-			else if (pizeroList.count(trj->GetParentID()))
-			{
-				parentType = 111;
-			}
-			else if (muonList.count(trj->GetParentID()))
-			{
-				parentType = 13;
-			}
-			else if (antimuonList.count(trj->GetParentID()))
-			{
-				parentType = -13;
-			}
-			else if (antipionList.count(trj->GetParentID()))
-			{
-				parentType = -211;
-			}
-			else if (pionList.count(trj->GetParentID()))
-			{
-				parentType = 211;
-			}
-			else
-			{ // no identified parent, but not a primary
-				parentType = 999;
-			}
-
-			// G4cout << parentType << " " << ipnu << " "
-			//	     << id << " " << energy << "\n";
+			dir[l] = mom[l] / mommag;		 // direction
+			pdir[l] = mom[l];				 // momentum-vector
+			stop[l] = Stop[l] / CLHEP::cm;	 // stopping point
+			start[l] = Start[l] / CLHEP::cm; // starting point
+											 //	G4cout<<"part 2 start["<<l<<"]: "<< start[l] <<G4endl;
+		}
 
-			// fill ntuple
-			float dir[3];
-			float pdir[3];
-			float stop[3];
-			float start[3];
-			for (int l = 0; l < 3; l++)
-			{
-				dir[l] = mom[l] / mommag;		 // direction
-				pdir[l] = mom[l];				 // momentum-vector
-				stop[l] = Stop[l] / CLHEP::cm;	 // stopping point
-				start[l] = Start[l] / CLHEP::cm; // starting point
-												 //	G4cout<<"part 2 start["<<l<<"]: "<< start[l] <<G4endl;
-			}
+		// Add the track to the TClonesArray, watching out for times
+		if (!((ipnu == 22) && (parentType == 999)))
+		{
+			int choose_event = 0;
 
-			// Add the track to the TClonesArray, watching out for times
-			if (!((ipnu == 22) && (parentType == 999)))
+			if (ngates)
 			{
-				int choose_event = 0;
 
-				if (ngates)
-				{
-
-					if (ttime > WCDM->GetTriggerTime(0) + 950. && WCDM->GetTriggerTime(1) + 950. > ttime)
-						choose_event = 1;
-					if (ttime > WCDM->GetTriggerTime(1) + 950. && WCDM->GetTriggerTime(2) + 950. > ttime)
-						choose_event = 2;
-					if (choose_event >= ngates)
-						choose_event = ngates - 1; // do not overflow the number of events
-				}
-
-				wcsimrootevent = wcsimrootsuperevent->GetTrigger(choose_event);
-				wcsimrootevent->AddTrack(ipnu, flag, mass, mommag, energy, startvol, stopvol, dir, pdir, stop, start,
-										 parentType, ttime, id, parentID);
+				if (ttime > WCDM->GetTriggerTime(0) + 950. && WCDM->GetTriggerTime(1) + 950. > ttime)
+					choose_event = 1;
+				if (ttime > WCDM->GetTriggerTime(1) + 950. && WCDM->GetTriggerTime(2) + 950. > ttime)
+					choose_event = 2;
+				if (choose_event >= ngates)
+					choose_event = ngates - 1; // do not overflow the number of events
 			}
 
-			if (detectorConstructor->SavePi0Info() == true)
+			wcsimrootevent = wcsimrootsuperevent->GetTrigger(choose_event);
+			wcsimrootevent->AddTrack(ipnu, flag, mass, mommag, energy, startvol, stopvol, dir, pdir, stop, start,
+									 parentType, ttime, id, parentID);
+		}
+
+		if (detectorConstructor->SavePi0Info() == true)
+		{
+			G4cout << "Pi0 parentType: " << parentType << G4endl;
+			if (parentType == 111)
 			{
-				G4cout << "Pi0 parentType: " << parentType << G4endl;
-				if (parentType == 111)
+				if (r > 1)
+					G4cout << "WARNING: more than 2 primary gammas found" << G4endl;
+				else
 				{
-					if (r > 1)
-						G4cout << "WARNING: more than 2 primary gammas found" << G4endl;
-					else
-					{
 
-						for (int y = 0; y < 3; y++)
-						{
-							pi0Vtx[y] = start[y];
-							gammaVtx[r][y] = stop[y];
-						}
+					for (int y = 0; y < 3; y++)
+					{
+						pi0Vtx[y] = start[y];
+						gammaVtx[r][y] = stop[y];
+					}
 
-						gammaID[r] = id;
-						gammaE[r] = energy;
-						r++;
+					gammaID[r] = id;
+					gammaE[r] = energy;
+					r++;
 
-						//amb79
-						G4cout << "Pi0 data: " << id << G4endl;
-						wcsimrootevent->SetPi0Info(pi0Vtx, gammaID, gammaE, gammaVtx);
-					}
+					//amb79
+					G4cout << "Pi0 data: " << id << G4endl;
+					wcsimrootevent->SetPi0Info(pi0Vtx, gammaID, gammaE, gammaVtx);
 				}
 			}
 		}
@@ -588,16 +556,16 @@ void WCSimEventAction::FillRootEvent(G4int event_id, G4TrajectoryContainer *TC,
 	wcsimrootevent = wcsimrootsuperevent->GetTrigger(0);
 
 	//  wcsimrootevent->SetNumTubesHit(jhfNtuple.numTubesHit);
-#ifdef _SAVE_RAW_HITS
-	if (WCHC)
+	if (WCHC && GetRunAction()->GetSaveRawHits())
 	{
-		G4cout << "RAW HITS" << G4endl;
 		wcsimrootevent->SetNumTubesHit(WCHC->entries());
+		// Reused for every tube, and saved packed rather than one object per photon
+		std::vector<float> truetime;
+		std::vector<int> primaryParentID;
 		for (int k = 0; k < WCHC->entries(); k++)
 		{
-
-			std::vector<float> truetime;
-			std::vector<int> primaryParentID;
+			truetime.clear();
+			primaryParentID.clear();
 
 			int tubeID = (*WCHC)[k]->GetTubeID();
 			int totalpe = (*WCHC)[k]->GetTotalPe();
@@ -608,12 +576,10 @@ void WCSimEventAction::FillRootEvent(G4int event_id, G4TrajectoryContainer *TC,
 				primaryParentID.push_back((*WCHC)[k]->GetParentID(l));
 			}
 
-			wcsimrootevent->AddCherenkovHit(tubeID, truetime, primaryParentID);
+			wcsimrootevent->AddPackedCherenkovHit(tubeID, truetime, primaryParentID);
 		}
 	}
 
-#endif
-
 	// Add the digitized hits
 
 	if (WCDC)
@@ -655,25 +621,16 @@ void WCSimEventAction::FillRootEvent(G4int event_id, G4TrajectoryContainer *TC,
 		//G4cout << ">>>Root event " << std::setw(5) << wcsimrootevent->GetHeader()->GetEvtNum() << "\n";
 	}
 
-#ifdef _SAVE_RAW_HITS
-	//if (WCHC)
-	//     G4cout <<"WC:"<<std::setw(4)<<wcsimrootevent->GetNcherenkovhits()<<"  ";
-	//    if (WCFVHC)
-	//G4cout <<"WCFV:"<<std::setw(4)<<wcsimrootevent->GetINcherenkovhits()<<"  ";
-#endif
-
 	//  if (WCFVDC){
 	//G4cout <<"WCFV digi:"<<std::setw(4)<<wcsimrootevent->GetNcherenkovdigihits()<<"  ";
 	//G4cout <<"WCFV digi sumQ:"<<std::setw(4)<<wcsimrootevent->GetSumQ()<<"  ";
 	//  }
 
+	// The tree header is saved by ROOT's autosave as set up in
+	// WCSimRunAction::BeginOfRunAction(), and written for the last time at the
+	// end of the run, rather than rewriting the whole file every event.
 	TTree *tree = GetRunAction()->GetTree();
 	tree->Fill();
-	TFile *hfile = tree->GetCurrentFile();
-	// MF : overwrite the trees -- otherwise we have as many copies of the tree
-	// as we have events. All the intermediate copies are incomplete, only the
-	// last one is useful --> huge waste of disk space.
-	hfile->Write("", TObject::kOverwrite);
 
 	// M Fechner : reinitialize the super event after the writing is over
 	wcsimrootsuperevent->ReInitialize();
@@ -0,0 +1,84 @@
+#include "WCSimFlatNtuple.hh"
+
+#include "TTree.h"
+
+WCSimFlatNtuple::WCSimFlatNtuple(Int_t basketSize)
+{
+	fEventID = 0;
+	fMode = 0;
+	fBeamPDG = 0;
+	fBeamEnergy = 0.;
+	fVtxX = 0.;
+	fVtxY = 0.;
+	fVtxZ = 0.;
+
+	fTree = new TTree("flatT", "WCSim flat digit tree");
+	fTree->Branch("eventID", &fEventID, "eventID/I");
+	fTree->Branch("mode", &fMode, "mode/I");
+	fTree->Branch("beamPDG", &fBeamPDG, "beamPDG/I");
+	fTree->Branch("beamEnergy", &fBeamEnergy, "beamEnergy/F");
+	fTree->Branch("vtxX", &fVtxX, "vtxX/F");
+	fTree->Branch("vtxY", &fVtxY, "vtxY/F");
+	fTree->Branch("vtxZ", &fVtxZ, "vtxZ/F");
+	fTree->Branch("triggerTime", &fTriggerTime, basketSize);
+	fTree->Branch("digiTrigger", &fDigiTrigger, basketSize);
+	fTree->Branch("digiTube", &fDigiTube, basketSize);
+	fTree->Branch("digiQ", &fDigiQ, basketSize);
+	fTree->Branch("digiT", &fDigiT, basketSize);
+
+	fGeoTree = new TTree("flatGeoT", "WCSim flat geometry tree");
+	fGeoTree->Branch("pmtTube", &fPMTTube);
+	fGeoTree->Branch("pmtCylLoc", &fPMTCylLoc);
+	fGeoTree->Branch("pmtX", &fPMTX);
+	fGeoTree->Branch("pmtY", &fPMTY);
+	fGeoTree->Branch("pmtZ", &fPMTZ);
+	fGeoTree->Branch("pmtDirX", &fPMTDirX);
+	fGeoTree->Branch("pmtDirY", &fPMTDirY);
+	fGeoTree->Branch("pmtDirZ", &fPMTDirZ);
+	fGeoTree->Branch("pmtRadius", &fPMTRadius);
+}
+
+WCSimFlatNtuple::~WCSimFlatNtuple()
+{
+	// The trees belong to the file they were made in
+}
+
+void WCSimFlatNtuple::BeginEvent(Int_t eventID, Int_t mode, Int_t beamPDG, Float_t beamEnergy, Float_t vtxX,
+								 Float_t vtxY, Float_t vtxZ)
+{
+	fEventID = eventID;
+	fMode = mode;
+	fBeamPDG = beamPDG;
+	fBeamEnergy = beamEnergy;
+	fVtxX = vtxX;
+	fVtxY = vtxY;
+	fVtxZ = vtxZ;
+	fTriggerTime.clear();
+	fDigiTrigger.clear();
+	fDigiTube.clear();
+	fDigiQ.clear();
+	fDigiT.clear();
+}
+
+void WCSimFlatNtuple::FillEvent()
+{
+	fTree->Fill();
+}
+
+void WCSimFlatNtuple::AddPMT(Int_t tube, Int_t cylLoc, const Float_t pos[3], const Float_t dir[3], Float_t radius)
+{
+	fPMTTube.push_back(tube);
+	fPMTCylLoc.push_back(cylLoc);
+	fPMTX.push_back(pos[0]);
+	fPMTY.push_back(pos[1]);
+	fPMTZ.push_back(pos[2]);
+	fPMTDirX.push_back(dir[0]);
+	fPMTDirY.push_back(dir[1]);
+	fPMTDirZ.push_back(dir[2]);
+	fPMTRadius.push_back(radius);
+}
+
+void WCSimFlatNtuple::FillGeometry()
+{
+	fGeoTree->Fill();
+}
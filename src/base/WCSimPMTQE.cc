@@ -0,0 +1,90 @@
+#include "WCSimPMTQE.hh"
+#include "WCSimPMTConfig.hh"
+
+#include <cmath>
+#include <iostream>
+
+WCSimPMTQE::WCSimPMTQE()
+{
+	fLow = 0.;
+	fHigh = 0.;
+	fInvBinWidth = 1.;
+	fMaxX = 0.;
+	fMaxQE = 0.;
+	fEnvelope.assign(2, 0.);
+}
+
+WCSimPMTQE::~WCSimPMTQE()
+{
+}
+
+void WCSimPMTQE::Build(const std::vector<WCSimPMTConfig> &configs, double lowWavelength, double highWavelength,
+					   double binWidth)
+{
+	fLow = lowWavelength;
+	fHigh = highWavelength;
+	fInvBinWidth = 1. / binWidth;
+
+	unsigned int nBins = static_cast<unsigned int>(std::floor((fHigh - fLow) * fInvBinWidth + 0.5));
+	fMaxX = nBins;
+
+	fTables.clear();
+	fNames.clear();
+	fMaxQE = 0.;
+
+	// One more point than the number of bins, plus a zero so that the
+	// interpolation at the very top of the range stays inside the table.
+	fEnvelope.assign(nBins + 2, 0.);
+
+	for (unsigned int type = 0; type < configs.size(); ++type)
+	{
+		std::vector<std::pair<double, double>> effVec = configs[type].GetEfficiencyVector();
+		std::vector<double> table(nBins + 2, 0.);
+		for (unsigned int bin = 0; bin <= nBins; ++bin)
+		{
+			double wavelength = fLow + bin * binWidth;
+			// The old QE function also cut everything outside 280 - 660nm
+			if (wavelength <= fLow || wavelength >= fHigh || wavelength <= 280 || wavelength >= 660)
+			{
+				continue;
+			}
+			table[bin] = EvaluateQE(effVec, wavelength);
+			fEnvelope[bin] = std::max(fEnvelope[bin], table[bin]);
+		}
+		fTables.push_back(table);
+		fNames.push_back(configs[type].GetPMTName());
+		fMaxQE = std::max(fMaxQE, configs[type].GetMaxEfficiency());
+	}
+
+	std::cout << "WCSimPMTQE: built QE tables for " << fNames.size() << " PMT types with " << nBins << " bins from "
+			  << fLow << " to " << fHigh << " nm" << std::endl;
+}
+
+int WCSimPMTQE::GetType(const std::string &name) const
+{
+	for (unsigned int type = 0; type < fNames.size(); ++type)
+	{
+		if (fNames[type] == name)
+		{
+			return type;
+		}
+	}
+	return -1;
+}
+
+double WCSimPMTQE::EvaluateQE(const std::vector<std::pair<double, double>> &effVec, double wavelength)
+{
+	// First number in the pair is the wavelength, second is the efficiency
+	for (unsigned int i = 0; i + 1 < effVec.size(); ++i)
+	{
+		if (wavelength <= effVec[i + 1].first)
+		{
+			double wave1 = effVec[i].first;
+			double eff1 = effVec[i].second;
+			double wave2 = effVec[i + 1].first;
+			double eff2 = effVec[i + 1].second;
+			return eff1 + (eff2 - eff1) / (wave2 - wave1) * (wavelength - wave1);
+		}
+	}
+	return 0.;
+}
@@ -1,13 +1,19 @@
 #include "WCSimPhotonNtuple.hh"
+#include "globals.hh"
+#include "G4Track.hh"
+#include "G4VProcess.hh"
+#include "G4SystemOfUnits.hh"
 
 #include "TFile.h"
 #include "TTree.h"
 #include "TDirectory.h"
 
 #include <cassert>
+#include <cmath>
 #include <iostream>
 
-static WCSimPhotonNtuple *fgNtuple = 0;
+// One ntuple per thread, each writing its own file
+static G4ThreadLocal WCSimPhotonNtuple *fgNtuple = 0;
 
 WCSimPhotonNtuple *WCSimPhotonNtuple::Instance()
 {
@@ -38,6 +44,10 @@ WCSimPhotonNtuple::WCSimPhotonNtuple()
 {
 	fWCFile = 0;
 	fWCTree = 0;
+	fPrescale = 1;
+	fNumSeen = 0;
+	fEventID = 0;
+	fNumPhotons = 0;
 	fWCFileName = "localfile_photons.root";
 	this->OpenFile(fWCFileName.Data());
 	fHalfWidthZ = 0.0;
@@ -48,6 +58,10 @@ WCSimPhotonNtuple::WCSimPhotonNtuple(G4String str)
 {
 	fWCFile = 0;
 	fWCTree = 0;
+	fPrescale = 1;
+	fNumSeen = 0;
+	fEventID = 0;
+	fNumPhotons = 0;
 	fWCFileName = str;
 	this->OpenFile(fWCFileName.Data());
 	fHalfWidthZ = 0.0;
@@ -74,111 +88,176 @@ void WCSimPhotonNtuple::FileName(const char *filename)
 	WCSimPhotonNtuple::Instance()->SetFileName(filename);
 }
 
-void WCSimPhotonNtuple::Fill(Int_t eventID, Int_t pdgCode, Int_t trackID, Int_t parentID, Int_t processID,
-							 Float_t energy, Float_t momentum, Float_t lambda, Bool_t opticalPhoton, Bool_t scatteredPhoton, Float_t vtxX,
-							 Float_t vtxY, Float_t vtxZ, Float_t vtxTime, Float_t endX, Float_t endY, Float_t endZ, Float_t endTime,
-							 Float_t vtxdirX, Float_t vtxdirY, Float_t vtxdirZ)
+bool WCSimPhotonNtuple::IsOpen()
 {
-	WCSimPhotonNtuple::Instance()->WriteEvent(eventID, pdgCode, trackID, parentID, processID, energy, momentum, lambda,
-											  opticalPhoton, scatteredPhoton, vtxX, vtxY, vtxZ, vtxTime, endX, endY, endZ, endTime, vtxdirX, vtxdirY,
-											  vtxdirZ);
+	return fgNtuple != 0 && fgNtuple->fWCFile != 0;
 }
 
-void WCSimPhotonNtuple::WriteEvent(Int_t eventID, Int_t pdgCode, Int_t trackID, Int_t parentID, Int_t processID,
-								   Float_t energy, Float_t momentum, Float_t lambda, Bool_t opticalPhoton, Bool_t scatteredPhoton, Float_t vtxX,
-								   Float_t vtxY, Float_t vtxZ, Float_t vtxTime, Float_t endX, Float_t endY, Float_t endZ, Float_t endTime,
-								   Float_t vtxdirX, Float_t vtxdirY, Float_t vtxdirZ)
+void WCSimPhotonNtuple::AddPhoton(const G4Track *track)
 {
-	fEventID = eventID;
-	fPdgCode = pdgCode;
-	fTrackID = trackID;
-	fParentID = parentID;
-	fProcessID = processID;
-	fEnergy = energy;
-	fMomentum = momentum;
-	fLambda = lambda;
-	fOpticalPhoton = opticalPhoton;
-	fScatteredPhoton = scatteredPhoton;
-	fVtxX = vtxX;
-	fVtxY = vtxY;
-	fVtxZ = vtxZ;
-	fVtxTime = vtxTime;
-	fEndX = endX;
-	fEndY = endY;
-	fEndZ = endZ;
-	fEndTime = endTime;
-
-	fVtxDirX = vtxdirX;
-	fVtxDirY = vtxdirY;
-	fVtxDirZ = vtxdirZ;
-
-	fIsDetected = 0;
-
-	if (fOpticalPhoton && fProcessID == 2)
-	{ // Added the || 1 - AJP
-		this->WriteEventToFile();
-	}
+	WCSimPhotonNtuple::Instance()->RecordPhoton(track);
 }
 
-void WCSimPhotonNtuple::WriteEventToFile()
+void WCSimPhotonNtuple::EndPhoton(const G4Track *track)
 {
+	WCSimPhotonNtuple::Instance()->RecordEnd(track);
+}
 
-	this->OpenFile(fWCFileName.Data());
+void WCSimPhotonNtuple::DetectPhoton(Int_t trackID, Int_t tubeID)
+{
+	WCSimPhotonNtuple::Instance()->RecordDetection(trackID, tubeID);
+}
 
-	this->WriteToFile();
+void WCSimPhotonNtuple::EndEvent(Int_t eventID)
+{
+	WCSimPhotonNtuple::Instance()->WriteEvent(eventID);
+}
 
-	return;
+void WCSimPhotonNtuple::RecordPhoton(const G4Track *track)
+{
+	// Only the Cherenkov photons, as before
+	const G4VProcess *creator = track->GetCreatorProcess();
+	if (creator == 0 || creator->GetProcessType() != 2)
+	{
+		return;
+	}
+	if ((fNumSeen++ % fPrescale) != 0)
+	{
+		return;
+	}
+
+	Int_t trackID = track->GetTrackID();
+	if (trackID >= (Int_t)fRecordOfTrack.size())
+	{
+		fRecordOfTrack.resize(2 * trackID + 1, -1);
+	}
+	fRecordOfTrack[trackID] = fTrackID.size();
+
+	const G4ThreeVector &pos = track->GetPosition();
+	const G4ThreeVector &dir = track->GetMomentumDirection();
+	G4double energy = track->GetTotalEnergy();
+	fTrackID.push_back(trackID);
+	fParentID.push_back(track->GetParentID());
+	fProcessID.push_back(creator->GetProcessType());
+	fEnergy.push_back(energy);
+	fLambda.push_back((2.0 * M_PI * 197.3) / (energy / CLHEP::eV));
+	fVtxX.push_back(pos.x());
+	fVtxY.push_back(pos.y());
+	fVtxZ.push_back(pos.z());
+	fVtxTime.push_back(track->GetGlobalTime());
+	fVtxDirX.push_back(dir.x());
+	fVtxDirY.push_back(dir.y());
+	fVtxDirZ.push_back(dir.z());
+	// Until the photon is tracked the end is where it started
+	fEndX.push_back(pos.x());
+	fEndY.push_back(pos.y());
+	fEndZ.push_back(pos.z());
+	fEndTime.push_back(track->GetGlobalTime());
+	fIsDetected.push_back(0);
+	fTubeID.push_back(0);
 }
 
-void WCSimPhotonNtuple::OpenFile(const char *filename)
+void WCSimPhotonNtuple::RecordEnd(const G4Track *track)
 {
-	TDirectory *tmpd = 0;
+	Int_t record = this->GetRecord(track->GetTrackID());
+	if (record < 0)
+	{
+		return;
+	}
+	const G4ThreeVector &pos = track->GetPosition();
+	fEndX[record] = pos.x();
+	fEndY[record] = pos.y();
+	fEndZ[record] = pos.z();
+	fEndTime[record] = track->GetGlobalTime();
+}
 
-	if (fWCFile == 0)
+void WCSimPhotonNtuple::RecordDetection(Int_t trackID, Int_t tubeID)
+{
+	Int_t record = this->GetRecord(trackID);
+	if (record < 0)
+	{
+		return;
+	}
+	fIsDetected[record] = 1;
+	fTubeID[record] = tubeID;
+}
+
+void WCSimPhotonNtuple::WriteEvent(Int_t eventID)
+{
+	fEventID = eventID;
+	fNumPhotons = fTrackID.size();
+
+	TDirectory *tmpd = 0;
+	if (fWCFile)
 	{
 		tmpd = gDirectory;
-		std::cout << " opening file: " << filename << std::endl;
-		fWCFile = new TFile(filename, "recreate");
-		fWCTree = new TTree("ntuple", "my analysis ntuple");
-		fWCTree->Branch("eventID", &fEventID, "eventID/I");
-		fWCTree->Branch("pdgCode", &fPdgCode, "pdgCode/I");
-		fWCTree->Branch("trackID", &fTrackID, "trackID/I");
-		fWCTree->Branch("parentID", &fParentID, "parentID/I");
-		fWCTree->Branch("processID", &fProcessID, "processID/I");
-		fWCTree->Branch("energy", &fEnergy, "energy/F");
-		fWCTree->Branch("momentum", &fMomentum, "momentum/F");
-		fWCTree->Branch("wavelength", &fLambda, "wavelength/F");
-		fWCTree->Branch("optical", &fOpticalPhoton, "optical/I");
-		fWCTree->Branch("scattered", &fScatteredPhoton, "scattered/I");
-		fWCTree->Branch("vtxX", &fVtxX, "vtxX/F");
-		fWCTree->Branch("vtxY", &fVtxY, "vtxY/F");
-		fWCTree->Branch("vtxZ", &fVtxZ, "vtxZ/F");
-		//fWCTree->Branch("vtxTime",&fVtxTime,"vtxTime/F");
-		fWCTree->Branch("endX", &fEndX, "endX/F");
-		fWCTree->Branch("endY", &fEndY, "endY/F");
-		fWCTree->Branch("endZ", &fEndZ, "endZ/F");
-		//    fWCTree->Branch("endU",&fEndU,"endU/F");
-		//    fWCTree->Branch("endV",&fEndV,"endV/F");
-		//    //fWCTree->Branch("endTime",&fEndTime,"endTime/F");
-		fWCTree->Branch("vtxdirX", &fVtxDirX, "vtxdirX/F");
-		fWCTree->Branch("vtxdirY", &fVtxDirY, "vtxdirY/F");
-		fWCTree->Branch("vtxdirZ", &fVtxDirZ, "vtxdirZ/F");
-		//fWCTree->Branch("isDetected",&fIsDetected,"isDetected/I");
+		fWCFile->cd();
+		fWCTree->Fill();
 		gDirectory = tmpd;
 	}
 
-	return;
+	this->ClearEvent();
 }
 
-void WCSimPhotonNtuple::WriteToFile()
+void WCSimPhotonNtuple::ClearEvent()
+{
+	// Only reset the track IDs that were used so the lookup doesn't need clearing in full
+	for (unsigned int i = 0; i < fTrackID.size(); ++i)
+	{
+		fRecordOfTrack[fTrackID[i]] = -1;
+	}
+	fNumSeen = 0;
+	fTrackID.clear();
+	fParentID.clear();
+	fProcessID.clear();
+	fEnergy.clear();
+	fLambda.clear();
+	fVtxX.clear();
+	fVtxY.clear();
+	fVtxZ.clear();
+	fVtxTime.clear();
+	fVtxDirX.clear();
+	fVtxDirY.clear();
+	fVtxDirZ.clear();
+	fEndX.clear();
+	fEndY.clear();
+	fEndZ.clear();
+	fEndTime.clear();
+	fIsDetected.clear();
+	fTubeID.clear();
+}
+
+void WCSimPhotonNtuple::OpenFile(const char *filename)
 {
 	TDirectory *tmpd = 0;
 
-	if (fWCFile)
+	if (fWCFile == 0)
 	{
 		tmpd = gDirectory;
-		fWCFile->cd();
-		fWCTree->Fill();
+		std::cout << " opening file: " << filename << std::endl;
+		fWCFile = new TFile(filename, "recreate");
+		fWCTree = new TTree("photonT", "Cherenkov photons, one entry per event");
+		fWCTree->Branch("eventID", &fEventID, "eventID/I");
+		fWCTree->Branch("prescale", &fPrescale, "prescale/I");
+		fWCTree->Branch("nPhotons", &fNumPhotons, "nPhotons/I");
+		fWCTree->Branch("trackID", &fTrackID);
+		fWCTree->Branch("parentID", &fParentID);
+		fWCTree->Branch("processID", &fProcessID);
+		fWCTree->Branch("energy", &fEnergy);
+		fWCTree->Branch("wavelength", &fLambda);
+		fWCTree->Branch("vtxX", &fVtxX);
+		fWCTree->Branch("vtxY", &fVtxY);
+		fWCTree->Branch("vtxZ", &fVtxZ);
+		fWCTree->Branch("vtxTime", &fVtxTime);
+		fWCTree->Branch("vtxdirX", &fVtxDirX);
+		fWCTree->Branch("vtxdirY", &fVtxDirY);
+		fWCTree->Branch("vtxdirZ", &fVtxDirZ);
+		fWCTree->Branch("endX", &fEndX);
+		fWCTree->Branch("endY", &fEndY);
+		fWCTree->Branch("endZ", &fEndZ);
+		fWCTree->Branch("endTime", &fEndTime);
+		fWCTree->Branch("isDetected", &fIsDetected);
+		fWCTree->Branch("tubeID", &fTubeID);
 		gDirectory = tmpd;
 	}
 
@@ -9,6 +9,8 @@
 #include "G4TwoVector.hh"
 #include <cassert>
 #include <math.h>
+#include <cfloat>
+#include <algorithm>
 #include <vector>
 #include <iostream>
 #include "TMath.h"
@@ -102,6 +104,85 @@ bool PolygonContainsSquare(unsigned int nSides, double outerRadius, G4TwoVector
 	return contained;
 }
 
+bool IntersectPrism(unsigned int nSides, double innerRadius, double halfHeight, double phiSide,
+					const G4ThreeVector &point, const G4ThreeVector &dir, double &tEnter, double &tExit)
+{
+	// Clip the line against the end caps and then each side in turn, keeping the
+	// range of t where it is on the inside of all of them
+	tEnter = -DBL_MAX;
+	tExit = DBL_MAX;
+
+	if (dir.z() == 0.)
+	{
+		if (fabs(point.z()) > halfHeight)
+		{
+			return false;
+		}
+	}
+	else
+	{
+		double t1 = (-halfHeight - point.z()) / dir.z();
+		double t2 = (halfHeight - point.z()) / dir.z();
+		tEnter = std::min(t1, t2);
+		tExit = std::max(t1, t2);
+	}
+
+	if (nSides == 0)
+	{
+		// Cylinder: solve |(point + t * dir)_xy| = innerRadius
+		double a = dir.x() * dir.x() + dir.y() * dir.y();
+		double b = point.x() * dir.x() + point.y() * dir.y();
+		double c = point.x() * point.x() + point.y() * point.y() - innerRadius * innerRadius;
+		if (a == 0.)
+		{
+			return (c <= 0.) && (tEnter <= tExit);
+		}
+		double disc = b * b - a * c;
+		if (disc < 0.)
+		{
+			return false;
+		}
+		double root = sqrt(disc);
+		tEnter = std::max(tEnter, (-b - root) / a);
+		tExit = std::min(tExit, (-b + root) / a);
+		return tEnter <= tExit;
+	}
+
+	// Each side is the plane n.x = innerRadius with n its outward normal
+	double dPhi = 2. * M_PI / nSides;
+	for (unsigned int iSide = 0; iSide < nSides; ++iSide)
+	{
+		double phi = phiSide + iSide * dPhi;
+		double nx = cos(phi);
+		double ny = sin(phi);
+		double towards = nx * dir.x() + ny * dir.y();
+		double distance = innerRadius - (nx * point.x() + ny * point.y());
+		if (towards == 0.)
+		{
+			// Parallel to this side, so either always inside it or never
+			if (distance < 0.)
+			{
+				return false;
+			}
+			continue;
+		}
+		double t = distance / towards;
+		if (towards > 0.)
+		{
+			tExit = std::min(tExit, t);
+		}
+		else
+		{
+			tEnter = std::max(tEnter, t);
+		}
+		if (tEnter > tExit)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
 double GetSideFromRadius(unsigned int nSides, double outerRadius)
 {
 	assert(CheckPolygon(nSides, outerRadius));
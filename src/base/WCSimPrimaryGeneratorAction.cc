@@ -1,9 +1,13 @@
 #include "WCSimPrimaryGeneratorAction.hh"
 #include "WCSimDetectorConstruction.hh"
+#include "WCSimCherenkovBuilder.hh"
+#include "WCSimGeoConfig.hh"
+#include "WCSimPolygonTools.hh"
 #include "WCSimPrimaryGeneratorMessenger.hh"
 #include "WCSimTruthSummary.hh"
 
 #include "G4Event.hh"
+#include "G4RunManager.hh"
 #include "G4ParticleGun.hh"
 #include "G4GeneralParticleSource.hh"
 #include "G4ParticleTable.hh"
@@ -11,36 +15,14 @@
 #include "G4ThreeVector.hh"
 #include "globals.hh"
 #include "Randomize.hh"
-#include <fstream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <vector>
-#include <string>
-#include <cstdlib>
 
 #include "G4Navigator.hh"
 #include "G4TransportationManager.hh"
 
-using std::fstream;
-using std::string;
-using std::vector;
-
-vector<string> tokenize(string separators, string input);
-
-inline vector<string> readInLine(fstream &inFile, int lineSize, char *inBuf)
-{
-	// Read in line break it up into tokens
-	inFile.getline(inBuf, lineSize);
-	return tokenize(" $", inBuf);
-}
-
-inline float atof(const string &s)
-{
-	return std::atof(s.c_str());
-}
-inline int atoi(const string &s)
-{
-	return std::atoi(s.c_str());
-}
-
 WCSimPrimaryGeneratorAction::WCSimPrimaryGeneratorAction(WCSimDetectorConstruction *myDC) : myDetector(myDC)
 {
 	//T. Akiri: Initialize GPS to allow for the laser use
@@ -62,11 +44,31 @@ WCSimPrimaryGeneratorAction::WCSimPrimaryGeneratorAction(WCSimDetectorConstructi
 	messenger = new WCSimPrimaryGeneratorMessenger(this);
 	useMulineEvt = true;
 	useNormalEvt = false;
+	fVecEventsRead = 0;
+	fOverlayEventsRead = 0;
+	fVectorReader = 0;
+	fOverlayReader = 0;
+
+	fFirstEvent = 0;
+	fShardIndex = 0;
+	fNShards = 1;
+	fVecStartEvent = 0;
+	fVecNEvents = -1;
+	fVecRangeSet = false;
+	fOverlayStartEvent = 0;
+	fOverlayNEvents = -1;
+	fOverlayRangeSet = false;
+
+	fDetectorShapeSet = false;
+	fDetectorSides = 0;
+	fDetectorRadius = 0.;
+	fDetectorHalfHeight = 0.;
 }
 
 WCSimPrimaryGeneratorAction::~WCSimPrimaryGeneratorAction()
 {
-	inputFile.close();
+	delete fVectorReader;
+	delete fOverlayReader;
 	delete particleGun;
 	delete MyGPS; //T. Akiri: Delete the GPS variable
 	delete messenger;
@@ -78,137 +80,80 @@ void WCSimPrimaryGeneratorAction::GeneratePrimaries(G4Event *anEvent)
 	// Reset the truth information
 	fTruthSummary.ResetValues();
 
-	// Temporary kludge to turn on/off vector text format
-	G4bool useNuanceTextFormat = true;
-
 	// Do for every event
 	if (useMulineEvt)
 	{
 
-		if (!inputFile.is_open())
+		if (!fVectorReader || !fVectorReader->IsOpen())
 		{
 			G4cout << "Set a vector file using the command /mygen/vecfile name" << G4endl;
 			return;
 		}
 
-		if (useNuanceTextFormat)
+		// Catch up with the event this thread has been given
+		if (!MoveToVectorEvent(anEvent->GetEventID()))
+		{
+			G4RunManager::GetRunManager()->AbortRun(true);
+			return;
+		}
+
+		if (ReadNextVectorEvent())
 		{
-			const int lineSize = 100;
-			char inBuf[lineSize];
-			vector<string> token(1);
+			const WCSimVectorEvent &event = fVectorEvent;
 
-			token = readInLine(inputFile, lineSize, inBuf);
+			// The nuance line contains the interaction mode. Bag it and tag it.
+			fTruthSummary.SetInteractionMode(event.mode);
 
-			if (token.size() == 0)
+			// The vertex
+			G4ThreeVector nuVtx = G4ThreeVector(event.vtx[0] * CLHEP::cm, event.vtx[1] * CLHEP::cm, event.vtx[2] * CLHEP::cm);
+			if (fUseXAxisForBeam)
 			{
-				G4cout << "end of nuance vector file!" << G4endl;
-				if (LoadNextVectorFile())
-				{
-					G4cout << "Loading next vector file" << G4endl;
-					token = readInLine(inputFile, lineSize, inBuf);
-				}
+				nuVtx = G4ThreeVector(event.vtx[2] * CLHEP::cm, event.vtx[1] * CLHEP::cm, event.vtx[0] * CLHEP::cm);
+			}
+			if (fUseRandomVertex)
+			{
+				nuVtx = GenerateRandomVertex();
+			}
+			fTruthSummary.SetVertex(nuVtx.x(), nuVtx.y(), nuVtx.z());
+			double nuVtxT = GetBeamSpillEventTime();
+			fTruthSummary.SetVertexT(nuVtxT);
+
+			// true : Generate vertex in Rock , false : Generate vertex in WC tank
+			SetGenerateVertexInRock(false);
+
+			// The incoming neutrino and target
+			fTruthSummary.SetBeamPDG(event.beam.pdg);
+			fTruthSummary.SetBeamEnergy(event.beam.energy * CLHEP::MeV);
+			fTruthSummary.SetBeamDir(event.beam.dir[0], event.beam.dir[1], event.beam.dir[2]);
+			if (fUseXAxisForBeam)
+			{
+				fTruthSummary.SetBeamDir(event.beam.dir[2], event.beam.dir[1], event.beam.dir[0]);
 			}
 
-			if (token.size() != 0)
+			fTruthSummary.SetTargetPDG(event.target.pdg);
+			fTruthSummary.SetTargetEnergy(event.target.energy * CLHEP::MeV);
+			fTruthSummary.SetTargetDir(event.target.dir[0], event.target.dir[1], event.target.dir[2]);
+			if (fUseXAxisForBeam)
 			{
-				if (token[0] != "begin")
-				{
-					G4cout << "unexpected line begins with " << token[0] << G4endl;
-				}
-				else // normal parsing begins here
+				fTruthSummary.SetTargetDir(event.target.dir[2], event.target.dir[1], event.target.dir[0]);
+			}
+
+			// Now the outgoing particles
+			// These we will simulate.
+			for (unsigned int t = 0; t < event.tracks.size(); ++t)
+			{
+				const WCSimVectorParticle &track = event.tracks[t];
+				// We are only interested in the particles
+				// that leave the nucleus, tagged by "0"
+				if (track.status == 0 && track.dir[0] != -999)
 				{
-					// Read the nuance line (ignore value now)
-					token = readInLine(inputFile, lineSize, inBuf);
-					// The nuance line contains the interaction mode. Bag it and tag it.
-					fTruthSummary.SetInteractionMode(atoi(token[1]));
-
-					// Read the Vertex line
-					token = readInLine(inputFile, lineSize, inBuf);
-					G4ThreeVector nuVtx = G4ThreeVector(atof(token[1]) * CLHEP::cm, atof(token[2]) * CLHEP::cm, atof(token[3]) * CLHEP::cm);
-					if (fUseXAxisForBeam)
-					{
-						nuVtx = G4ThreeVector(atof(token[3]) * CLHEP::cm, atof(token[2]) * CLHEP::cm, atof(token[1]) * CLHEP::cm);
-					}
-					if (fUseRandomVertex)
-					{
-						nuVtx = GenerateRandomVertex();
-					}
-					fTruthSummary.SetVertex(nuVtx.x(), nuVtx.y(), nuVtx.z());
-					double nuVtxT = GetBeamSpillEventTime();
-					fTruthSummary.SetVertexT(nuVtxT);
-
-					// true : Generate vertex in Rock , false : Generate vertex in WC tank
-					SetGenerateVertexInRock(false);
-
-					// Next we read the incoming neutrino and target
-					// First, the neutrino line
-					token = readInLine(inputFile, lineSize, inBuf);
-					fTruthSummary.SetBeamPDG(atoi(token[1]));
-					fTruthSummary.SetBeamEnergy(atof(token[2]) * CLHEP::MeV);
-					fTruthSummary.SetBeamDir(atof(token[3]), atof(token[4]), atof(token[5]));
-					if (fUseXAxisForBeam)
-					{
-						fTruthSummary.SetBeamDir(atof(token[5]), atof(token[4]), atof(token[3]));
-					}
-
-					// Now read the target line
-
-					token = readInLine(inputFile, lineSize, inBuf);
-					fTruthSummary.SetTargetPDG(atoi(token[1]));
-					fTruthSummary.SetTargetEnergy(atof(token[2]) * CLHEP::MeV);
-					fTruthSummary.SetTargetDir(atof(token[3]), atof(token[4]), atof(token[5]));
-					if (fUseXAxisForBeam)
-					{
-						fTruthSummary.SetTargetDir(atof(token[5]), atof(token[4]), atof(token[3]));
-					}
-
-					// Now read the outgoing particles
-					// These we will simulate.
-					while (token = readInLine(inputFile, lineSize, inBuf), token[0] == "track")
-					{
-						// We are only interested in the particles
-						// that leave the nucleus, tagged by "0"
-
-						// G4cout << "Token[6] = " << token[6] << std::endl;
-						if (token[6] == "0" && token[3] != "-999")
-						{
-							// Leigh Hack for Coh events with the nucleus in the final state
-							if (token[1] == "8016")
-								//token[1] = "1000080160";
-								continue;
-							if (token[1] == "1001")
-								//token[1] = "1000010010";
-								continue;
-							this->FireParticleGunFromTrackLine(anEvent, nuVtx, nuVtxT, token, fUseXAxisForBeam, false);
-						}
-					}
+					// Leigh Hack for Coh events with the nucleus in the final state
+					if (track.pdg == 8016 || track.pdg == 1001)
+						continue;
+					this->FireParticleGunFromTrack(anEvent, nuVtx, nuVtxT, track, fUseXAxisForBeam, false);
 				}
 			}
 		}
-		else
-		{ // old muline format
-			double nuEnergy, energy;
-			double xPos, yPos, zPos;
-			double xDir, yDir, zDir;
-			inputFile >> nuEnergy >> energy >> xPos >> yPos >> zPos >> xDir >> yDir >> zDir;
-
-			G4double random_z = ((myDetector->GetWaterTubePosition()) - .5 * (myDetector->GetWaterTubeLength()) + 1. * CLHEP::m + 15.0 * CLHEP::m * G4UniformRand()) / CLHEP::m;
-			zPos = random_z;
-			G4ThreeVector vtx = G4ThreeVector(xPos, yPos, zPos);
-			G4ThreeVector dir = G4ThreeVector(xDir, yDir, zDir);
-
-			particleGun->SetParticleEnergy(energy * CLHEP::MeV);
-			particleGun->SetParticlePosition(vtx);
-			particleGun->SetParticleMomentumDirection(dir);
-			particleGun->GeneratePrimaryVertex(anEvent);
-
-			// Leigh: Will likely never use this, but assume muon?
-			fTruthSummary.SetBeamPDG(13);
-			fTruthSummary.SetBeamEnergy(energy * CLHEP::MeV);
-			fTruthSummary.SetVertex(vtx.x(), vtx.y(), vtx.z());
-			fTruthSummary.SetVertexT(0.0);
-			fTruthSummary.SetBeamDir(dir.x(), dir.y(), dir.z());
-		}
 	}
 
 	else if (useNormalEvt)
@@ -273,56 +218,184 @@ void WCSimPrimaryGeneratorAction::GeneratePrimaries(G4Event *anEvent)
 	}
 }
 
-void WCSimPrimaryGeneratorAction::GenerateOverlayEvents(G4Event *evt)
+void WCSimPrimaryGeneratorAction::SkipVectorEvents(G4int nEvents)
 {
+	G4int nSkipped = fVectorReader->SkipEvents(nEvents);
+	while (nSkipped < nEvents)
+	{
+		// End of this file, move on to the next one if there is one
+		if (!LoadNextVectorFile())
+		{
+			break;
+		}
+		nSkipped += fVectorReader->SkipEvents(nEvents - nSkipped);
+	}
+}
 
-	// For overlay events we need to read from two different vector files.
-	const int lineSize = 100;
-	char inBuf[lineSize];
-	std::vector<std::string> token(1);
-	std::vector<std::string> overToken(1);
+void WCSimPrimaryGeneratorAction::SkipOverlayEvents(G4int nEvents)
+{
+	G4int nSkipped = fOverlayReader ? fOverlayReader->SkipEvents(nEvents) : 0;
+	while (nSkipped < nEvents)
+	{
+		if (!LoadNextOverlayFile())
+		{
+			break;
+		}
+		nSkipped += fOverlayReader->SkipEvents(nEvents - nSkipped);
+	}
+}
+
+void WCSimPrimaryGeneratorAction::FindEventRange(const std::vector<G4String> &files, G4int &startEvent,
+												 G4int &nEvents) const
+{
+	startEvent = fFirstEvent;
+	nEvents = -1;
+	if (fNShards <= 1)
+	{
+		return;
+	}
+
+	// Need the total number of events to share them out
+	long long total = 0;
+	for (unsigned int f = 0; f < files.size(); ++f)
+	{
+		WCSimVectorFileReader *reader = WCSimVectorFileReader::Create(files[f]);
+		if (reader->Open(files[f]) && reader->BuildIndex())
+		{
+			total += reader->GetNumberOfEvents();
+		}
+		delete reader;
+	}
+
+	long long available = std::max(0LL, total - fFirstEvent);
+	long long begin = available * fShardIndex / fNShards;
+	long long end = available * (fShardIndex + 1) / fNShards;
+	startEvent = fFirstEvent + begin;
+	nEvents = end - begin;
+}
+
+bool WCSimPrimaryGeneratorAction::MoveToVectorEvent(G4int eventID)
+{
+	if (!fVecRangeSet)
+	{
+		FindEventRange(vectorFileVec, fVecStartEvent, fVecNEvents);
+		fVecRangeSet = true;
+		G4cout << "Reading the vector files from event " << fVecStartEvent;
+		if (fVecNEvents >= 0)
+		{
+			G4cout << ", " << fVecNEvents << " events in shard " << fShardIndex << " of " << fNShards;
+		}
+		G4cout << G4endl;
+	}
+	// The event ID starts again at 0 on each /run/beamOn, so later runs carry
+	// on from the events already read rather than going back to the start
+	G4int event = std::max(fVecEventsRead, fVecStartEvent + eventID);
+	if (fVecNEvents >= 0 && event >= fVecStartEvent + fVecNEvents)
+	{
+		G4cout << "Event " << eventID << " is past the end of this shard of the vector files" << G4endl;
+		return false;
+	}
 
-	//  G4ParticleTable *particleTable = G4ParticleTable::GetParticleTable();
+	if (event > fVecEventsRead)
+	{
+		SkipVectorEvents(event - fVecEventsRead);
+	}
+	fVecEventsRead = event + 1;
+	return true;
+}
+
+bool WCSimPrimaryGeneratorAction::MoveToOverlayEvent(G4int eventID)
+{
+	if (!fOverlayRangeSet)
+	{
+		FindEventRange(fOverlayFileVec, fOverlayStartEvent, fOverlayNEvents);
+		fOverlayRangeSet = true;
+	}
+	// The event ID starts again at 0 on each /run/beamOn, so later runs carry
+	// on from the events already read rather than going back to the start
+	G4int event = std::max(fOverlayEventsRead, fOverlayStartEvent + eventID);
+	if (fOverlayNEvents >= 0 && event >= fOverlayStartEvent + fOverlayNEvents)
+	{
+		G4cout << "Event " << eventID << " is past the end of this shard of the overlay files" << G4endl;
+		return false;
+	}
+
+	if (event > fOverlayEventsRead)
+	{
+		SkipOverlayEvents(event - fOverlayEventsRead);
+	}
+	fOverlayEventsRead = event + 1;
+	return true;
+}
 
-	// Read the next line of the next event first.
-	token = readInLine(inputFile, lineSize, inBuf);
-	if (token.size() == 0)
+bool WCSimPrimaryGeneratorAction::ReadNextVectorEvent()
+{
+	if (fVectorReader->ReadEvent(fVectorEvent))
+	{
+		return true;
+	}
+	G4cout << "end of nuance vector file!" << G4endl;
+	while (LoadNextVectorFile())
 	{
-		G4cout << "end of nuance vector file!" << G4endl;
-		if (LoadNextVectorFile())
+		G4cout << "Loading next vector file" << G4endl;
+		if (fVectorReader->ReadEvent(fVectorEvent))
 		{
-			G4cout << "Loading next vector file" << G4endl;
-			token = readInLine(inputFile, lineSize, inBuf);
+			return true;
 		}
 	}
+	return false;
+}
 
-	// Now read the next line of the next overlay event.
-	overToken = readInLine(fOverlayFile, lineSize, inBuf);
-	if (overToken.size() == 0)
+bool WCSimPrimaryGeneratorAction::ReadNextOverlayEvent()
+{
+	if (fOverlayReader && fOverlayReader->ReadEvent(fOverlayEvent))
 	{
-		if (LoadNextOverlayFile())
+		return true;
+	}
+	while (LoadNextOverlayFile())
+	{
+		if (fOverlayReader->ReadEvent(fOverlayEvent))
 		{
-			overToken = readInLine(fOverlayFile, lineSize, inBuf);
+			return true;
 		}
 	}
+	return false;
+}
+
+void WCSimPrimaryGeneratorAction::GenerateOverlayEvents(G4Event *evt)
+{
+
+	// For overlay events we need to read from two different vector files.
+	if (!fVectorReader || !fVectorReader->IsOpen())
+	{
+		G4cout << "Set a vector file using the command /mygen/vecfile name" << G4endl;
+		return;
+	}
+
+	// Catch up with the event this thread has been given in both sets of files
+	if (!MoveToVectorEvent(evt->GetEventID()) || !MoveToOverlayEvent(evt->GetEventID()))
+	{
+		G4RunManager::GetRunManager()->AbortRun(true);
+		return;
+	}
 
-	// Check to see if we can read an event from each file.
-	if (overToken.size() == 0 || token.size() == 0)
+	// Read the next event and the next overlay event, checking we have one of each
+	bool haveEvent = ReadNextVectorEvent();
+	bool haveOverlay = ReadNextOverlayEvent();
+	if (!haveEvent || !haveOverlay)
 	{
-		std::cout << "Problem with overlay stuff: " << token.size() << ", " << overToken.size() << std::endl;
+		std::cout << "Problem with overlay stuff: " << haveEvent << ", " << haveOverlay << std::endl;
 		return;
 	}
 
 	std::cout << "Trying to read an overlay event" << std::endl;
 
-	// Now actually read the standard event
-	// The line we currently has is the "begin" line, so move on.
-	token = readInLine(inputFile, lineSize, inBuf);
+	// Now the standard event
+	const WCSimVectorEvent &event = fVectorEvent;
 	// The nuance line contains the interaction mode. Bag it and tag it.
-	fTruthSummary.SetInteractionMode(atoi(token[1]));
+	fTruthSummary.SetInteractionMode(event.mode);
 
-	// Read the vertex line.
-	token = readInLine(inputFile, lineSize, inBuf);
+	// The vertex
 	G4ThreeVector nuVtx;
 	if (fUseRandomVertex)
 	{
@@ -332,11 +405,11 @@ void WCSimPrimaryGeneratorAction::GenerateOverlayEvents(G4Event *evt)
 	{
 		if (fUseXAxisForBeam)
 		{
-			nuVtx = G4ThreeVector(atof(token[3]) * CLHEP::cm, atof(token[2]) * CLHEP::cm, atof(token[1]) * CLHEP::cm);
+			nuVtx = G4ThreeVector(event.vtx[2] * CLHEP::cm, event.vtx[1] * CLHEP::cm, event.vtx[0] * CLHEP::cm);
 		}
 		else
 		{
-			nuVtx = G4ThreeVector(atof(token[1]) * CLHEP::cm, atof(token[2]) * CLHEP::cm, atof(token[3]) * CLHEP::cm);
+			nuVtx = G4ThreeVector(event.vtx[0] * CLHEP::cm, event.vtx[1] * CLHEP::cm, event.vtx[2] * CLHEP::cm);
 		}
 	}
 	fTruthSummary.SetVertex(nuVtx.x(), nuVtx.y(), nuVtx.z());
@@ -345,98 +418,81 @@ void WCSimPrimaryGeneratorAction::GenerateOverlayEvents(G4Event *evt)
 	double nuVtxT = this->GetBeamSpillEventTime();
 	fTruthSummary.SetVertexT(nuVtxT);
 
-	// Next we read the incoming neutrino and target.
+	// Next the incoming neutrino and target.
 	// For all particles we swap x and z since GENIE assumes the beam is in the z-direction.
-	// First, the neutrino line
-	token = readInLine(inputFile, lineSize, inBuf);
-	fTruthSummary.SetBeamPDG(atoi(token[1]));
-	fTruthSummary.SetBeamEnergy(atof(token[2]) * CLHEP::MeV);
+	fTruthSummary.SetBeamPDG(event.beam.pdg);
+	fTruthSummary.SetBeamEnergy(event.beam.energy * CLHEP::MeV);
 	if (fUseXAxisForBeam)
 	{
-		fTruthSummary.SetBeamDir(atof(token[5]), atof(token[4]), atof(token[3]));
+		fTruthSummary.SetBeamDir(event.beam.dir[2], event.beam.dir[1], event.beam.dir[0]);
 	}
 	else
 	{
-		fTruthSummary.SetBeamDir(atof(token[3]), atof(token[4]), atof(token[5]));
+		fTruthSummary.SetBeamDir(event.beam.dir[0], event.beam.dir[1], event.beam.dir[2]);
 	}
 
-	// Now read the target line
-	token = readInLine(inputFile, lineSize, inBuf);
-	fTruthSummary.SetTargetPDG(atoi(token[1]));
-	fTruthSummary.SetTargetEnergy(atof(token[2]) * CLHEP::MeV);
+	fTruthSummary.SetTargetPDG(event.target.pdg);
+	fTruthSummary.SetTargetEnergy(event.target.energy * CLHEP::MeV);
 	if (fUseXAxisForBeam)
 	{
-		fTruthSummary.SetTargetDir(atof(token[5]), atof(token[4]), atof(token[3]));
+		fTruthSummary.SetTargetDir(event.target.dir[2], event.target.dir[1], event.target.dir[0]);
 	}
 	else
 	{
-		fTruthSummary.SetTargetDir(atof(token[5]), atof(token[4]), atof(token[3]));
+		fTruthSummary.SetTargetDir(event.target.dir[0], event.target.dir[1], event.target.dir[2]);
 	}
 
-	// Now read the outgoing particles
-	while (token = readInLine(inputFile, lineSize, inBuf), token[0] == "track")
+	// Now the outgoing particles
+	for (unsigned int t = 0; t < event.tracks.size(); ++t)
 	{
+		const WCSimVectorParticle &track = event.tracks[t];
 		// We are only interested in the particles that leave the nucleus, tagged by "0"
-		if (token[6] == "0" && atof(token[5]) > -999)
+		if (track.status == 0 && track.dir[2] > -999)
 		{
 			// Leigh Hack for Coh events with the nucleus in the final state
 			// Josh change: Just don't include the nucleons in the particle gun...
-			if (token[1] == "8016")
-				//token[1] = "1000080160";
-				continue;
-			if (token[1] == "1001")
-				//token[1] = "1000010010";
+			if (track.pdg == 8016 || track.pdg == 1001)
 				continue;
 			// Interface with the particle gun to generate the event
-			FireParticleGunFromTrackLine(evt, nuVtx, nuVtxT, token, fUseXAxisForBeam, false);
+			FireParticleGunFromTrack(evt, nuVtx, nuVtxT, track, fUseXAxisForBeam, false);
 		}
 	}
 
 	// We have made the standard event, now to deal with the cosmic event.
 	// These cosmics have dummy entries for the neutrino and target, so
 	// we want to ignore everything other than the muon.
-
-	// Currently on the "begin" line for the overlay, so read next.
-	overToken = readInLine(fOverlayFile, lineSize, inBuf); // Interaction code, ignore.
-	overToken = readInLine(fOverlayFile, lineSize, inBuf); // Vertex - need this!
-	G4ThreeVector cosmicVtx = G4ThreeVector(atof(overToken[1]) * CLHEP::cm, atof(overToken[2]) * CLHEP::cm, atof(overToken[3]) * CLHEP::cm);
+	const WCSimVectorEvent &overlay = fOverlayEvent;
+	G4ThreeVector cosmicVtx = G4ThreeVector(overlay.vtx[0] * CLHEP::cm, overlay.vtx[1] * CLHEP::cm, overlay.vtx[2] * CLHEP::cm);
 	fTruthSummary.SetOverlayVertex(cosmicVtx.x(), cosmicVtx.y(), cosmicVtx.z());
 	// We also want to define the cosmic to be at a different time.
 	// For now, assume flat distribution +/- 100ns from the event.
 	double cosmicTime = nuVtxT; // We will change this in FireParticleGun
 	fTruthSummary.SetOverlayVertexT(cosmicTime);
-	// Just read in the final state particle such that they have the last token equal to 0.
-	while (overToken = readInLine(fOverlayFile, lineSize, inBuf), overToken[0] == "track")
+	// Just use the final state particles, with status 0
+	for (unsigned int t = 0; t < overlay.tracks.size(); ++t)
 	{
-		if ((overToken[6] == "0") && atof(overToken[5]) > -999)
+		const WCSimVectorParticle &track = overlay.tracks[t];
+		if (track.status == 0 && track.dir[2] > -999)
 		{
 			// Leigh Hack for Coh events with the nucleus in the final state
-			if (overToken[1] == "8016")
-				//overToken[1] = "1000080160";
-				continue;
-			if (overToken[1] == "1001")
-				//overToken[1] = "1000010010";
+			if (track.pdg == 8016 || track.pdg == 1001)
 				continue;
 			// No need for XZ swaps with the cosmics overlays.
-			FireParticleGunFromTrackLine(evt, cosmicVtx, cosmicTime, overToken, false, true);
+			FireParticleGunFromTrack(evt, cosmicVtx, cosmicTime, track, false, true);
 		}
 	}
 }
 
 // Set up the particle gun for all tracks in vector files (including overlays).
-void WCSimPrimaryGeneratorAction::FireParticleGunFromTrackLine(G4Event *evt, G4ThreeVector &vtx, double &vtxTime,
-															   std::vector<std::string> &tokens, bool swapXZ, bool isOverlay)
+void WCSimPrimaryGeneratorAction::FireParticleGunFromTrack(G4Event *evt, G4ThreeVector &vtx, double &vtxTime,
+														   const WCSimVectorParticle &track, bool swapXZ, bool isOverlay)
 {
 
-	// Double check the first token is actually a track.
-	if (tokens[0] != "track")
-		return;
-
 	G4ParticleTable *particleTable = G4ParticleTable::GetParticleTable();
 
-	G4int pdgid = atoi(tokens[1]);
-	G4double energy = atof(tokens[2]) * CLHEP::MeV;
-	G4ThreeVector dir = G4ThreeVector(atof(tokens[3]), atof(tokens[4]), atof(tokens[5]));
+	G4int pdgid = track.pdg;
+	G4double energy = track.energy * CLHEP::MeV;
+	G4ThreeVector dir = G4ThreeVector(track.dir[0], track.dir[1], track.dir[2]);
 
 	if (swapXZ)
 	{
@@ -526,77 +582,149 @@ G4ThreeVector WCSimPrimaryGeneratorAction::GenerateRandomVertex() const
 bool WCSimPrimaryGeneratorAction::UpdateOverlayVertexAndEnergy(G4ThreeVector &vtx, double &timeOffset,
 															   G4ThreeVector dir, double &energy)
 {
+	G4ThreeVector newVtx = vtx;
+	if (!FindOverlayEntry(newVtx, dir))
+	{
+		return false;
+	}
+
+	double dist = (newVtx - vtx).mag(); // In mm
+	double muonSpeed = 2.9979e8 * CLHEP::m / CLHEP::s;
+	energy -= dist * 2.0 / CLHEP::cm; // Assume 2.0 CLHEP::MeV/CLHEP::cm energy loss
+	timeOffset = dist / muonSpeed;
+	if (energy > 0)
+	{
+		vtx = newVtx;
+		return true;
+	}
+	return false;
+}
+
+void WCSimPrimaryGeneratorAction::SetOverlayDetectorShape()
+{
+	// The PMTs span WCCylInfo (cm) in each direction. The sides of the prism face
+	// the x axis, so half the x span is the distance to the middle of a side.
+	WCSimCherenkovBuilder *builder = dynamic_cast<WCSimCherenkovBuilder *>(myDetector);
+	fDetectorSides = (builder && !myDetector->GetIsMailbox()) ? builder->GetGeoConfig()->GetNSides() : 0;
+	fDetectorRadius = 0.5 * myDetector->GetWCCylInfo(0) * CLHEP::cm;
+	fDetectorHalfHeight = 0.5 * myDetector->GetWCCylInfo(2) * CLHEP::cm;
+	fDetectorShapeSet = true;
+}
+
+bool WCSimPrimaryGeneratorAction::FindOverlayEntry(G4ThreeVector &vtx, const G4ThreeVector &dir)
+{
+	if (!fDetectorShapeSet)
+	{
+		SetOverlayDetectorShape();
+	}
 
-	G4ThreeVector newVtx;
+	double tEnter = 0., tExit = 0.;
+	if (!WCSimPolygonTools::IntersectPrism(fDetectorSides, fDetectorRadius, fDetectorHalfHeight, 0., vtx, dir, tEnter,
+										   tExit))
+	{
+		return false;
+	}
 
-	bool withinDet = false;
-	// Use vector algebra.
-	// Firstly, find the position of the track at the top of the detector.
-	double detTop = 0.5 * myDetector->GetWCCylInfo(2) * CLHEP::cm;
+	// Take the highest point of the track inside the detector, which is where a
+	// down going muon enters, as the stepping method did
+	vtx = vtx + ((dir.z() > 0.) ? tExit : tEnter) * dir;
+	return true;
+}
+
+bool WCSimPrimaryGeneratorAction::FindOverlayEntryByStepping(G4ThreeVector &vtx, const G4ThreeVector &dir)
+{
+	if (!fDetectorShapeSet)
+	{
+		SetOverlayDetectorShape();
+	}
+
+	// PolygonContains has a corner at theta = 0, so turn the points by half a side
+	double outerRadius = (fDetectorSides > 0)
+							 ? WCSimPolygonTools::GetOuterRadiusFromInner(fDetectorSides, fDetectorRadius)
+							 : fDetectorRadius;
+	double detTop = fDetectorHalfHeight;
 	// Check over the detector height to see if we are in the detector.
 	for (int i = 0; i < 2 * (int)detTop; ++i)
 	{
 		double thisZ = detTop - i;
-		newVtx = vtx + ((thisZ - vtx.z()) / dir.z()) * dir;
-		double planeR = sqrt(newVtx.x() * newVtx.x() + newVtx.y() * newVtx.y());
-		//    std::cout << "Testing position " << newVtx.x() << ", " << newVtx.y() << ", " << newVtx.z() << " :: " << planeR << ", " << newVtx.r() << std::endl;
-		if (planeR < (0.5 * myDetector->GetWCCylInfo(0) * CLHEP::cm))
+		G4ThreeVector newVtx = vtx + ((thisZ - vtx.z()) / dir.z()) * dir;
+		G4TwoVector planePos(newVtx.x(), newVtx.y());
+		bool inside = false;
+		if (fDetectorSides > 0)
 		{
-			withinDet = true;
-			break;
+			planePos.rotate(-M_PI / fDetectorSides);
+			inside = WCSimPolygonTools::PolygonContains(fDetectorSides, outerRadius, planePos);
 		}
-	}
-	bool energyOK = false;
-	if (withinDet)
-	{
-		double dist = (newVtx - vtx).mag(); // In mm
-		double muonSpeed = 2.9979e8 * CLHEP::m / CLHEP::s;
-		energy -= dist * 2.0 / CLHEP::cm; // Assume 2.0 CLHEP::MeV/CLHEP::cm energy loss
-		timeOffset = dist / muonSpeed;
-		if (energy > 0)
+		else
+		{
+			inside = planePos.mag() < fDetectorRadius;
+		}
+		if (inside)
 		{
-			energyOK = true;
 			vtx = newVtx;
+			return true;
 		}
 	}
-
-	if (withinDet && energyOK)
-		return true;
-	else
-		return false;
+	return false;
 }
 
-// Returns a vector with the tokens
-vector<string> tokenize(string separators, string input)
+void WCSimPrimaryGeneratorAction::BenchmarkOverlayEntry(G4int nTracks)
 {
-	std::size_t startToken = 0, endToken; // Pointers to the token pos
-	vector<string> tokens;				  // Vector to keep the tokens
-
-	if (separators.size() > 0 && input.size() > 0)
+	SetOverlayDetectorShape();
+	G4cout << "WCSimPrimaryGeneratorAction::BenchmarkOverlayEntry: " << nTracks << " muons, detector with "
+		   << fDetectorSides << " sides, radius " << fDetectorRadius / CLHEP::m << " m and height "
+		   << 2. * fDetectorHalfHeight / CLHEP::m << " m" << G4endl;
+
+	// Down going muons starting 10m above the detector over an area twice its size
+	std::vector<G4ThreeVector> starts(nTracks);
+	std::vector<G4ThreeVector> dirs(nTracks);
+	for (G4int t = 0; t < nTracks; ++t)
 	{
+		starts[t] = G4ThreeVector((G4UniformRand() - 0.5) * 4. * fDetectorRadius,
+								  (G4UniformRand() - 0.5) * 4. * fDetectorRadius, fDetectorHalfHeight + 10. * CLHEP::m);
+		double cosTheta = 0.2 + 0.8 * G4UniformRand();
+		double sinTheta = std::sqrt(1. - cosTheta * cosTheta);
+		double phi = 2. * M_PI * G4UniformRand();
+		dirs[t] = G4ThreeVector(sinTheta * cos(phi), sinTheta * sin(phi), -cosTheta);
+	}
 
-		while (startToken < input.size())
-		{
-			// Find the start of token
-			startToken = input.find_first_not_of(separators, startToken);
+	std::vector<G4ThreeVector> analytic(starts), stepped(starts);
+	std::vector<bool> analyticHit(nTracks), steppedHit(nTracks);
 
-			// If found...
-			if (startToken != input.npos)
-			{
-				// Find end of token
-				endToken = input.find_first_of(separators, startToken);
-				if (endToken == input.npos)
-					// If there was no end of token, assign it to the end of string
-					endToken = input.size();
+	std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+	for (G4int t = 0; t < nTracks; ++t)
+	{
+		analyticHit[t] = FindOverlayEntry(analytic[t], dirs[t]);
+	}
+	double analyticTime = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count();
 
-				// Extract token
-				tokens.push_back(input.substr(startToken, endToken - startToken));
+	begin = std::chrono::steady_clock::now();
+	for (G4int t = 0; t < nTracks; ++t)
+	{
+		steppedHit[t] = FindOverlayEntryByStepping(stepped[t], dirs[t]);
+	}
+	double steppedTime = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count();
 
-				// Update startToken
-				startToken = endToken;
-			}
+	// The stepping finds the entry to within one step in z, so a track can only
+	// disagree if it passes within about that distance of an edge
+	G4int nHit = 0, nMismatch = 0;
+	double maxDistance = 0.;
+	for (G4int t = 0; t < nTracks; ++t)
+	{
+		if (analyticHit[t] != steppedHit[t])
+		{
+			++nMismatch;
+		}
+		else if (analyticHit[t])
+		{
+			++nHit;
+			maxDistance = std::max(maxDistance, std::fabs((analytic[t] - stepped[t]).z()));
 		}
 	}
 
-	return tokens;
+	G4cout << "  " << nHit << " muons hit the detector, " << nMismatch
+		   << " disagree about whether they hit it, largest difference in entry height " << maxDistance / CLHEP::mm
+		   << " mm" << G4endl;
+	G4cout << "  Analytic: " << analyticTime / nTracks << " us per muon, stepping: " << steppedTime / nTracks
+		   << " us per muon" << G4endl;
 }
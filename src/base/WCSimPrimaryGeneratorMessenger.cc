@@ -4,8 +4,11 @@
 #include "G4UIcmdWithAString.hh"
 #include "G4UIcmdWithABool.hh"
 #include "G4UIcmdWithADouble.hh"
+#include "G4UIcmdWithAnInteger.hh"
 #include "G4ios.hh"
 
+#include <cstdio>
+
 WCSimPrimaryGeneratorMessenger::WCSimPrimaryGeneratorMessenger(WCSimPrimaryGeneratorAction *pointerToAction) : myAction(pointerToAction)
 {
 	mydetDirectory = new G4UIdirectory("/mygen/");
@@ -23,6 +26,7 @@ WCSimPrimaryGeneratorMessenger::WCSimPrimaryGeneratorMessenger(WCSimPrimaryGener
 	fileNameCmd = new G4UIcmdWithAString("/mygen/vecfile", this);
 	fileNameCmd->SetGuidance("Select the file of vectors.");
 	fileNameCmd->SetGuidance(" Enter the file name of the vector file");
+	fileNameCmd->SetGuidance(" Files ending .vecb are read as binary files made by vectorconvert");
 	fileNameCmd->SetParameterName("fileName", true);
 	fileNameCmd->SetDefaultValue("inputvectorfile");
 
@@ -52,11 +56,39 @@ WCSimPrimaryGeneratorMessenger::WCSimPrimaryGeneratorMessenger(WCSimPrimaryGener
 							" - Default value is true.");
 	fSwapXZCmd->SetParameterName("useXAxisForBeam", true);
 	fSwapXZCmd->SetDefaultValue(true);
+
+	fFirstEventCmd = new G4UIcmdWithAnInteger("/mygen/firstEvent", this);
+	fFirstEventCmd->SetGuidance("Number of the first event to read from the vector and overlay files\n"
+								" - Counts from 0 across all the files added with /mygen/vecfile.\n"
+								" - Default value is 0.");
+	fFirstEventCmd->SetParameterName("firstEvent", true);
+	fFirstEventCmd->SetDefaultValue(0);
+	fFirstEventCmd->SetRange("firstEvent >= 0");
+
+	fShardCmd = new G4UIcmdWithAString("/mygen/shard", this);
+	fShardCmd->SetGuidance("Read only part i/N of the events in the vector and overlay files\n"
+						   " - The events after /mygen/firstEvent are split into N equal ranges.\n"
+						   " - i counts from 0, so N jobs use 0/N to (N-1)/N.\n"
+						   " - Later /run/beamOn commands in the same job carry on through the shard, never past its end.\n"
+						   " - Counting the events reads each text file once and caches an index as <file>.idx.");
+	fShardCmd->SetParameterName("shard", false);
+
+	fBenchmarkOverlayCmd = new G4UIcmdWithAnInteger("/mygen/benchmarkOverlayEntry", this);
+	fBenchmarkOverlayCmd->SetGuidance("Find where this many random cosmic muons enter the detector, with the analytic\n"
+									  "method used for the overlays and with the old 1mm stepping, and compare them.\n"
+									  " - Prints the number of disagreements and the time per muon of each method.");
+	fBenchmarkOverlayCmd->SetParameterName("nMuons", true);
+	fBenchmarkOverlayCmd->SetDefaultValue(10000);
+	fBenchmarkOverlayCmd->SetRange("nMuons > 0");
+	fBenchmarkOverlayCmd->AvailableForStates(G4State_Idle);
 }
 
 WCSimPrimaryGeneratorMessenger::~WCSimPrimaryGeneratorMessenger()
 {
 	delete genCmd;
+	delete fFirstEventCmd;
+	delete fShardCmd;
+	delete fBenchmarkOverlayCmd;
 	delete mydetDirectory;
 }
 
@@ -132,6 +164,27 @@ void WCSimPrimaryGeneratorMessenger::SetNewValue(G4UIcommand *command, G4String
 		}
 		myAction->SetUseXAxisForBeam(val);
 	}
+	if (command == fFirstEventCmd)
+	{
+		myAction->SetFirstEvent(fFirstEventCmd->GetNewIntValue(newValue));
+	}
+	if (command == fShardCmd)
+	{
+		int index = -1;
+		int nShards = 0;
+		if (sscanf(newValue.c_str(), "%d/%d", &index, &nShards) != 2 || nShards < 1 || index < 0 ||
+			index >= nShards)
+		{
+			G4cout << "/mygen/shard needs to be i/N with 0 <= i < N, not " << newValue << G4endl;
+			return;
+		}
+		myAction->SetShard(index, nShards);
+		G4cout << "Reading shard " << index << " of " << nShards << " from the vector files" << G4endl;
+	}
+	if (command == fBenchmarkOverlayCmd)
+	{
+		myAction->BenchmarkOverlayEntry(fBenchmarkOverlayCmd->GetNewIntValue(newValue));
+	}
 }
 
 G4String WCSimPrimaryGeneratorMessenger::GetCurrentValue(G4UIcommand *command)
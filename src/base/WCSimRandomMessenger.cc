@@ -8,7 +8,7 @@
 
 WCSimRandomMessenger::WCSimRandomMessenger(WCSimRandomParameters *WCRandomPars) : WCSimRandomParams(WCRandomPars)
 {
-	WCSimDir = new G4UIdirectory("/WCSim/random/");
+	WCSimDir = new G4UIdirectory("/WCSim/random/", false);
 	WCSimDir->SetGuidance("Commands to set the random number generator parameters");
 
 	Rangen = new G4UIcmdWithAString("/WCSim/random/generator", this);
@@ -6,6 +6,8 @@
 #include "TProcessID.h"
 #include <string>
 #include <vector>
+#include <algorithm>
+#include <cstring>
 
 #include <TStopwatch.h>
 #include "WCSimRootEvent.hh"
@@ -21,6 +23,50 @@ ClassImp(WCSimRootTrigger)
 ClassImp(WCSimRootEvent)
 #endif
 
+namespace
+{
+// Map the bits of a float to an unsigned int in the same order, so that the
+// steps between ordered times are small positive integers
+UInt_t TimeToKey(Float_t time)
+{
+	UInt_t bits;
+	std::memcpy(&bits, &time, sizeof(bits));
+	return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+Float_t KeyToTime(UInt_t key)
+{
+	UInt_t bits = (key & 0x80000000u) ? (key & 0x7fffffffu) : ~key;
+	Float_t time;
+	std::memcpy(&time, &bits, sizeof(time));
+	return time;
+}
+
+// Seven bits per byte, with the top bit set on all but the last byte
+void PutVarint(std::vector<UChar_t> &bytes, UInt_t value)
+{
+	while (value >= 0x80)
+	{
+		bytes.push_back((value & 0x7f) | 0x80);
+		value >>= 7;
+	}
+	bytes.push_back(value);
+}
+
+UInt_t GetVarint(const std::vector<UChar_t> &bytes, size_t &pos)
+{
+	UInt_t value = 0;
+	int shift = 0;
+	while (bytes[pos] & 0x80)
+	{
+		value |= static_cast<UInt_t>(bytes[pos++] & 0x7f) << shift;
+		shift += 7;
+	}
+	value |= static_cast<UInt_t>(bytes[pos++]) << shift;
+	return value;
+}
+} // namespace
+
 	//TClonesArray* WCSimRootTrigger::fgTracks = 0;
 	//
 	//TClonesArray* WCSimRootTrigger::fgCherenkovHits = 0;
@@ -58,15 +104,15 @@ ClassImp(WCSimRootEvent)
 	IsZombie = true;
 }
 
-WCSimRootTrigger::WCSimRootTrigger(int Number, int Subevt)
+WCSimRootTrigger::WCSimRootTrigger(int Number, int Subevt, int capacity)
 {
-	this->Initialize();
+	this->Initialize(capacity);
 	fEvtHdr.Set(Number, 0, 0, Subevt);
 }
 
 //copy constructor --> only shallow copy of preallocated objects ??
 
-void WCSimRootTrigger::Initialize() //actually allocate memory for things in here
+void WCSimRootTrigger::Initialize(int capacity) //actually allocate memory for things in here
 {
 	// Create an WCSimRootTrigger object.
 	// When the constructor is invoked for the first time, the class static
@@ -75,17 +121,17 @@ void WCSimRootTrigger::Initialize() //actually allocate memory for things in her
 	TStopwatch *mystopw = new TStopwatch();
 
 	// TClonesArray of WCSimRootTracks
-	fTracks = new TClonesArray("WCSimRootTrack", 10000);
+	fTracks = new TClonesArray("WCSimRootTrack", capacity);
 	fNtrack = 0;
 
 	// TClonesArray of WCSimRootCherenkovHits
-	fCherenkovHits = new TClonesArray("WCSimRootCherenkovHit", 10000);
-	fCherenkovHitTimes = new TClonesArray("WCSimRootCherenkovHitTime", 10000);
+	fCherenkovHits = new TClonesArray("WCSimRootCherenkovHit", capacity);
+	fCherenkovHitTimes = new TClonesArray("WCSimRootCherenkovHitTime", capacity);
 	fNcherenkovhits = 0;
 	fNcherenkovhittimes = 0;
 
 	// TClonesArray of WCSimRootCherenkovDigiHits
-	fCherenkovDigiHits = new TClonesArray("WCSimRootCherenkovDigiHit", 10000);
+	fCherenkovDigiHits = new TClonesArray("WCSimRootCherenkovDigiHit", capacity);
 	fNcherenkovdigihits = 0;
 	fSumQ = 0;
 
@@ -138,6 +184,21 @@ void WCSimRootTrigger::Clear(Option_t *)
 	// the indices to 0 in the TCAs.
 	fNtrack = 0;
 
+	// The sub-event triggers are kept for the next event, so the truth that
+	// is only set for some events mustn't be carried over
+	fMode = 0;
+	fVtxvol = 0;
+	for (int i = 0; i < 3; i++)
+	{
+		fVtx[i] = 0;
+	}
+	fVecRecNumber = 0;
+	fJmu = 0;
+	fJp = 0;
+	fNpar = 0;
+	fCherenkovHitCounter = 0;
+	fPi0.Clear();
+
 	// TClonesArray of WCSimRootCherenkovHits
 	fNcherenkovhits = 0;
 	fNcherenkovhittimes = 0;
@@ -145,20 +206,39 @@ void WCSimRootTrigger::Clear(Option_t *)
 	// TClonesArray of WCSimRootCherenkovDigiHits
 	fNcherenkovdigihits = 0;
 	fSumQ = 0;
+	fNumTubesHit = 0;
+	fNumDigitizedTubes = 0;
 
 	// remove whatever's in the arrays
-	// but don't deallocate the arrays themselves
-
-	fTracks->Delete();
-	fCherenkovHits->Delete();
-	fCherenkovHitTimes->Delete();
-	fCherenkovDigiHits->Delete();
+	// but don't deallocate the arrays themselves.
+	// None of the hit classes own any memory, so the objects are kept as well
+	// and constructed in place again when the next event is filled.
+
+	fTracks->Clear("C");
+	fCherenkovHits->Clear("C");
+	fCherenkovHitTimes->Clear("C");
+	fCherenkovDigiHits->Clear("C");
+	fPackedTubeID.clear();
+	fPackedNumPe.clear();
+	fPackedTimes.clear();
+	fPackedParentID.clear();
+	fPackedParentRun.clear();
 
 	IsZombie = false; // we DO NOT deallocate the memory
 }
 
 //_____________________________________________________________________________
 
+void WCSimRootTrigger::ClearDigits()
+{
+	fNcherenkovdigihits = 0;
+	fNumDigitizedTubes = 0;
+	fSumQ = 0;
+	fCherenkovDigiHits->Clear("C");
+}
+
+//_____________________________________________________________________________
+
 void WCSimRootTrigger::Reset(Option_t *)
 {
 	// Static function to reset all static objects for this event
@@ -200,6 +280,24 @@ void WCSimRootPi0::Set(Float_t pi0Vtx[3], Int_t gammaID[2], Float_t gammaE[2], F
 
 //_____________________________________________________________________________
 
+void WCSimRootPi0::Clear(Option_t *)
+{
+	for (int i = 0; i < 2; i++)
+	{
+		fGammaID[i] = 0;
+		fGammaE[i] = 0;
+	}
+
+	for (int j = 0; j < 3; j++)
+	{
+		fPi0Vtx[j] = 0;
+		fGammaVtx[0][j] = 0;
+		fGammaVtx[1][j] = 0;
+	}
+}
+
+//_____________________________________________________________________________
+
 WCSimRootTrack *WCSimRootTrigger::AddTrack(Int_t ipnu, Int_t flag, Float_t m, Float_t p, Float_t E, Int_t startvol,
 										   Int_t stopvol, Float_t dir[3], Float_t pdir[3], Float_t stop[3], Float_t start[3], Int_t parenttype,
 										   Float_t time, Int_t id, Int_t parentId)
@@ -248,8 +346,8 @@ WCSimRootTrack::WCSimRootTrack(Int_t ipnu, Int_t flag, Float_t m, Float_t p, Flo
 
 //_____________________________________________________________________________
 
-WCSimRootCherenkovHit *WCSimRootTrigger::AddCherenkovHit(Int_t tubeID, std::vector<Float_t> truetime,
-														 std::vector<Int_t> primParID)
+WCSimRootCherenkovHit *WCSimRootTrigger::AddCherenkovHit(Int_t tubeID, const std::vector<Float_t> &truetime,
+														 const std::vector<Int_t> &primParID)
 {
 	// Add a new Cherenkov hit to the list of Cherenkov hits
 	TClonesArray &cherenkovhittimes = *fCherenkovHitTimes;
@@ -274,6 +372,97 @@ WCSimRootCherenkovHit *WCSimRootTrigger::AddCherenkovHit(Int_t tubeID, std::vect
 }
 //_____________________________________________________________________________
 
+void WCSimRootTrigger::AddPackedCherenkovHit(Int_t tubeID, const std::vector<Float_t> &truetime,
+											 const std::vector<Int_t> &primParID)
+{
+	// The hit times are usually sorted already by the digitizer
+	fPackOrder.resize(truetime.size());
+	for (unsigned int i = 0; i < truetime.size(); ++i)
+	{
+		fPackOrder[i] = i;
+	}
+	if (!std::is_sorted(truetime.begin(), truetime.end()))
+	{
+		std::stable_sort(fPackOrder.begin(), fPackOrder.end(),
+						 [&truetime](UInt_t a, UInt_t b) { return truetime[a] < truetime[b]; });
+	}
+
+	// Runs of parent IDs stop at the end of the tube, so each tube can be read alone
+	UInt_t lastKey = 0;
+	for (unsigned int i = 0; i < fPackOrder.size(); ++i)
+	{
+		UInt_t key = TimeToKey(truetime[fPackOrder[i]]);
+		PutVarint(fPackedTimes, key - lastKey);
+		lastKey = key;
+
+		Int_t parent = primParID[fPackOrder[i]];
+		if (i > 0 && parent == fPackedParentID.back())
+		{
+			++fPackedParentRun.back();
+		}
+		else
+		{
+			fPackedParentID.push_back(parent);
+			fPackedParentRun.push_back(1);
+		}
+	}
+
+	fPackedTubeID.push_back(tubeID);
+	fPackedNumPe.push_back(truetime.size());
+}
+
+//_____________________________________________________________________________
+
+void WCSimRootTrigger::GetRawHits(std::vector<Int_t> &tubeIDs, std::vector<Int_t> &numPe, std::vector<Float_t> &times,
+								  std::vector<Int_t> &parentIDs) const
+{
+	tubeIDs.clear();
+	numPe.clear();
+	times.clear();
+	parentIDs.clear();
+
+	if (!fPackedTubeID.empty())
+	{
+		tubeIDs = fPackedTubeID;
+		numPe = fPackedNumPe;
+		size_t pos = 0;
+		unsigned int run = 0;
+		Int_t runLeft = 0;
+		for (unsigned int t = 0; t < fPackedTubeID.size(); ++t)
+		{
+			UInt_t key = 0;
+			for (Int_t p = 0; p < fPackedNumPe[t]; ++p)
+			{
+				key += GetVarint(fPackedTimes, pos);
+				times.push_back(KeyToTime(key));
+				if (runLeft == 0)
+				{
+					runLeft = fPackedParentRun[run++];
+				}
+				parentIDs.push_back(fPackedParentID[run - 1]);
+				--runLeft;
+			}
+		}
+		return;
+	}
+
+	// Files written before the packed form, one object per photon
+	for (int h = 0; h < fNcherenkovhits; ++h)
+	{
+		WCSimRootCherenkovHit *hit = (WCSimRootCherenkovHit *)fCherenkovHits->At(h);
+		tubeIDs.push_back(hit->GetTubeID());
+		numPe.push_back(hit->GetTotalPe(1));
+		for (int p = 0; p < hit->GetTotalPe(1); ++p)
+		{
+			WCSimRootCherenkovHitTime *hitTime = (WCSimRootCherenkovHitTime *)fCherenkovHitTimes->At(hit->GetTotalPe(0) + p);
+			times.push_back(hitTime->GetTruetime());
+			parentIDs.push_back(hitTime->GetParentID());
+		}
+	}
+}
+
+//_____________________________________________________________________________
+
 WCSimRootCherenkovHit::WCSimRootCherenkovHit(Int_t tubeID, Int_t totalPe[2])
 {
 	// Create a WCSimRootCherenkovHitIndex object and fill it with stuff
@@ -322,6 +511,8 @@ WCSimRootEvent::WCSimRootEvent()
 	// it will be lost
 	fEventList = 0;
 	Current = 0;
+	fReuseTriggers = true;
+	fCapacityHint = 1000;
 }
 
 void WCSimRootEvent::Initialize()
@@ -331,6 +522,84 @@ void WCSimRootEvent::Initialize()
 	Current = 0;
 }
 
+void WCSimRootEvent::AddSubEvent()
+{
+	// be sure not to call the default constructor BUT the actual one
+	WCSimRootTrigger *tmp = dynamic_cast<WCSimRootTrigger *>((*fEventList)[0]);
+	int num = tmp->GetHeader()->GetEvtNum();
+	++Current;
+	if (Current > 9)
+		fEventList->Expand(20);
+
+	WCSimRootTrigger *trigger = 0;
+	if (!fTriggerPool.empty())
+	{
+		// Already cleared in ReInitialize
+		trigger = fTriggerPool.back();
+		fTriggerPool.pop_back();
+		trigger->SetHeader(num, 0, 0, Current);
+	}
+	else
+	{
+		trigger = new WCSimRootTrigger(num, Current, fCapacityHint);
+	}
+	fEventList->AddAt(trigger, Current);
+}
+
+void WCSimRootEvent::ReInitialize()
+{ // need to remove all subevents at the end, or they just get added anyway...
+	for (int i = fEventList->GetLast(); i >= 0; i--)
+	{
+		WCSimRootTrigger *tmp = dynamic_cast<WCSimRootTrigger *>((*fEventList)[i]);
+
+		// Size new triggers for the busiest trigger seen so far, rounded up to
+		// the next power of two so the hint only changes a few times per run
+		Int_t size = std::max(tmp->GetNcherenkovdigihits(), tmp->GetNcherenkovhits());
+		while (fCapacityHint < size)
+		{
+			fCapacityHint *= 2;
+		}
+
+		if (i == 0)
+		{
+			tmp->Clear();
+			break;
+		}
+
+		fEventList->RemoveAt(i);
+		if (fReuseTriggers)
+		{
+			tmp->Clear("C");
+			fTriggerPool.push_back(tmp);
+		}
+		else
+		{
+			delete tmp;
+		}
+	}
+	Current = 0;
+}
+
+void WCSimRootEvent::ClearDigits()
+{
+	for (int i = fEventList->GetLast(); i > 0; i--)
+	{
+		WCSimRootTrigger *tmp = dynamic_cast<WCSimRootTrigger *>((*fEventList)[i]);
+		fEventList->RemoveAt(i);
+		if (fReuseTriggers)
+		{
+			tmp->Clear("C");
+			fTriggerPool.push_back(tmp);
+		}
+		else
+		{
+			delete tmp;
+		}
+	}
+	Current = 0;
+	GetTrigger(0)->ClearDigits();
+}
+
 WCSimRootEvent::~WCSimRootEvent()
 {
 	if (fEventList != 0)
@@ -341,6 +610,10 @@ WCSimRootEvent::~WCSimRootEvent()
 		}
 		delete fEventList;
 	}
+	for (unsigned int i = 0; i < fTriggerPool.size(); i++)
+	{
+		delete fTriggerPool[i];
+	}
 }
 
 void WCSimRootEvent::Clear(Option_t *)
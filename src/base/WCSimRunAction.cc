@@ -2,6 +2,11 @@
 #include "WCSimRunActionMessenger.hh"
 
 #include "G4Run.hh"
+#include "G4RunManager.hh"
+#include "G4Threading.hh"
+#ifdef G4MULTITHREADED
+#include "G4MTRunManager.hh"
+#endif
 #include "G4UImanager.hh"
 #include "G4VVisManager.hh"
 #include "G4ios.hh"
@@ -14,6 +19,8 @@
 #include "TTree.h"
 #include "TBranch.h"
 #include "TStreamerInfo.h"
+#include "TFileMerger.h"
+#include "TSystem.h"
 #include "WCSimRootEvent.hh"
 #include "WCSimRootGeom.hh"
 #include "WCSimPmtInfo.hh"
@@ -21,8 +28,11 @@
 #include "WCSimPMTManager.hh"
 #include "WCSimPMTConfig.hh"
 #include "WCSimEmissionProfileMaker.hh"
+#include "WCSimFlatNtuple.hh"
 
 #include <vector>
+#include <sstream>
+#include <algorithm>
 
 int pawc_[500000]; // Declare the PAWC common
 
@@ -30,6 +40,17 @@ WCSimRunAction::WCSimRunAction(WCSimDetectorConstruction *test)
 {
 	ntuples = 1;
 
+	// Output defaults, can be changed with the messenger
+	PhotonNtuplePrescale = 1;
+	AutoSaveEvents = 0;
+	AutoSaveMBytes = 100;
+	BasketSize = 64000;
+	CompressionLevel = 2;
+	MergeThreadFiles = true;
+	SaveFlatNtuple = false;
+	SaveRawHits = false;
+	fFlatNtuple = 0;
+
 	// Messenger to allow IO options
 	wcsimdetector = test;
 	messenger = new WCSimRunActionMessenger(this);
@@ -55,16 +76,34 @@ void WCSimRunAction::BeginOfRunAction(const G4Run *aRun)
 	// MF, aug 2006 ... you never know...
 	WCSimRootTrigger::Class()->GetStreamerInfo()->Optimize(kFALSE);
 
+	// In multithreaded mode the workers write the events, so the master only
+	// needs to time the run and merge the files at the end.
+	if (IsMultithreadedMaster())
+	{
+		runStartTime = std::chrono::steady_clock::now();
+		return;
+	}
+
 	// Create the Root file
 
 	// Now controlled by the messenger
 
-	G4String rootname = GetRootFileName();
+	G4String rootname = GetThreadFileName(GetRootFileName());
 	TFile *hfile = new TFile(rootname.c_str(), "RECREATE", "WCSim ROOT file");
-	hfile->SetCompressionLevel(2);
+	hfile->SetCompressionLevel(CompressionLevel);
 
 	// Event tree
 	TTree *tree = new TTree("wcsimT", "WCSim Tree");
+	// ROOT saves the tree header itself when it passes the watermark: a
+	// positive value is a number of entries, a negative one a number of bytes.
+	if (AutoSaveEvents > 0)
+	{
+		tree->SetAutoSave(AutoSaveEvents);
+	}
+	else
+	{
+		tree->SetAutoSave(-1000000LL * AutoSaveMBytes);
+	}
 
 	SetTree(tree);
 	wcsimrootsuperevent = new WCSimRootEvent(); //empty list
@@ -72,7 +111,7 @@ void WCSimRunAction::BeginOfRunAction(const G4Run *aRun)
 	wcsimrootsuperevent->Initialize(); // make at least one event
 	Int_t branchStyle = 1;			   //new style by default
 	TTree::SetBranchStyle(branchStyle);
-	Int_t bufsize = 64000;
+	Int_t bufsize = BasketSize;
 
 	//  TBranch *branch = tree->Branch("wcsimrootsuperevent", "Jhf2kmrootsuperevent", &wcsimrootsuperevent, bufsize,0);
 	TBranch *branch = tree->Branch("wcsimrootevent", "WCSimRootEvent", &wcsimrootsuperevent, bufsize, 2);
@@ -84,17 +123,30 @@ void WCSimRunAction::BeginOfRunAction(const G4Run *aRun)
 	wcsimrootgeom = new WCSimRootGeom();
 	TBranch *geoBranch = geoTree->Branch("wcsimrootgeom", "WCSimRootGeom", &wcsimrootgeom, bufsize, 0);
 
-	FillGeoTree();
+	// Flat copy of the digits and geometry, saved on the same schedule as the event tree
+	if (GetSaveFlatNtuple())
+	{
+		fFlatNtuple = new WCSimFlatNtuple(bufsize);
+		fFlatNtuple->GetTree()->SetAutoSave(tree->GetAutoSave());
+	}
+
+	// The geometry is the same for every thread, so only the first one saves it
+	if (G4Threading::G4GetThreadId() <= 0)
+	{
+		FillGeoTree();
+	}
+	runStartTime = std::chrono::steady_clock::now();
+
 	if (GetSavePhotonNtuple())
 	{
-		G4String photonname = GetPhotonNtupleName();
+		G4String photonname = GetThreadFileName(GetPhotonNtupleName());
 		std::cout << "Photon ntuple name = " << photonname << std::endl;
-		WCSimPhotonNtuple::Instance(photonname);
+		WCSimPhotonNtuple::Instance(photonname)->SetPrescale(GetPhotonNtuplePrescale());
 	}
 
 	if (GetSaveEmissionProfile())
 	{
-		G4String emissionProfileName = GetEmissionProfileName();
+		G4String emissionProfileName = GetThreadFileName(GetEmissionProfileName());
 		std::cout << "Emission profile name = " << emissionProfileName << std::endl;
 		WCSimEmissionProfileMaker::Instance(emissionProfileName);
 	}
@@ -114,6 +166,12 @@ void WCSimRunAction::EndOfRunAction(const G4Run *)
 	//  G4cout << (float(numberOfTimesCatcherHit)/float(numberOfEventsGenerated))*100.
 	//        << "% through-going (hit Catcher)" << G4endl;
 
+	if (IsMultithreadedMaster())
+	{
+		MergeWorkerFiles();
+		return;
+	}
+
 	// Close the Root file at the end of the run
 	int events = WCSimTree->GetEntries();
 	if (GetSavePhotonNtuple())
@@ -124,13 +182,21 @@ void WCSimRunAction::EndOfRunAction(const G4Run *)
 	{
 		WCSimEmissionProfileMaker::Close();
 	}
+	// Write the final copy of the trees, replacing the autosaved headers
 	TFile *hfile = WCSimTree->GetCurrentFile();
+	hfile->Write("", TObject::kOverwrite);
+	delete fFlatNtuple;
+	fFlatNtuple = 0;
+	double runTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - runStartTime).count();
+	double fileMBytes = hfile->GetEND() / 1e6;
 	hfile->Close();
 
 	// Clean up stuff on the heap; I think deletion of hfile and trees
 	// is taken care of by the file close
 
-	std::cout << "Finished running and saved " << events << " events to " << GetRootFileName() << std::endl;
+	std::cout << "Finished running and saved " << events << " events to " << GetThreadFileName(GetRootFileName()) << std::endl;
+	std::cout << "Output: " << events / runTime << " events/s, " << fileMBytes << " MB (" << fileMBytes / std::max(events, 1)
+			  << " MB/event)" << std::endl;
 
 	delete wcsimrootsuperevent;
 	wcsimrootsuperevent = 0;
@@ -138,6 +204,89 @@ void WCSimRunAction::EndOfRunAction(const G4Run *)
 	wcsimrootgeom = 0;
 }
 
+G4bool WCSimRunAction::IsMultithreadedMaster() const
+{
+	return G4RunManager::GetRunManager()->GetRunManagerType() == G4RunManager::masterRM;
+}
+
+G4String WCSimRunAction::GetThreadFileName(const G4String &fileName) const
+{
+	return GetThreadFileName(fileName, G4Threading::G4GetThreadId());
+}
+
+G4String WCSimRunAction::GetThreadFileName(const G4String &fileName, G4int threadID)
+{
+	// Sequential runs and the master thread use the name as it is
+	if (threadID < 0)
+	{
+		return fileName;
+	}
+
+	// Otherwise add the thread number before the extension
+	std::stringstream suffix;
+	suffix << "_t" << threadID;
+	std::string name = fileName;
+	size_t extension = name.rfind(".root");
+	if (extension != std::string::npos && extension == name.size() - 5)
+	{
+		name.insert(extension, suffix.str());
+	}
+	else
+	{
+		name += suffix.str();
+	}
+	return name;
+}
+
+void WCSimRunAction::MergeWorkerFiles()
+{
+	G4int nThreads = 0;
+#ifdef G4MULTITHREADED
+	nThreads = G4MTRunManager::GetMasterRunManager()->GetNumberOfThreads();
+#endif
+
+	// Work out the worker file names in the same way the workers did
+	std::vector<std::string> workerFiles;
+	for (G4int t = 0; t < nThreads; ++t)
+	{
+		std::string name = GetThreadFileName(GetRootFileName(), t);
+		// Threads that got no events don't write a file
+		if (!gSystem->AccessPathName(name.c_str()))
+		{
+			workerFiles.push_back(name);
+		}
+	}
+
+	double runTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - runStartTime).count();
+	if (!GetMergeThreadFiles())
+	{
+		std::cout << "Finished running in " << runTime << " s, events are in " << workerFiles.size()
+				  << " files, one per thread" << std::endl;
+		return;
+	}
+
+	TFileMerger merger(kFALSE);
+	merger.SetFastMethod(kTRUE);
+	merger.OutputFile(GetRootFileName().c_str(), "RECREATE", CompressionLevel);
+	for (unsigned int f = 0; f < workerFiles.size(); ++f)
+	{
+		merger.AddFile(workerFiles[f].c_str(), kFALSE);
+	}
+	if (workerFiles.empty() || !merger.Merge())
+	{
+		std::cerr << "WCSimRunAction: failed to merge the thread output files into " << GetRootFileName() << std::endl;
+		return;
+	}
+
+	// Only remove the thread files once we know they have been merged
+	for (unsigned int f = 0; f < workerFiles.size(); ++f)
+	{
+		gSystem->Unlink(workerFiles[f].c_str());
+	}
+	std::cout << "Finished running in " << runTime << " s, merged " << workerFiles.size() << " thread files into "
+			  << GetRootFileName() << std::endl;
+}
+
 void WCSimRunAction::FillGeoTree()
 {
 	// Fill the geometry tree
@@ -216,6 +365,10 @@ void WCSimRunAction::FillGeoTree()
 		double maxRadius = config.GetMaxRadius();
 		//std::cout << "About to add PMT with name " << pmtName << " and radius " << pmtRadius << std::endl;
 		wcsimrootgeom->SetPMT(i, tubeNo, cylLoc, rot, pos, pmtRadius, maxRadius, pmtName);
+		if (fFlatNtuple)
+		{
+			fFlatNtuple->AddPMT(tubeNo, cylLoc, pos, rot, pmtRadius);
+		}
 	}
 	if (fpmts->size() != numpmt)
 	{
@@ -227,6 +380,10 @@ void WCSimRunAction::FillGeoTree()
 	wcsimrootgeom->SetWCNumVetoPMT(wcsimdetector->GetNumVetoPmts());
 
 	geoTree->Fill();
+	if (fFlatNtuple)
+	{
+		fFlatNtuple->FillGeometry();
+	}
 	TFile *hfile = geoTree->GetCurrentFile();
 	hfile->Write();
 }
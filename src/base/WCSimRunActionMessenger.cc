@@ -6,6 +6,7 @@
 #include "G4UIparameter.hh"
 #include "G4UIcmdWithAString.hh"
 #include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAnInteger.hh"
 
 WCSimRunActionMessenger::WCSimRunActionMessenger(WCSimRunAction *WCSimRA) : WCSimRun(WCSimRA)
 {
@@ -36,6 +37,12 @@ WCSimRunActionMessenger::WCSimRunActionMessenger(WCSimRunAction *WCSimRA) : WCSi
 	PhotonNtuple->SetParameterName("PhotonNtupleName", true);
 	PhotonNtuple->SetDefaultValue("wcsim_photons.root");
 
+	PhotonNtuplePrescale = new G4UIcmdWithAnInteger("/WCSimIO/PhotonNtuplePrescale", this);
+	PhotonNtuplePrescale->SetGuidance("Only save one in every N Cherenkov photons in the photon ntuple");
+	PhotonNtuplePrescale->SetParameterName("PhotonNtuplePrescale", true);
+	PhotonNtuplePrescale->SetDefaultValue(1);
+	PhotonNtuplePrescale->SetRange("PhotonNtuplePrescale > 0");
+
 	SaveEmissionProfile = new G4UIcmdWithABool("/WCSimIO/SaveEmissionProfile", this);
 	SaveEmissionProfile->SetGuidance("Save only the information needed to build emission profiles");
 	SaveEmissionProfile->SetGuidance("Enter 'true' to save emission profile information only");
@@ -47,6 +54,51 @@ WCSimRunActionMessenger::WCSimRunActionMessenger(WCSimRunAction *WCSimRA) : WCSi
 	EmissionProfile->SetGuidance("Enter the name of the emission profile ROOT file");
 	EmissionProfile->SetParameterName("EmissionProfileName", true);
 	EmissionProfile->SetDefaultValue("wcsim_emission_profile.root");
+
+	AutoSaveEvents = new G4UIcmdWithAnInteger("/WCSimIO/AutoSaveEvents", this);
+	AutoSaveEvents->SetGuidance("Save the event tree header every N events");
+	AutoSaveEvents->SetGuidance("Enter 0 to autosave by size instead (see /WCSimIO/AutoSaveMBytes)");
+	AutoSaveEvents->SetParameterName("AutoSaveEvents", true);
+	AutoSaveEvents->SetDefaultValue(0);
+	AutoSaveEvents->SetRange("AutoSaveEvents >= 0");
+
+	AutoSaveMBytes = new G4UIcmdWithAnInteger("/WCSimIO/AutoSaveMBytes", this);
+	AutoSaveMBytes->SetGuidance("Save the event tree header every N MB written");
+	AutoSaveMBytes->SetGuidance("Only used if /WCSimIO/AutoSaveEvents is 0");
+	AutoSaveMBytes->SetParameterName("AutoSaveMBytes", true);
+	AutoSaveMBytes->SetDefaultValue(100);
+	AutoSaveMBytes->SetRange("AutoSaveMBytes > 0");
+
+	BasketSize = new G4UIcmdWithAnInteger("/WCSimIO/BasketSize", this);
+	BasketSize->SetGuidance("Set the basket size in bytes of the event tree branches");
+	BasketSize->SetParameterName("BasketSize", true);
+	BasketSize->SetDefaultValue(64000);
+	BasketSize->SetRange("BasketSize > 0");
+
+	CompressionLevel = new G4UIcmdWithAnInteger("/WCSimIO/CompressionLevel", this);
+	CompressionLevel->SetGuidance("Set the compression level of the output ROOT file");
+	CompressionLevel->SetGuidance("0 is no compression, 9 is the most");
+	CompressionLevel->SetParameterName("CompressionLevel", true);
+	CompressionLevel->SetDefaultValue(2);
+	CompressionLevel->SetRange("CompressionLevel >= 0 && CompressionLevel <= 9");
+
+	MergeThreadFiles = new G4UIcmdWithABool("/WCSimIO/MergeThreadFiles", this);
+	MergeThreadFiles->SetGuidance("In multithreaded mode, merge the output of each thread into the ROOT file");
+	MergeThreadFiles->SetGuidance("Enter 'false' to keep one file per thread");
+	MergeThreadFiles->SetParameterName("MergeThreadFiles", true);
+	MergeThreadFiles->SetDefaultValue(true);
+
+	SaveFlatNtuple = new G4UIcmdWithABool("/WCSimIO/SaveFlatNtuple", this);
+	SaveFlatNtuple->SetGuidance("Also save the digits and PMT geometry as flat vectors in the ROOT file");
+	SaveFlatNtuple->SetGuidance("Enter 'true' to add the flatT and flatGeoT trees");
+	SaveFlatNtuple->SetParameterName("SaveFlatNtuple", true);
+	SaveFlatNtuple->SetDefaultValue(false);
+
+	SaveRawHits = new G4UIcmdWithABool("/WCSimIO/SaveRawHits", this);
+	SaveRawHits->SetGuidance("Save the true photon times on each PMT as well as the digits");
+	SaveRawHits->SetGuidance("Enter 'true' to keep the hits needed to digitize again with chipsdigi");
+	SaveRawHits->SetParameterName("SaveRawHits", true);
+	SaveRawHits->SetDefaultValue(false);
 }
 
 WCSimRunActionMessenger::~WCSimRunActionMessenger()
@@ -55,8 +107,16 @@ WCSimRunActionMessenger::~WCSimRunActionMessenger()
 	delete RootFile;
 	delete SavePhotonNtuple;
 	delete PhotonNtuple;
+	delete PhotonNtuplePrescale;
 	delete SaveEmissionProfile;
 	delete EmissionProfile;
+	delete AutoSaveEvents;
+	delete AutoSaveMBytes;
+	delete BasketSize;
+	delete CompressionLevel;
+	delete MergeThreadFiles;
+	delete SaveFlatNtuple;
+	delete SaveRawHits;
 	delete WCSimIODir;
 }
 
@@ -82,6 +142,11 @@ void WCSimRunActionMessenger::SetNewValue(G4UIcommand *command, G4String newValu
 		WCSimRun->SetPhotonNtupleName(newValue);
 		G4cout << "Outut photon ntuple file set to " << newValue << G4endl;
 	}
+	if (command == PhotonNtuplePrescale)
+	{
+		WCSimRun->SetPhotonNtuplePrescale(PhotonNtuplePrescale->GetNewIntValue(newValue));
+		G4cout << "Photon ntuple prescale set to " << newValue << G4endl;
+	}
 	if (command == SaveEmissionProfile)
 	{
 		WCSimRun->SetSaveEmissionProfile(SaveEmissionProfile->GetNewBoolValue(newValue));
@@ -92,4 +157,39 @@ void WCSimRunActionMessenger::SetNewValue(G4UIcommand *command, G4String newValu
 		WCSimRun->SetEmissionProfileName(newValue);
 		G4cout << "Outut emission profiel file basename set to " << newValue << G4endl;
 	}
+	if (command == AutoSaveEvents)
+	{
+		WCSimRun->SetAutoSaveEvents(AutoSaveEvents->GetNewIntValue(newValue));
+		G4cout << "Autosave every N events set to " << newValue << G4endl;
+	}
+	if (command == AutoSaveMBytes)
+	{
+		WCSimRun->SetAutoSaveMBytes(AutoSaveMBytes->GetNewIntValue(newValue));
+		G4cout << "Autosave every N MB set to " << newValue << G4endl;
+	}
+	if (command == BasketSize)
+	{
+		WCSimRun->SetBasketSize(BasketSize->GetNewIntValue(newValue));
+		G4cout << "Event tree basket size set to " << newValue << G4endl;
+	}
+	if (command == CompressionLevel)
+	{
+		WCSimRun->SetCompressionLevel(CompressionLevel->GetNewIntValue(newValue));
+		G4cout << "Output ROOT file compression level set to " << newValue << G4endl;
+	}
+	if (command == MergeThreadFiles)
+	{
+		WCSimRun->SetMergeThreadFiles(MergeThreadFiles->GetNewBoolValue(newValue));
+		G4cout << "Merge thread output files set to " << newValue << G4endl;
+	}
+	if (command == SaveFlatNtuple)
+	{
+		WCSimRun->SetSaveFlatNtuple(SaveFlatNtuple->GetNewBoolValue(newValue));
+		G4cout << "Save flat ntuple set to " << newValue << G4endl;
+	}
+	if (command == SaveRawHits)
+	{
+		WCSimRun->SetSaveRawHits(SaveRawHits->GetNewBoolValue(newValue));
+		G4cout << "Save raw hits set to " << newValue << G4endl;
+	}
 }
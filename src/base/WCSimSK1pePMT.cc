@@ -1,5 +1,7 @@
 // C++ headers
 #include <iostream>
+#include <cmath>
+#include <algorithm>
 // GEANT headers
 #include "globals.hh"
 // Root headers
@@ -9,7 +11,8 @@
 
 WCSimSK1pePMT::WCSimSK1pePMT()
 {
-	fRand = TRandom3(0);
+	fGaussianThreshold = 0;
+	BuildSampler();
 }
 
 WCSimSK1pePMT::~WCSimSK1pePMT()
@@ -84,6 +87,38 @@ const float qpe0[501] = {
 	// Dummy element for noticing if the loop reached the end of the array
 	0.0};
 
+// Number of real entries in qpe0, the last one is the dummy
+static const int nQpe0 = 500;
+
+void WCSimSK1pePMT::BuildSampler()
+{
+	// One guide entry per table entry is plenty for a cumulative table this smooth
+	fGuide.resize(nQpe0);
+	int i = 0;
+	for (unsigned int k = 0; k < fGuide.size(); ++k)
+	{
+		double u = double(k) / fGuide.size();
+		while (i < nQpe0 - 1 && u > qpe0[i])
+			++i;
+		fGuide[k] = i;
+	}
+
+	// Moments of the charge from rn1pe(). Entry i gives a charge uniform in
+	// [i - 50, i - 49) / 22.83 with probability qpe0[i] - qpe0[i-1].
+	double sum = 0.0;
+	double sumSq = 0.0;
+	for (i = 0; i < nQpe0; ++i)
+	{
+		double prob = qpe0[i] - ((i > 0) ? qpe0[i - 1] : 0.0);
+		double low = (i - 50) / 22.83;
+		double high = (i - 49) / 22.83;
+		sum += prob * 0.5 * (low + high);
+		sumSq += prob * (low * low + low * high + high * high) / 3.0;
+	}
+	fMean1pe = sum;
+	fSigma1pe = sqrt(sumSq - sum * sum);
+}
+
 double WCSimSK1pePMT::CalculateCharge(int totalPe)
 {
 	//G4double peCutOff = .3;
@@ -94,6 +129,21 @@ double WCSimSK1pePMT::CalculateCharge(int totalPe)
 	// match K2K 1KT data  : maybe due to PMT curvature ?
 	double efficiency = 0.985; // with skrn1pe (AP tuning) & 30% QE increase in stacking action
 
+	double peSmeared = SumCharge(totalPe);
+
+	peSmeared = Threshold(peSmeared);
+	peSmeared *= efficiency; // MC tuning correction
+	return peSmeared;
+}
+
+double WCSimSK1pePMT::SumCharge(int totalPe)
+{
+	// For large numbers of pe the sum is Gaussian to a very good approximation
+	if (fGaussianThreshold > 0 && totalPe >= fGaussianThreshold)
+	{
+		return fRand.Gaus(totalPe * fMean1pe, sqrt((double)totalPe) * fSigma1pe);
+	}
+
 	double peSmeared = 0.0;
 	for (int npe = 0; npe < totalPe; npe++)
 	{
@@ -105,13 +155,23 @@ double WCSimSK1pePMT::CalculateCharge(int totalPe)
 		//peSmeared += qtmp;
 		peSmeared += rn1pe();
 	}
-
-	peSmeared = Threshold(peSmeared);
-	peSmeared *= efficiency; // MC tuning correction
 	return peSmeared;
 }
 
 double WCSimSK1pePMT::rn1pe()
+{
+	double random = fRand.Rndm();
+	double random2 = fRand.Rndm();
+	// Jump to the first entry that could be the answer, then the same search
+	// as rn1peLinear() from there.
+	int i = fGuide[static_cast<int>(random * fGuide.size())];
+	while (i < nQpe0 && random > qpe0[i])
+		++i;
+
+	return (double(i - 50) + random2) / 22.83;
+}
+
+double WCSimSK1pePMT::rn1peLinear()
 {
 	double random = fRand.Rndm();
 	double random2 = fRand.Rndm();
@@ -127,6 +187,78 @@ double WCSimSK1pePMT::rn1pe()
 	return (double(i - 50) + random2) / 22.83;
 }
 
+void WCSimSK1pePMT::ValidateSampler(int nSamples)
+{
+	// Histograms with the same binning as the table, -50/22.83 to 450/22.83
+	std::vector<double> linear(nQpe0, 0.0);
+	std::vector<double> guide(nQpe0, 0.0);
+	for (int n = 0; n < nSamples; ++n)
+	{
+		int binLinear = static_cast<int>(floor(rn1peLinear() * 22.83)) + 50;
+		int binGuide = static_cast<int>(floor(rn1pe() * 22.83)) + 50;
+		if (binLinear >= 0 && binLinear < nQpe0)
+			++linear[binLinear];
+		if (binGuide >= 0 && binGuide < nQpe0)
+			++guide[binGuide];
+	}
+
+	double chi2 = 0.0;
+	int ndf = 0;
+	for (int b = 0; b < nQpe0; ++b)
+	{
+		if (linear[b] + guide[b] > 0)
+		{
+			chi2 += (linear[b] - guide[b]) * (linear[b] - guide[b]) / (linear[b] + guide[b]);
+			++ndf;
+		}
+	}
+	std::cout << "WCSimSK1pePMT::ValidateSampler: 1pe spectrum, guide table vs linear search over " << nSamples
+			  << " draws: chi2/ndf = " << chi2 << "/" << ndf << std::endl;
+	std::cout << "  1pe mean = " << fMean1pe << ", sigma = " << fSigma1pe << std::endl;
+
+	// Now the Gaussian approximation against the exact sum for a few tube charges
+	const int nPeValues = 4;
+	int peValues[nPeValues] = {10, 30, 100, 300};
+	int nTubes = std::max(1, nSamples / 1000);
+	for (int v = 0; v < nPeValues; ++v)
+	{
+		int pe = peValues[v];
+		// 100 bins over +-5 sigma of the expected sum
+		int nBins = 100;
+		double low = pe * fMean1pe - 5.0 * sqrt((double)pe) * fSigma1pe;
+		double width = 10.0 * sqrt((double)pe) * fSigma1pe / nBins;
+		std::vector<double> exact(nBins, 0.0);
+		std::vector<double> gaus(nBins, 0.0);
+		for (int n = 0; n < nTubes; ++n)
+		{
+			double sumExact = 0.0;
+			for (int p = 0; p < pe; ++p)
+			{
+				sumExact += rn1pe();
+			}
+			int binExact = static_cast<int>(floor((sumExact - low) / width));
+			int binGaus = static_cast<int>(floor((fRand.Gaus(pe * fMean1pe, sqrt((double)pe) * fSigma1pe) - low) / width));
+			if (binExact >= 0 && binExact < nBins)
+				++exact[binExact];
+			if (binGaus >= 0 && binGaus < nBins)
+				++gaus[binGaus];
+		}
+
+		chi2 = 0.0;
+		ndf = 0;
+		for (int b = 0; b < nBins; ++b)
+		{
+			if (exact[b] + gaus[b] > 0)
+			{
+				chi2 += (exact[b] - gaus[b]) * (exact[b] - gaus[b]) / (exact[b] + gaus[b]);
+				++ndf;
+			}
+		}
+		std::cout << "  " << pe << " pe, Gaussian vs summed spectrum over " << nTubes << " tubes: chi2/ndf = " << chi2 << "/"
+				  << ndf << std::endl;
+	}
+}
+
 double WCSimSK1pePMT::Threshold(double preThresholdPe)
 {
 	double pe = preThresholdPe;
@@ -1,5 +1,9 @@
 #include "WCSimStackingAction.hh"
 #include "WCSimDetectorConstruction.hh"
+#include "WCSimRunAction.hh"
+#include "WCSimPrimaryGeneratorAction.hh"
+#include "WCSimEmissionProfileMaker.hh"
+#include "WCSimPhotonNtuple.hh"
 
 #include "G4Track.hh"
 #include "G4TrackStatus.hh"
@@ -13,7 +17,10 @@
 
 //class WCSimDetectorConstruction;
 
-WCSimStackingAction::WCSimStackingAction(WCSimDetectorConstruction *myDet) : DetConstruct(myDet)
+WCSimStackingAction::WCSimStackingAction(WCSimDetectorConstruction *myDet, WCSimRunAction *runAction,
+										 WCSimPrimaryGeneratorAction *generatorAction)
+	: DetConstruct(myDet), fRunAction(runAction), fGeneratorAction(generatorAction), fFillEmissionProfile(false),
+	  fRecordPhotons(false)
 {
 }
 WCSimStackingAction::~WCSimStackingAction()
@@ -30,34 +37,32 @@ G4ClassificationOfNewTrack WCSimStackingAction::ClassifyNewTrack(const G4Track *
 	// Make sure it is an optical photon
 	if (particleType == G4OpticalPhoton::OpticalPhotonDefinition())
 	{
+		// We don't know yet which PMT the photon will hit, so use the largest
+		// efficiency of all the PMT types. If there is more than one type the
+		// sensitive detector applies the rest of the QE for the tube it hits.
+		const WCSimPMTQE &pmtQE = DetConstruct->GetPMTQETable();
 		G4float photonWavelength = (2.0 * M_PI * 197.3) / (aTrack->GetTotalEnergy() / CLHEP::eV);
-		G4float ratio = 1. / (1.0 - 0.25);
-		ratio = 1.0;
 		G4float wavelengthQE = 0;
 		if (aTrack->GetCreatorProcess() == NULL)
 		{
-			wavelengthQE = DetConstruct->GetPMTQE(photonWavelength, 1, 240, 660, ratio);
+			wavelengthQE = pmtQE.GetEnvelopeQE(photonWavelength);
 			if (G4UniformRand() > wavelengthQE)
 				classification = fKill;
 		}
 		else if (((G4VProcess *)(aTrack->GetCreatorProcess()))->GetProcessType() != 3)
 		{
-			G4float photonWavelength = (2.0 * M_PI * 197.3) / (aTrack->GetTotalEnergy() / CLHEP::eV);
 			// MF : translated from skdetsim : better to increase the number of photons
 			// than to throw in a global factor  at Digitization time !
-			G4float ratio = 1. / (1.0 - 0.25);
-			ratio = 1.0;
-			// XQ: get the maximum QE and multiply it by the ratio
+			// XQ: get the maximum QE
 			// only work for the range between 240 nm and 660 nm for now
 			// Even with WLS
-			G4float wavelengthQE = 0;
 			if (DetConstruct->GetPMT_QE_Method() == 1)
 			{
-				wavelengthQE = DetConstruct->GetPMTQE(photonWavelength, 1, 240, 660, ratio);
+				wavelengthQE = pmtQE.GetEnvelopeQE(photonWavelength);
 			}
 			else if (DetConstruct->GetPMT_QE_Method() == 2)
 			{
-				wavelengthQE = DetConstruct->GetPMTQE(photonWavelength, 0, 240, 660, ratio);
+				wavelengthQE = pmtQE.GetMaxQE(photonWavelength);
 			}
 			else if (DetConstruct->GetPMT_QE_Method() == 3)
 			{
@@ -67,6 +72,16 @@ G4ClassificationOfNewTrack WCSimStackingAction::ClassifyNewTrack(const G4Track *
 			if (G4UniformRand() > wavelengthQE)
 				classification = fKill;
 		}
+
+		// Fill the emission profiles and the photon ntuple with the photons that will be tracked
+		if (fFillEmissionProfile && classification != fKill)
+		{
+			WCSimEmissionProfileMaker::AddPhoton(aTrack);
+		}
+		if (fRecordPhotons && classification != fKill)
+		{
+			WCSimPhotonNtuple::AddPhoton(aTrack);
+		}
 	}
 
 	return classification;
@@ -78,5 +93,11 @@ void WCSimStackingAction::NewStage()
 }
 void WCSimStackingAction::PrepareNewEvent()
 {
-	;
+	// The primaries have been generated by now, so the truth summary is for this event
+	fFillEmissionProfile = fRunAction && fGeneratorAction && fRunAction->GetSaveEmissionProfile();
+	if (fFillEmissionProfile)
+	{
+		WCSimEmissionProfileMaker::BeginEvent(*(fGeneratorAction->GetTruthSummaryPointer()));
+	}
+	fRecordPhotons = WCSimPhotonNtuple::IsOpen();
 }
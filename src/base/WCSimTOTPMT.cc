@@ -11,8 +11,6 @@
 
 WCSimTOTPMT::WCSimTOTPMT()
 {
-	fRand = TRandom3(0);
-
 	fUpperBoundMadison = 19.462568;
 	fLambdaMadison = 0.37098;
 	fMultiplierMadison = 7.09985;
@@ -27,17 +25,35 @@ WCSimTOTPMT::~WCSimTOTPMT()
 	//Empty
 }
 
+WCSimTOTPMT::TOTModel WCSimTOTPMT::GetModel(const std::string &PMTName)
+{
+	if (PMTName.compare("88mm") == 0 || PMTName.compare("88mm_LC_v2") == 0)
+	{
+		return kNikhef;
+	}
+	else if (PMTName.compare("R6091") == 0 || PMTName.compare("R6091_LC_v1") == 0)
+	{
+		return kMadison;
+	}
+	return kNoModel;
+}
+
 double WCSimTOTPMT::CalculateCharge(int totalPe, std::string PMTName)
+{
+	return CalculateCharge(totalPe, GetModel(PMTName));
+}
+
+double WCSimTOTPMT::CalculateCharge(int totalPe, TOTModel model)
 {
 	double sigma, mean, tot, peSmeared;
-	if (PMTName.compare("88mm") == 0 || PMTName.compare("88mm_LC_v2") == 0)
+	if (model == kNikhef)
 	{
 		sigma = TMath::Sqrt((double)totalPe);
 		mean = fUpperBoundNikhef - (fMultiplierNikhef * TMath::Exp(-1. * fLambdaNikhef * (double)totalPe));
 		tot = fRand.Gaus(mean, sigma);
 		peSmeared = (-1) * TMath::Log(((-1) * tot + fUpperBoundNikhef) / fMultiplierNikhef) / fLambdaNikhef;
 	}
-	else if (PMTName.compare("R6091") == 0 || PMTName.compare("R6091_LC_v1") == 0)
+	else if (model == kMadison)
 	{
 		sigma = TMath::Sqrt((double)totalPe);
 		mean = fUpperBoundMadison - (fMultiplierMadison * TMath::Exp(-1. * fLambdaMadison * (double)totalPe));
@@ -0,0 +1,134 @@
+#include "WCSimTrackFilter.hh"
+#include "WCSimTrackFilterMessenger.hh"
+#include "WCSimTrajectory.hh"
+
+#include "G4TrajectoryContainer.hh"
+#include "CLHEP/Units/SystemOfUnits.h"
+
+WCSimTrackFilter::WCSimTrackFilter()
+{
+	// By default keep the primaries, the photons from pi0s and the decay products
+	// of muons and pions, which covers what the old fixed list of parents did.
+	fSavePrimaries = true;
+	fParentPDGs.insert(111);
+	fProcesses.insert("Decay");
+	fMinEnergy = 0.;
+	fMaxTracks = 0;
+	fStamp = 0;
+	fMessenger = new WCSimTrackFilterMessenger(this);
+}
+
+WCSimTrackFilter::~WCSimTrackFilter()
+{
+	delete fMessenger;
+}
+
+void WCSimTrackFilter::Clear()
+{
+	fSavePrimaries = true;
+	fPDGs.clear();
+	fParentPDGs.clear();
+	fProcesses.clear();
+	fMinEnergy = 0.;
+	fMaxTracks = 0;
+}
+
+void WCSimTrackFilter::Print() const
+{
+	G4cout << "Track filter: primaries " << (fSavePrimaries ? "saved" : "not saved") << ", minimum energy "
+		   << fMinEnergy / CLHEP::MeV << " MeV, at most ";
+	if (fMaxTracks > 0)
+	{
+		G4cout << fMaxTracks;
+	}
+	else
+	{
+		G4cout << "unlimited";
+	}
+	G4cout << " tracks" << G4endl;
+
+	G4cout << "  PDG codes:";
+	for (std::set<G4int>::const_iterator it = fPDGs.begin(); it != fPDGs.end(); ++it)
+	{
+		G4cout << " " << *it;
+	}
+	G4cout << G4endl << "  Parent PDG codes:";
+	for (std::set<G4int>::const_iterator it = fParentPDGs.begin(); it != fParentPDGs.end(); ++it)
+	{
+		G4cout << " " << *it;
+	}
+	G4cout << G4endl << "  Creator processes:";
+	for (std::set<G4String>::const_iterator it = fProcesses.begin(); it != fProcesses.end(); ++it)
+	{
+		G4cout << " " << *it;
+	}
+	G4cout << G4endl;
+}
+
+void WCSimTrackFilter::Select(G4TrajectoryContainer *trajectories, std::vector<WCSimTrajectory *> &selected,
+							  std::vector<G4int> &parentTypes)
+{
+	selected.clear();
+	parentTypes.clear();
+	if (!trajectories)
+	{
+		return;
+	}
+	++fStamp;
+
+	// Geant4 stores the trajectory of a track before any of its secondaries are
+	// tracked, so every stored parent has been seen by the time we reach its
+	// daughters.
+	G4int nTrajectories = trajectories->entries();
+	for (G4int i = 0; i < nTrajectories; ++i)
+	{
+		WCSimTrajectory *trj = (WCSimTrajectory *)(*trajectories)[i];
+		if (trj->IsOpticalPhoton())
+		{
+			continue;
+		}
+
+		G4int trackID = trj->GetTrackID();
+		G4int pdg = trj->GetPDGEncoding();
+		if (trackID >= static_cast<G4int>(fTrackPDG.size()))
+		{
+			fTrackPDG.resize(2 * trackID + 1, 0);
+			fTrackStamp.resize(2 * trackID + 1, 0);
+		}
+		fTrackPDG[trackID] = pdg;
+		fTrackStamp[trackID] = fStamp;
+
+		if (!trj->GetSaveFlag())
+		{
+			continue;
+		}
+		if (fMaxTracks > 0 && static_cast<G4int>(selected.size()) >= fMaxTracks)
+		{
+			continue;
+		}
+
+		G4int parentID = trj->GetParentID();
+		G4int parentType = 0;
+		bool keep = false;
+		if (parentID == 0)
+		{
+			keep = fSavePrimaries;
+		}
+		else
+		{
+			// Only track IDs we have already seen can be parents, as above
+			parentType = (parentID < static_cast<G4int>(fTrackStamp.size()) && fTrackStamp[parentID] == fStamp)
+							 ? fTrackPDG[parentID]
+							 : 999;
+
+			keep = (fPDGs.count(pdg) || fParentPDGs.count(parentType) || fProcesses.count(trj->GetCreatorProcessName())) &&
+				   trj->GetEnergy() >= fMinEnergy;
+		}
+
+		if (keep)
+		{
+			selected.push_back(trj);
+			parentTypes.push_back(parentType);
+		}
+	}
+}
@@ -0,0 +1,101 @@
+#include "WCSimTrackFilterMessenger.hh"
+
+#include "WCSimTrackFilter.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithoutParameter.hh"
+
+WCSimTrackFilterMessenger::WCSimTrackFilterMessenger(WCSimTrackFilter *filter) : fTrackFilter(filter)
+{
+	FilterDir = new G4UIdirectory("/WCSimTrack/filter/");
+	FilterDir->SetGuidance("Commands to choose which truth tracks are saved to the output file");
+	FilterDir->SetGuidance("A track is saved if it is a primary, or matches any of the PDG, parent PDG or process rules");
+
+	SavePrimaries = new G4UIcmdWithABool("/WCSimTrack/filter/savePrimaries", this);
+	SavePrimaries->SetGuidance("Bool to save all of the primary tracks, the default is true");
+	SavePrimaries->SetParameterName("savePrimaries", true);
+	SavePrimaries->SetDefaultValue(true);
+
+	AddPDG = new G4UIcmdWithAnInteger("/WCSimTrack/filter/addPDG", this);
+	AddPDG->SetGuidance("Save every track with this PDG code");
+	AddPDG->SetParameterName("pdg", false);
+
+	AddParentPDG = new G4UIcmdWithAnInteger("/WCSimTrack/filter/addParentPDG", this);
+	AddParentPDG->SetGuidance("Save every track whose parent has this PDG code (pi0 by default)");
+	AddParentPDG->SetParameterName("pdg", false);
+
+	AddProcess = new G4UIcmdWithAString("/WCSimTrack/filter/addProcess", this);
+	AddProcess->SetGuidance("Save every track made by the process with this name (Decay by default)");
+	AddProcess->SetParameterName("process", false);
+
+	MinEnergy = new G4UIcmdWithADoubleAndUnit("/WCSimTrack/filter/minEnergy", this);
+	MinEnergy->SetGuidance("Kinetic energy below which non-primary tracks are not saved, the default is 0");
+	MinEnergy->SetParameterName("minEnergy", true);
+	MinEnergy->SetDefaultValue(0.);
+	MinEnergy->SetDefaultUnit("MeV");
+
+	MaxTracks = new G4UIcmdWithAnInteger("/WCSimTrack/filter/maxTracks", this);
+	MaxTracks->SetGuidance("Most tracks to save per event, the default of 0 saves everything selected");
+	MaxTracks->SetParameterName("maxTracks", true);
+	MaxTracks->SetDefaultValue(0);
+
+	Clear = new G4UIcmdWithoutParameter("/WCSimTrack/filter/clear", this);
+	Clear->SetGuidance("Remove all of the rules, leaving only the primaries saved");
+
+	Print = new G4UIcmdWithoutParameter("/WCSimTrack/filter/print", this);
+	Print->SetGuidance("Print the current rules");
+}
+
+WCSimTrackFilterMessenger::~WCSimTrackFilterMessenger()
+{
+	delete SavePrimaries;
+	delete AddPDG;
+	delete AddParentPDG;
+	delete AddProcess;
+	delete MinEnergy;
+	delete MaxTracks;
+	delete Clear;
+	delete Print;
+	delete FilterDir;
+}
+
+void WCSimTrackFilterMessenger::SetNewValue(G4UIcommand *command, G4String newValue)
+{
+	if (command == SavePrimaries)
+	{
+		fTrackFilter->SetSavePrimaries(SavePrimaries->GetNewBoolValue(newValue));
+	}
+	if (command == AddPDG)
+	{
+		fTrackFilter->AddPDG(AddPDG->GetNewIntValue(newValue));
+	}
+	if (command == AddParentPDG)
+	{
+		fTrackFilter->AddParentPDG(AddParentPDG->GetNewIntValue(newValue));
+	}
+	if (command == AddProcess)
+	{
+		fTrackFilter->AddCreatorProcess(newValue);
+	}
+	if (command == MinEnergy)
+	{
+		fTrackFilter->SetMinEnergy(MinEnergy->GetNewDoubleValue(newValue));
+	}
+	if (command == MaxTracks)
+	{
+		fTrackFilter->SetMaxTracks(MaxTracks->GetNewIntValue(newValue));
+	}
+	if (command == Clear)
+	{
+		fTrackFilter->Clear();
+	}
+	if (command == Print)
+	{
+		fTrackFilter->Print();
+	}
+}
@@ -1,7 +1,7 @@
 #include "WCSimTrackInformation.hh"
 #include "G4ios.hh"
 
-G4Allocator<WCSimTrackInformation> aWCSimTrackInfoAllocator;
+G4ThreadLocal G4Allocator<WCSimTrackInformation> *aWCSimTrackInfoAllocator = 0;
 
 WCSimTrackInformation::WCSimTrackInformation(const G4Track *atrack)
 {
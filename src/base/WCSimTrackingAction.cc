@@ -7,6 +7,7 @@
 #include "G4ios.hh"
 #include "G4VProcess.hh"
 #include "WCSimTrackInformation.hh"
+#include "WCSimPhotonNtuple.hh"
 
 WCSimTrackingAction::WCSimTrackingAction()
 {
@@ -23,6 +24,7 @@ WCSimTrackingAction::WCSimTrackingAction()
 	// don't put gammas there or there'll be too many
 	fMessenger = new WCSimTrackingActionMessenger(this);
 	fFractionCherenkovPhotonsToDraw = 0.0;
+	fSummaryTrajectories = false;
 }
 
 WCSimTrackingAction::~WCSimTrackingAction()
@@ -36,7 +38,7 @@ void WCSimTrackingAction::PreUserTrackingAction(const G4Track *aTrack)
 
 	if (aTrack->GetDefinition() != G4OpticalPhoton::OpticalPhotonDefinition() || G4UniformRand() < fFractionCherenkovPhotonsToDraw)
 	{
-		WCSimTrajectory *thisTrajectory = new WCSimTrajectory(aTrack);
+		WCSimTrajectory *thisTrajectory = new WCSimTrajectory(aTrack, fSummaryTrajectories);
 		fpTrackingManager->SetTrajectory(thisTrajectory);
 		fpTrackingManager->SetStoreTrajectory(true);
 	}
@@ -100,6 +102,12 @@ void WCSimTrackingAction::PostUserTrackingAction(const G4Track *aTrack)
 		}
 	}
 
+	// Give the photon ntuple the end point of the photon
+	if (aTrack->GetDefinition() == G4OpticalPhoton::OpticalPhotonDefinition() && WCSimPhotonNtuple::IsOpen())
+	{
+		WCSimPhotonNtuple::EndPhoton(aTrack);
+	}
+
 	if (aTrack->GetDefinition() != G4OpticalPhoton::OpticalPhotonDefinition())
 	//   if (aTrack->GetDefinition()->GetPDGCharge() == 0)
 	{
@@ -118,6 +126,13 @@ void WCSimTrackingAction::PostUserTrackingAction(const G4Track *aTrack)
 		else
 			currentTrajectory->SetSaveFlag(true); // mark it for WCSimEventAction ;
 	}
+	else if (fSummaryTrajectories && fpTrackingManager->GetStoreTrajectory())
+	{
+		// A summary trajectory has no steps, so a drawn photon needs its end point
+		WCSimTrajectory *currentTrajectory = (WCSimTrajectory *)fpTrackingManager->GimmeTrajectory();
+		G4ThreeVector currentPosition = aTrack->GetPosition();
+		currentTrajectory->SetStoppingPoint(currentPosition);
+	}
 }
 
 void WCSimTrackingAction::SetPercentCherenkovPhotonsToDraw(const double &percent)
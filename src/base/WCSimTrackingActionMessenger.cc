@@ -1,10 +1,13 @@
 #include "WCSimTrackingActionMessenger.hh"
 
 #include "WCSimTrackingAction.hh"
+#include "WCSimTrajectory.hh"
 #include "G4UIdirectory.hh"
 #include "G4UIcommand.hh"
 #include "G4UIparameter.hh"
 #include "G4UIcmdWithADouble.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
 
 WCSimTrackingActionMessenger::WCSimTrackingActionMessenger(WCSimTrackingAction *WCSimTA) : fTrackingAction(WCSimTA)
 {
@@ -15,11 +18,29 @@ WCSimTrackingActionMessenger::WCSimTrackingActionMessenger(WCSimTrackingAction *
 	PercentCherenkovPhotonsToDraw->SetGuidance("Set the percentage of Cherenkov photon tracks to store (0 - 100)");
 	PercentCherenkovPhotonsToDraw->SetParameterName("PercentCherenkovPhotonsToDraw", true);
 	PercentCherenkovPhotonsToDraw->SetDefaultValue(0.0);
+
+	TrajectoryMode = new G4UIcmdWithAString("/WCSimTrack/TrajectoryMode", this);
+	TrajectoryMode->SetGuidance("Set which points of the trajectories to store");
+	TrajectoryMode->SetGuidance(
+		"Available options are:\
+          \n full (every step, for visualisation - default)\
+          \n summary (only the start and end points, enough for the output file)");
+	TrajectoryMode->SetParameterName("TrajectoryMode", true);
+	TrajectoryMode->SetDefaultValue("full");
+	TrajectoryMode->SetCandidates("full summary");
+
+	BenchmarkTrajectory = new G4UIcmdWithAnInteger("/WCSimTrack/BenchmarkTrajectory", this);
+	BenchmarkTrajectory->SetGuidance("Print the time per track taken to make a trajectory and to find its particle");
+	BenchmarkTrajectory->SetParameterName("nTracks", true);
+	BenchmarkTrajectory->SetDefaultValue(1000000);
+	BenchmarkTrajectory->AvailableForStates(G4State_Idle);
 }
 
 WCSimTrackingActionMessenger::~WCSimTrackingActionMessenger()
 {
 	delete PercentCherenkovPhotonsToDraw;
+	delete TrajectoryMode;
+	delete BenchmarkTrajectory;
 	delete WCSimIODir;
 }
 
@@ -48,4 +69,12 @@ void WCSimTrackingActionMessenger::SetNewValue(G4UIcommand *command, G4String ne
 		}
 		fTrackingAction->SetPercentCherenkovPhotonsToDraw(newPercent);
 	}
+	if (command == TrajectoryMode)
+	{
+		fTrackingAction->SetSummaryTrajectories(newValue == "summary");
+	}
+	if (command == BenchmarkTrajectory)
+	{
+		WCSimTrajectory::BenchmarkConstruction(BenchmarkTrajectory->GetNewIntValue(newValue));
+	}
 }
@@ -9,36 +9,35 @@
 #include "G4UnitsTable.hh"
 #include "G4VProcess.hh"
 
+#include <chrono>
 #include <sstream>
 
 //G4Allocator<WCSimTrajectory> aTrajectoryAllocator;
-G4Allocator<WCSimTrajectory> myTrajectoryAllocator;
+G4ThreadLocal G4Allocator<WCSimTrajectory> *myTrajectoryAllocator = 0;
 
-WCSimTrajectory::WCSimTrajectory() : positionRecord(0), fTrackID(0), fParentID(0), fProcessID(0), PDGEncoding(0), PDGCharge(0.0), ParticleName(""), initialMomentum(
+WCSimTrajectory::WCSimTrajectory() : positionRecord(0), fTrackID(0), fParentID(0), fProcessID(0), PDGEncoding(0), PDGCharge(0.0), fParticleDefinition(0), initialMomentum(
 																																						G4ThreeVector()),
 									 fEnergy(0.0), fParticleDirection(G4ThreeVector()), fParticlePosition(G4ThreeVector()), fVtxX(
 																																0.0),
 									 fVtxY(0.0), fVtxZ(0.0), fVtxDirX(0.0), fVtxDirY(0.0), fVtxDirZ(0.0), fIsOpticalPhoton(false), fIsScatteredPhoton(
 																																	   false),
-									 SaveIt(false), creatorProcess(""), globalTime(0.0)
+									 fSummaryOnly(false), SaveIt(false), fCreatorProcess(0), globalTime(0.0)
 {
 	;
 }
 
-WCSimTrajectory::WCSimTrajectory(const G4Track *aTrack)
+WCSimTrajectory::WCSimTrajectory(const G4Track *aTrack, G4bool summaryOnly)
 {
-	G4ParticleDefinition *fpParticleDefinition = aTrack->GetDefinition();
-	ParticleName = fpParticleDefinition->GetParticleName();
-	PDGCharge = fpParticleDefinition->GetPDGCharge();
-	PDGEncoding = fpParticleDefinition->GetPDGEncoding();
+	fSummaryOnly = summaryOnly;
+	fParticleDefinition = aTrack->GetDefinition();
+	PDGCharge = fParticleDefinition->GetPDGCharge();
+	PDGEncoding = fParticleDefinition->GetPDGEncoding();
 	fTrackID = aTrack->GetTrackID();
 	fParentID = aTrack->GetParentID();
 
-	if (aTrack->GetCreatorProcess())
-	{
-		G4VProcess *theCreatorProcess = (G4VProcess *)(aTrack->GetCreatorProcess());
-		fProcessID = theCreatorProcess->GetProcessType();
-	}
+	// The processes live for the whole job, so the pointer stands in for the name
+	fCreatorProcess = aTrack->GetCreatorProcess();
+	fProcessID = fCreatorProcess ? fCreatorProcess->GetProcessType() : 0;
 
 	initialMomentum = aTrack->GetMomentum();
 	fParticlePosition = aTrack->GetPosition();
@@ -56,6 +55,10 @@ WCSimTrajectory::WCSimTrajectory(const G4Track *aTrack)
 	fEnergy = aTrack->GetKineticEnergy();
 
 	positionRecord = new TrajectoryPointContainer();
+	if (fSummaryOnly)
+	{
+		positionRecord->reserve(2);
+	}
 	// Following is for the first trajectory point
 	positionRecord->push_back(new G4TrajectoryPoint(aTrack->GetPosition()));
 
@@ -67,17 +70,10 @@ WCSimTrajectory::WCSimTrajectory(const G4Track *aTrack)
 	else
 		SaveIt = false;
 	globalTime = aTrack->GetGlobalTime();
-	if (aTrack->GetCreatorProcess() != 0)
-	{
-		const G4VProcess *tempproc = aTrack->GetCreatorProcess();
-		creatorProcess = tempproc->GetProcessName();
-	}
-	else
-		creatorProcess = "";
 
 	fIsOpticalPhoton = 0;
 	fIsScatteredPhoton = 0;
-	if (fpParticleDefinition && fpParticleDefinition == G4OpticalPhoton::OpticalPhotonDefinition())
+	if (fParticleDefinition == G4OpticalPhoton::OpticalPhotonDefinition())
 	{
 		fIsOpticalPhoton = 1;
 		if (fProcessID == 3)
@@ -87,7 +83,7 @@ WCSimTrajectory::WCSimTrajectory(const G4Track *aTrack)
 
 WCSimTrajectory::WCSimTrajectory(WCSimTrajectory &right) : G4VTrajectory()
 {
-	ParticleName = right.ParticleName;
+	fParticleDefinition = right.fParticleDefinition;
 	PDGCharge = right.PDGCharge;
 	PDGEncoding = right.PDGEncoding;
 	fTrackID = right.fTrackID;
@@ -109,7 +105,8 @@ WCSimTrajectory::WCSimTrajectory(WCSimTrajectory &right) : G4VTrajectory()
 	stoppingVolume = right.stoppingVolume;
 	fEndTime = right.fEndTime;
 	SaveIt = right.SaveIt;
-	creatorProcess = right.creatorProcess;
+	fSummaryOnly = right.fSummaryOnly;
+	fCreatorProcess = right.fCreatorProcess;
 
 	for (size_t i = 0; i < right.positionRecord->size(); i++)
 	{
@@ -193,7 +190,7 @@ std::vector<G4AttValue> *WCSimTrajectory::CreateAttValues() const
 	s << fParentID << std::ends;
 	values->push_back(G4AttValue("PID", c, ""));
 
-	values->push_back(G4AttValue("PN", ParticleName, ""));
+	values->push_back(G4AttValue("PN", GetParticleName(), ""));
 
 	s.seekp(std::ios::beg);
 	s << PDGCharge << std::ends;
@@ -216,12 +213,83 @@ std::vector<G4AttValue> *WCSimTrajectory::CreateAttValues() const
 
 void WCSimTrajectory::AppendStep(const G4Step *aStep)
 {
+	// The end point of a summary trajectory is set by SetStoppingPoint()
+	if (fSummaryOnly)
+	{
+		return;
+	}
 	positionRecord->push_back(new G4TrajectoryPoint(aStep->GetPostStepPoint()->GetPosition()));
 }
 
-G4ParticleDefinition *WCSimTrajectory::GetParticleDefinition()
+void WCSimTrajectory::SetStoppingPoint(G4ThreeVector &currentPosition)
+{
+	stoppingPoint = currentPosition;
+
+	// Summary trajectories keep the stopping point as their second and last point
+	if (fSummaryOnly)
+	{
+		if (positionRecord->size() > 1)
+		{
+			delete positionRecord->back();
+			positionRecord->back() = new G4TrajectoryPoint(currentPosition);
+		}
+		else
+		{
+			positionRecord->push_back(new G4TrajectoryPoint(currentPosition));
+		}
+	}
+}
+
+const G4String &WCSimTrajectory::GetCreatorProcessName() const
 {
-	return (G4ParticleTable::GetParticleTable()->FindParticle(ParticleName));
+	static const G4String noProcess("");
+	return fCreatorProcess ? fCreatorProcess->GetProcessName() : noProcess;
+}
+
+void WCSimTrajectory::BenchmarkConstruction(G4int nTracks)
+{
+	// A track with no volume or creator process, which is all the constructor needs
+	G4ParticleDefinition *muon = G4MuonMinus::MuonMinusDefinition();
+	G4Track track(new G4DynamicParticle(muon, G4ThreeVector(0., 0., 1.), 1. * CLHEP::GeV), 0., G4ThreeVector());
+	track.SetTrackID(1);
+	track.SetParentID(0);
+
+	std::vector<WCSimTrajectory *> trajectories(nTracks);
+	G4cout << "WCSimTrajectory::BenchmarkConstruction: " << nTracks << " tracks" << G4endl;
+	for (int summary = 1; summary >= 0; --summary)
+	{
+		std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+		for (G4int t = 0; t < nTracks; ++t)
+		{
+			trajectories[t] = new WCSimTrajectory(&track, summary);
+		}
+		for (G4int t = 0; t < nTracks; ++t)
+		{
+			delete trajectories[t];
+		}
+		double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+		G4cout << "  " << (summary ? "summary" : "full   ") << " construct + delete: " << elapsed / nTracks
+			   << " ns/track" << G4endl;
+	}
+
+	// What every saved track used to pay in FillRootEvent() to get its mass
+	WCSimTrajectory trajectory(&track, true);
+	G4ParticleTable *table = G4ParticleTable::GetParticleTable();
+	G4double sum = 0.;
+	std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+	for (G4int t = 0; t < nTracks; ++t)
+	{
+		sum += table->FindParticle(trajectory.GetParticleName())->GetPDGMass();
+	}
+	double byName = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+	begin = std::chrono::steady_clock::now();
+	for (G4int t = 0; t < nTracks; ++t)
+	{
+		sum += trajectory.GetParticleDefinition()->GetPDGMass();
+	}
+	double byPointer = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+	G4cout << "  mass by name: " << byName / nTracks << " ns/track, by pointer: " << byPointer / nTracks
+		   << " ns/track (" << sum / (2. * nTracks) << " MeV)" << G4endl;
 }
 
 void WCSimTrajectory::MergeTrajectory(G4VTrajectory *secondTrajectory)
@@ -234,6 +302,17 @@ void WCSimTrajectory::MergeTrajectory(G4VTrajectory *secondTrajectory)
 	stoppingPoint = seco->stoppingPoint;
 	stoppingVolume = seco->stoppingVolume;
 
+	if (fSummaryOnly)
+	{
+		SetStoppingPoint(stoppingPoint);
+		for (size_t i = 0; i < seco->positionRecord->size(); i++)
+		{
+			delete (*seco->positionRecord)[i];
+		}
+		seco->positionRecord->clear();
+		return;
+	}
+
 	G4int ent = seco->GetPointEntries();
 	for (G4int i = 1; i < ent; i++) // initial point of the second trajectory should not be merged
 	{
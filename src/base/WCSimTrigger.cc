@@ -0,0 +1,111 @@
+#include "WCSimTrigger.hh"
+
+WCSimTrigger::WCSimTrigger(int threshold, double window, double deadTime)
+{
+	fThreshold = threshold;
+	fWindow = window;
+	fDeadTime = deadTime;
+}
+
+WCSimTrigger::~WCSimTrigger()
+{
+}
+
+WCSimTrigger *WCSimTrigger::Create(const std::string &type, int threshold, double window, double deadTime)
+{
+	if (type == "gap")
+	{
+		return new WCSimGapTrigger(threshold, window, deadTime);
+	}
+	else if (type == "nhits")
+	{
+		return new WCSimNHitsTrigger(threshold, window, deadTime);
+	}
+	else if (type == "ndigits")
+	{
+		return new WCSimNDigitsTrigger(threshold, window, deadTime);
+	}
+	return 0;
+}
+
+WCSimGapTrigger::WCSimGapTrigger(int threshold, double window, double deadTime)
+	: WCSimTrigger(threshold, window, deadTime)
+{
+}
+
+void WCSimGapTrigger::FindTriggers(const std::vector<double> &times, std::vector<double> &triggerTimes) const
+{
+	triggerTimes.clear();
+	if (times.empty())
+	{
+		return;
+	}
+
+	// Iterate over the times and look for continuous chains of hits without
+	// a gap of greater than the window, with at least threshold hits.
+	double firstHit = times[0];
+	int nHits = 1;
+	for (unsigned int v = 1; v < times.size(); ++v)
+	{
+		if ((times[v] - times[v - 1]) < fWindow)
+		{
+			++nHits;
+		}
+		else
+		{
+			if (nHits >= fThreshold)
+			{
+				// Save this time and start over.
+				triggerTimes.push_back(firstHit);
+			}
+			// Either way, start the process again
+			firstHit = times[v];
+			nHits = 1;
+		}
+	}
+
+	// Make a trigger time out of whatever is left if we need to.
+	if (nHits >= fThreshold)
+	{
+		triggerTimes.push_back(firstHit);
+	}
+}
+
+WCSimNHitsTrigger::WCSimNHitsTrigger(int threshold, double window, double deadTime)
+	: WCSimTrigger(threshold, window, deadTime)
+{
+}
+
+void WCSimNHitsTrigger::FindTriggers(const std::vector<double> &times, std::vector<double> &triggerTimes) const
+{
+	triggerTimes.clear();
+
+	// The window runs from times[first] to times[last], both ends move forwards
+	// only so this is a single pass over the hits.
+	unsigned int first = 0;
+	for (unsigned int last = 0; last < times.size(); ++last)
+	{
+		while (times[last] - times[first] > fWindow)
+		{
+			++first;
+		}
+
+		if (static_cast<int>(last - first + 1) >= fThreshold)
+		{
+			double triggerTime = times[first];
+			triggerTimes.push_back(triggerTime);
+
+			// Nothing else can trigger until the dead time is over
+			while (last + 1 < times.size() && times[last + 1] < triggerTime + fDeadTime)
+			{
+				++last;
+			}
+			first = last + 1;
+		}
+	}
+}
+
+WCSimNDigitsTrigger::WCSimNDigitsTrigger(int threshold, double window, double deadTime)
+	: WCSimNHitsTrigger(threshold, window, deadTime)
+{
+}
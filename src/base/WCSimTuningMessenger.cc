@@ -9,7 +9,7 @@
 
 WCSimTuningMessenger::WCSimTuningMessenger()
 {
-	WCSimDir = new G4UIdirectory("/WCSim/tuning/");
+	WCSimDir = new G4UIdirectory("/WCSim/tuning/", false);
 	WCSimDir->SetGuidance("Commands to change tuning parameters");
 
 	Rayff = new G4UIcmdWithADouble("/WCSim/tuning/rayff", this);
@@ -0,0 +1,565 @@
+#include "WCSimVectorFileReader.hh"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+
+namespace
+{
+const char kSeparators[] = " $\t\r";
+const char kBinaryMagic[4] = {'C', 'V', 'E', 'C'};
+const int kBinaryVersion = 1;
+const char kIndexMagic[4] = {'C', 'I', 'D', 'X'};
+const int kIndexVersion = 2;
+
+template <typename T>
+void ReadValue(std::ifstream &file, T &value)
+{
+	file.read(reinterpret_cast<char *>(&value), sizeof(T));
+}
+
+template <typename T>
+void WriteValue(std::ofstream &file, const T &value)
+{
+	file.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+} // namespace
+
+void WCSimVectorEvent::Clear()
+{
+	mode = 0;
+	for (int i = 0; i < 4; ++i)
+	{
+		vtx[i] = 0.;
+	}
+	beam = WCSimVectorParticle();
+	target = WCSimVectorParticle();
+	tracks.clear();
+}
+
+WCSimVectorFileReader::~WCSimVectorFileReader()
+{
+}
+
+int WCSimVectorFileReader::SkipEvents(int nEvents)
+{
+	WCSimVectorEvent event;
+	int nSkipped = 0;
+	while (nSkipped < nEvents && ReadEvent(event))
+	{
+		++nSkipped;
+	}
+	return nSkipped;
+}
+
+WCSimVectorFileReader *WCSimVectorFileReader::Create(const std::string &fileName)
+{
+	const std::string binaryExtension = ".vecb";
+	if (fileName.size() > binaryExtension.size() &&
+		fileName.compare(fileName.size() - binaryExtension.size(), binaryExtension.size(), binaryExtension) == 0)
+	{
+		return new WCSimBinaryVectorReader();
+	}
+	return new WCSimTextVectorReader();
+}
+
+WCSimTextVectorReader::WCSimTextVectorReader()
+{
+	fPos = fLine.c_str();
+	fNextEvent = 0;
+	fIndexed = false;
+}
+
+WCSimTextVectorReader::~WCSimTextVectorReader()
+{
+	Close();
+}
+
+bool WCSimTextVectorReader::Open(const std::string &fileName)
+{
+	Close();
+	fFileName = fileName;
+	fFile.open(fileName.c_str(), std::ifstream::in);
+	if (!fFile.is_open())
+	{
+		return false;
+	}
+	LoadIndex();
+	return true;
+}
+
+void WCSimTextVectorReader::Close()
+{
+	if (fFile.is_open())
+	{
+		fFile.close();
+	}
+	fFile.clear();
+	fNextEvent = 0;
+	fIndexed = false;
+	fOffsets.clear();
+}
+
+long long WCSimTextVectorReader::GetFileSize() const
+{
+	std::ifstream file(fFileName.c_str(), std::ifstream::in | std::ifstream::binary | std::ifstream::ate);
+	return file.is_open() ? static_cast<long long>(file.tellg()) : -1;
+}
+
+bool WCSimTextVectorReader::BuildIndex()
+{
+	if (fIndexed)
+	{
+		return true;
+	}
+
+	// Use a second stream so the position of the reader doesn't change
+	std::ifstream file(fFileName.c_str(), std::ifstream::in);
+	if (!file.is_open())
+	{
+		return false;
+	}
+	fOffsets.clear();
+	std::string line;
+	long long offset = file.tellg();
+	while (std::getline(file, line))
+	{
+		std::size_t start = line.find_first_not_of(kSeparators);
+		if (start != std::string::npos && line.compare(start, 5, "begin") == 0)
+		{
+			fOffsets.push_back(offset);
+		}
+		offset = file.tellg();
+	}
+	fIndexed = true;
+	SaveIndex();
+	return true;
+}
+
+bool WCSimTextVectorReader::LoadIndex()
+{
+	std::ifstream file((fFileName + ".idx").c_str(), std::ifstream::in | std::ifstream::binary);
+	if (!file.is_open())
+	{
+		return false;
+	}
+
+	char magic[4];
+	int version = 0;
+	long long fileSize = 0;
+	int nEvents = 0;
+	file.read(magic, 4);
+	ReadValue(file, version);
+	ReadValue(file, fileSize);
+	ReadValue(file, nEvents);
+	// Rebuild the index if the vector file has been changed since it was made
+	if (!file.good() || std::memcmp(magic, kIndexMagic, 4) != 0 || version != kIndexVersion ||
+		fileSize != GetFileSize() || nEvents < 0)
+	{
+		return false;
+	}
+
+	fOffsets.resize(nEvents);
+	for (int e = 0; e < nEvents; ++e)
+	{
+		ReadValue(file, fOffsets[e]);
+	}
+	// The index ends with the number of events again, so one that was cut
+	// short isn't used
+	int nEventsEnd = -1;
+	ReadValue(file, nEventsEnd);
+	fIndexed = file.good() && nEventsEnd == nEvents && file.peek() == std::ifstream::traits_type::eof();
+	if (!fIndexed)
+	{
+		fOffsets.clear();
+	}
+	return fIndexed;
+}
+
+void WCSimTextVectorReader::SaveIndex() const
+{
+	// Not being able to write the cache (a read only directory, say) only means
+	// the index is made again next time. Shard jobs and worker threads can all
+	// be making the index of the same file, so each writes its own copy and
+	// renames it into place, and a reader only ever sees a whole index.
+	std::string indexName = fFileName + ".idx";
+	std::stringstream tempName;
+	tempName << indexName << "." << getpid() << "." << std::hash<std::thread::id>()(std::this_thread::get_id());
+	{
+		std::ofstream file(tempName.str().c_str(), std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+		if (!file.is_open())
+		{
+			return;
+		}
+		long long fileSize = GetFileSize();
+		int nEvents = fOffsets.size();
+		file.write(kIndexMagic, 4);
+		WriteValue(file, kIndexVersion);
+		WriteValue(file, fileSize);
+		WriteValue(file, nEvents);
+		for (int e = 0; e < nEvents; ++e)
+		{
+			WriteValue(file, fOffsets[e]);
+		}
+		WriteValue(file, nEvents);
+		file.close();
+		if (file.fail())
+		{
+			std::remove(tempName.str().c_str());
+			return;
+		}
+	}
+	if (std::rename(tempName.str().c_str(), indexName.c_str()) != 0)
+	{
+		std::remove(tempName.str().c_str());
+	}
+}
+
+bool WCSimTextVectorReader::SeekEvent(int event)
+{
+	if (!BuildIndex())
+	{
+		return false;
+	}
+	fFile.clear();
+	if (event < 0 || event >= GetNumberOfEvents())
+	{
+		// Leave the reader at the end of the file
+		fFile.seekg(0, std::ifstream::end);
+		fNextEvent = GetNumberOfEvents();
+		return false;
+	}
+	fFile.seekg(fOffsets[event]);
+	fNextEvent = event;
+	return true;
+}
+
+std::string WCSimTextVectorReader::ReadLine()
+{
+	if (!std::getline(fFile, fLine))
+	{
+		fLine.clear();
+		fPos = fLine.c_str();
+		return "";
+	}
+
+	// Pull out the keyword and leave fPos at the first value after it
+	std::size_t start = fLine.find_first_not_of(kSeparators);
+	if (start == std::string::npos)
+	{
+		fPos = fLine.c_str() + fLine.size();
+		return "";
+	}
+	std::size_t end = fLine.find_first_of(kSeparators, start);
+	if (end == std::string::npos)
+	{
+		end = fLine.size();
+	}
+	fPos = fLine.c_str() + end;
+	return fLine.substr(start, end - start);
+}
+
+int WCSimTextVectorReader::NextInt()
+{
+	char *end = 0;
+	long value = std::strtol(fPos, &end, 10);
+	// Some generators write integers as floating point numbers
+	if (*end == '.' || *end == 'e' || *end == 'E')
+	{
+		value = static_cast<long>(std::strtod(fPos, &end));
+	}
+	fPos = end;
+	return static_cast<int>(value);
+}
+
+double WCSimTextVectorReader::NextDouble()
+{
+	char *end = 0;
+	double value = std::strtod(fPos, &end);
+	fPos = end;
+	return value;
+}
+
+void WCSimTextVectorReader::ReadParticle(WCSimVectorParticle &particle)
+{
+	particle.pdg = NextInt();
+	particle.energy = NextDouble();
+	for (int i = 0; i < 3; ++i)
+	{
+		particle.dir[i] = NextDouble();
+	}
+	particle.status = NextInt();
+}
+
+bool WCSimTextVectorReader::ReadEvent(WCSimVectorEvent &event)
+{
+	event.Clear();
+
+	// Find the start of the next event, stopping at the end of the file
+	std::string keyword;
+	do
+	{
+		keyword = ReadLine();
+		if (keyword.empty() && !fFile.good())
+		{
+			return false;
+		}
+	} while (keyword != "begin");
+
+	// The first two tracks are the neutrino and the target, the rest are the
+	// final state particles
+	int nTrackLines = 0;
+	while (fFile.good())
+	{
+		keyword = ReadLine();
+		if (keyword == "end")
+		{
+			++fNextEvent;
+			return true;
+		}
+		else if (keyword == "nuance")
+		{
+			event.mode = NextInt();
+		}
+		else if (keyword == "vertex")
+		{
+			for (int i = 0; i < 4; ++i)
+			{
+				event.vtx[i] = NextDouble();
+			}
+		}
+		else if (keyword == "track")
+		{
+			WCSimVectorParticle particle;
+			ReadParticle(particle);
+			if (nTrackLines == 0)
+			{
+				event.beam = particle;
+			}
+			else if (nTrackLines == 1)
+			{
+				event.target = particle;
+			}
+			else
+			{
+				event.tracks.push_back(particle);
+			}
+			++nTrackLines;
+		}
+	}
+
+	std::cout << "WCSimTextVectorReader: the last event in the file has no end line" << std::endl;
+	return false;
+}
+
+int WCSimTextVectorReader::SkipEvents(int nEvents)
+{
+	if (fIndexed)
+	{
+		int nSkipped = std::max(0, std::min(nEvents, GetNumberOfEvents() - fNextEvent));
+		SeekEvent(fNextEvent + nSkipped);
+		return nSkipped;
+	}
+
+	// Only look at the keywords, there's no need to parse the numbers
+	int nSkipped = 0;
+	while (nSkipped < nEvents && fFile.good())
+	{
+		if (ReadLine() == "end")
+		{
+			++nSkipped;
+		}
+	}
+	fNextEvent += nSkipped;
+	return nSkipped;
+}
+
+WCSimBinaryVectorReader::WCSimBinaryVectorReader()
+{
+	fNextEvent = 0;
+}
+
+WCSimBinaryVectorReader::~WCSimBinaryVectorReader()
+{
+	Close();
+}
+
+bool WCSimBinaryVectorReader::Open(const std::string &fileName)
+{
+	Close();
+	fFile.open(fileName.c_str(), std::ifstream::in | std::ifstream::binary);
+	if (!fFile.is_open())
+	{
+		return false;
+	}
+
+	char magic[4];
+	int version = 0;
+	int nEvents = 0;
+	long long indexOffset = 0;
+	fFile.read(magic, 4);
+	ReadValue(fFile, version);
+	ReadValue(fFile, nEvents);
+	ReadValue(fFile, indexOffset);
+	if (!fFile.good() || std::memcmp(magic, kBinaryMagic, 4) != 0 || version != kBinaryVersion)
+	{
+		std::cout << "WCSimBinaryVectorReader: " << fileName << " is not a version " << kBinaryVersion
+				  << " binary vector file" << std::endl;
+		Close();
+		return false;
+	}
+
+	fOffsets.resize(nEvents);
+	fFile.seekg(indexOffset);
+	for (int e = 0; e < nEvents; ++e)
+	{
+		ReadValue(fFile, fOffsets[e]);
+	}
+	if (!fFile.good())
+	{
+		std::cout << "WCSimBinaryVectorReader: could not read the event index of " << fileName << std::endl;
+		Close();
+		return false;
+	}
+	return SeekEvent(0) || nEvents == 0;
+}
+
+void WCSimBinaryVectorReader::Close()
+{
+	if (fFile.is_open())
+	{
+		fFile.close();
+	}
+	fOffsets.clear();
+	fNextEvent = 0;
+}
+
+bool WCSimBinaryVectorReader::SeekEvent(int event)
+{
+	if (event < 0 || event >= GetNumberOfEvents())
+	{
+		fNextEvent = GetNumberOfEvents();
+		return false;
+	}
+	fFile.clear();
+	fFile.seekg(fOffsets[event]);
+	fNextEvent = event;
+	return true;
+}
+
+void WCSimBinaryVectorReader::ReadParticle(WCSimVectorParticle &particle)
+{
+	ReadValue(fFile, particle.pdg);
+	ReadValue(fFile, particle.status);
+	ReadValue(fFile, particle.energy);
+	fFile.read(reinterpret_cast<char *>(particle.dir), sizeof(particle.dir));
+}
+
+bool WCSimBinaryVectorReader::ReadEvent(WCSimVectorEvent &event)
+{
+	event.Clear();
+	if (fNextEvent >= GetNumberOfEvents())
+	{
+		return false;
+	}
+
+	// The events are stored one after the other, so a sequential read never seeks
+	int nTracks = 0;
+	ReadValue(fFile, event.mode);
+	fFile.read(reinterpret_cast<char *>(event.vtx), sizeof(event.vtx));
+	ReadParticle(event.beam);
+	ReadParticle(event.target);
+	ReadValue(fFile, nTracks);
+	event.tracks.resize(nTracks);
+	for (int t = 0; t < nTracks; ++t)
+	{
+		ReadParticle(event.tracks[t]);
+	}
+	++fNextEvent;
+	return fFile.good();
+}
+
+int WCSimBinaryVectorReader::SkipEvents(int nEvents)
+{
+	int nSkipped = std::min(nEvents, GetNumberOfEvents() - fNextEvent);
+	SeekEvent(fNextEvent + nSkipped);
+	return nSkipped;
+}
+
+WCSimBinaryVectorWriter::WCSimBinaryVectorWriter()
+{
+}
+
+WCSimBinaryVectorWriter::~WCSimBinaryVectorWriter()
+{
+	Close();
+}
+
+bool WCSimBinaryVectorWriter::Open(const std::string &fileName)
+{
+	Close();
+	fOffsets.clear();
+	fFile.open(fileName.c_str(), std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+	if (!fFile.is_open())
+	{
+		return false;
+	}
+
+	// Placeholder header, filled in by Close()
+	int nEvents = 0;
+	long long indexOffset = 0;
+	fFile.write(kBinaryMagic, 4);
+	WriteValue(fFile, kBinaryVersion);
+	WriteValue(fFile, nEvents);
+	WriteValue(fFile, indexOffset);
+	return fFile.good();
+}
+
+void WCSimBinaryVectorWriter::WriteParticle(const WCSimVectorParticle &particle)
+{
+	WriteValue(fFile, particle.pdg);
+	WriteValue(fFile, particle.status);
+	WriteValue(fFile, particle.energy);
+	fFile.write(reinterpret_cast<const char *>(particle.dir), sizeof(particle.dir));
+}
+
+void WCSimBinaryVectorWriter::WriteEvent(const WCSimVectorEvent &event)
+{
+	fOffsets.push_back(static_cast<long long>(fFile.tellp()));
+	int nTracks = event.tracks.size();
+	WriteValue(fFile, event.mode);
+	fFile.write(reinterpret_cast<const char *>(event.vtx), sizeof(event.vtx));
+	WriteParticle(event.beam);
+	WriteParticle(event.target);
+	WriteValue(fFile, nTracks);
+	for (int t = 0; t < nTracks; ++t)
+	{
+		WriteParticle(event.tracks[t]);
+	}
+}
+
+void WCSimBinaryVectorWriter::Close()
+{
+	if (!fFile.is_open())
+	{
+		return;
+	}
+
+	long long indexOffset = static_cast<long long>(fFile.tellp());
+	for (unsigned int e = 0; e < fOffsets.size(); ++e)
+	{
+		WriteValue(fFile, fOffsets[e]);
+	}
+
+	int nEvents = fOffsets.size();
+	fFile.seekp(4 + sizeof(int));
+	WriteValue(fFile, nEvents);
+	WriteValue(fFile, indexOffset);
+	fFile.close();
+}
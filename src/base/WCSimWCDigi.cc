@@ -1,6 +1,6 @@
 #include "WCSimWCDigi.hh"
 
-G4Allocator<WCSimWCDigi> WCSimWCDigiAllocator;
+G4ThreadLocal G4Allocator<WCSimWCDigi> *WCSimWCDigiAllocator = 0;
 
 WCSimWCDigi::WCSimWCDigi()
 {
@@ -14,6 +14,9 @@
 #include "WCSimCHIPSPMT.hh"
 #include "WCSimSK1pePMT.hh"
 #include "WCSimTOTPMT.hh"
+#include "WCSimTrigger.hh"
+#include "WCSimDarkNoise.hh"
+#include "WCSimDigiRandom.hh"
 
 #include <vector>
 // for memset
@@ -28,13 +31,6 @@ const double WCSimWCDigitizer::pmtgate = 200.0;		   // ns
 const double WCSimWCDigitizer::eventgateup = 950.0;	   // ns
 const double WCSimWCDigitizer::eventgatedown = -400.0; // ns
 const double WCSimWCDigitizer::LongTime = 100000.0;	   // ns
-// value in skdetsim
-const int WCSimWCDigitizer::GlobalThreshold = 25; // # hit PMTs
-//const int WCSimWCDigitizer::GlobalThreshold = 12 ; // # hit PMTs
-//const int WCSimWCDigitizer::GlobalThreshold = 10 ; // # hit PMTs
-
-const double WCSimWCDigitizer::PMTDarkRate = 4.0; // kHz
-
 extern "C" void skrn1pe_(float *);
 //extern "C" void rn1pe_(float* ); // 1Kton
 
@@ -47,6 +43,9 @@ WCSimWCDigitizer::WCSimWCDigitizer(G4String name, WCSimDetectorConstruction *myD
 	fPMTSim = new WCSimCHIPSPMT();
 	fSK1peSim = new WCSimSK1pePMT();
 	fTOTSim = new WCSimTOTPMT();
+	fTrigger = 0;
+	fDarkNoise = new WCSimDarkNoise(myDet);
+	fEventSeed = 1;
 }
 
 WCSimWCDigitizer::~WCSimWCDigitizer()
@@ -54,12 +53,12 @@ WCSimWCDigitizer::~WCSimWCDigitizer()
 	delete fPMTSim;
 	delete fSK1peSim;
 	delete fTOTSim;
+	delete fTrigger;
+	delete fDarkNoise;
 }
 
 void WCSimWCDigitizer::Digitize()
 {
-	DigitsCollection = new WCSimWCDigitsCollection("/WCSim/glassFaceWCPMT", collectionName[0]);
-
 	G4DigiManager *DigiMan = G4DigiManager::GetDMpointer();
 
 	// Get the Associated Hit collection IDs
@@ -68,12 +67,22 @@ void WCSimWCDigitizer::Digitize()
 	// The Hits collection
 	WCSimWCHitsCollection *WCHC = (WCSimWCHitsCollection *)(DigiMan->GetHitsCollection(WCHCID));
 
+	DigitizeHits(WCHC);
+	StoreDigiCollection(DigitsCollection);
+}
+
+void WCSimWCDigitizer::DigitizeHits(WCSimWCHitsCollection *WCHC)
+{
+	DigitsCollection = new WCSimWCDigitsCollection("/WCSim/glassFaceWCPMT", collectionName[0]);
+
 	if (WCHC)
 	{
+		BuildPMTTypeTable();
+		fSK1peSim->SetGaussianThreshold(fDet->GetPMTGaussianThreshold());
+		UpdateTrigger();
+		SeedStreams();
 
-		//		MakeHitsHistogram(WCHC);
-		//FindNumberOfGates(); //get list of t0 and number of triggers.
-		//		FindNumberOfGatesFast(); //get list of t0 and number of triggers.
+		AddDarkNoise(WCHC);
 		this->FindTriggerWindows(WCHC);
 
 		for (int i = 0; i < this->NumberOfGatesInThisEvent(); i++)
@@ -81,18 +90,97 @@ void WCSimWCDigitizer::Digitize()
 			DigitizeGate(WCHC, i);
 		}
 	}
+}
+
+void WCSimWCDigitizer::BuildPMTTypeTable()
+{
+	// Only a handful of PMT types, so just rebuild this each event in case the
+	// geometry or the PMT simulation method has changed.
+	const std::vector<WCSimPMTConfig> &configs = fDet->GetPMTConfigs();
+	fPMTTypes.resize(configs.size());
+	for (unsigned int type = 0; type < configs.size(); ++type)
+	{
+		fPMTTypes[type].timeConstant = configs[type].GetTimeConstant();
+		fPMTTypes[type].pmtSim = fDet->GetPMTSim();
+		fPMTTypes[type].totModel = WCSimTOTPMT::GetModel(configs[type].GetPMTName());
+	}
+}
 
-	StoreDigiCollection(DigitsCollection);
+void WCSimWCDigitizer::SeedStreams()
+{
+	// Nothing here uses the Geant4 engine, so the digits of an event only
+	// depend on its hits, the settings and the event seed.
+	fDarkNoise->SetSeed(WCSimDigiRandom::GetStreamSeed(fEventSeed, WCSimDigiRandom::kDarkNoise));
+	fPMTSim->SetSeed(WCSimDigiRandom::GetStreamSeed(fEventSeed, WCSimDigiRandom::kCHIPSCharge));
+	fSK1peSim->SetSeed(WCSimDigiRandom::GetStreamSeed(fEventSeed, WCSimDigiRandom::kSK1peCharge));
+	fTOTSim->SetSeed(WCSimDigiRandom::GetStreamSeed(fEventSeed, WCSimDigiRandom::kTOTCharge));
+	fTimingRand.SetSeed(WCSimDigiRandom::GetStreamSeed(fEventSeed, WCSimDigiRandom::kTiming));
 }
 
-void WCSimWCDigitizer::FindTriggerWindows(WCSimWCHitsCollection *hits)
+void WCSimWCDigitizer::UpdateTrigger()
+{
+	// The trigger settings can be changed between runs from the macro
+	std::string type = fDet->GetTriggerType();
+	int threshold = fDet->GetTriggerThreshold();
+	double window = fDet->GetTriggerWindow();
+	if (fTrigger && fTriggerType == type && fTrigger->GetThreshold() == threshold &&
+		fTrigger->GetWindow() == window)
+	{
+		return;
+	}
+
+	WCSimTrigger *trigger = WCSimTrigger::Create(type, threshold, window, WCSimWCDigitizer::eventgateup);
+	if (!trigger)
+	{
+		// The detector construction is shared by the worker threads, so the
+		// fall back is only kept here
+		G4cout << "Trigger type " << type << " does not exist, using gap" << G4endl;
+		trigger = WCSimTrigger::Create("gap", threshold, window, WCSimWCDigitizer::eventgateup);
+	}
+	delete fTrigger;
+	fTrigger = trigger;
+	fTriggerType = type;
+	G4cout << "Using the " << fTrigger->GetName() << " trigger with a threshold of " << fTrigger->GetThreshold()
+		   << " hits and a window of " << fTrigger->GetWindow() << " ns" << G4endl;
+}
+
+void WCSimWCDigitizer::AddDarkNoise(WCSimWCHitsCollection *hits)
 {
+	fDarkNoise->SetDarkRate(fDet->GetPMTDarkRate());
+	if (fDarkNoise->GetDarkRate() <= 0.)
+	{
+		return;
+	}
+
+	// Cover every gate that the photons could open, or a single gate around
+	// zero if there aren't any so that noise alone can still trigger.
+	G4double firstTime = 0.;
+	G4double lastTime = 0.;
+	for (int i = 0; i < hits->entries(); ++i)
+	{
+		WCSimWCHit *hit = (*hits)[i];
+		hit->SortHitTimes();
+		if (i == 0 || hit->GetTime(0) < firstTime)
+		{
+			firstTime = hit->GetTime(0);
+		}
+		if (i == 0 || hit->GetTime(hit->GetTotalPe() - 1) > lastTime)
+		{
+			lastTime = hit->GetTime(hit->GetTotalPe() - 1);
+		}
+	}
 
-	std::vector<double> pmtHitTimes;
+	fDarkNoise->AddDarkNoise(hits, firstTime + WCSimWCDigitizer::eventgatedown, lastTime + WCSimWCDigitizer::eventgateup);
+}
+
+void WCSimWCDigitizer::FindTriggerWindows(WCSimWCHitsCollection *hits)
+{
+	fTriggerHitTimes.clear();
 
 	// Remember the index of this vector is tubeID - 1.
 	std::vector<WCSimPmtInfo *> *pmtInfoVec = fDet->Get_Pmts();
 
+	bool allHits = fTrigger->UsesAllHitTimes();
 	for (int i = 0; i < hits->entries(); ++i)
 	{
 		WCSimWCHit *hit = (*hits)[i];
@@ -103,96 +191,29 @@ void WCSimWCDigitizer::FindTriggerWindows(WCSimWCHitsCollection *hits)
 		}
 		// Make sure that we get the first hit on the PMT
 		hit->SortHitTimes();
-		pmtHitTimes.push_back(hit->GetTime(0));
-	}
-
-	// Now we want to sort out times into ascending order.
-	std::sort(pmtHitTimes.begin(), pmtHitTimes.end());
-
-	// Iterate over the times and look for continuous chains of hits without
-	// a gap of great than 200ns, with at least GlobalThreshold hits.
-	if (pmtHitTimes.size() > 0)
-	{
-		double firstHit = pmtHitTimes[0];
-		unsigned int nHits = 1;
-		for (unsigned int v = 1; v < pmtHitTimes.size(); ++v)
+		if (allHits)
 		{
-			//      std::cout << firstHit << ", " << pmtHitTimes[v-1] << ", " << pmtHitTimes[v] << " :: " << nHits << std::endl;
-			if ((pmtHitTimes[v] - pmtHitTimes[v - 1]) < 200)
+			for (int p = 0; p < hit->GetTotalPe(); ++p)
 			{
-				++nHits;
-			}
-			else
-			{
-				if (nHits >= WCSimWCDigitizer::GlobalThreshold)
-				{
-					// Save this time and start over.
-					TriggerTimes.push_back(firstHit);
-				}
-				// Either way, start the process again
-				firstHit = pmtHitTimes[v];
-				nHits = 1;
+				fTriggerHitTimes.push_back(hit->GetTime(p));
 			}
 		}
-
-		// Make a trigger time out of whatever is left if we need to.
-		if (nHits >= WCSimWCDigitizer::GlobalThreshold)
+		else
 		{
-			TriggerTimes.push_back(firstHit);
+			fTriggerHitTimes.push_back(hit->GetTime(0));
 		}
 	}
 
-	for (unsigned int t = 0; t < TriggerTimes.size(); ++t)
-	{
-		std::cout << "Trigger time = " << TriggerTimes[t] << std::endl;
-	}
-}
-
-void WCSimWCDigitizer::MakeHitsHistogram(WCSimWCHitsCollection *WCHC)
-{
-
-	GateMap.clear();
-
-	// Put the hits into an integer map
-	for (G4int i = 0; i < WCHC->entries(); i++)
-	{
-		(*WCHC)[i]->SortHitTimes(); // VERY IMPORTANT!!!
-		GateMap[int(floor((*WCHC)[i]->GetTime(0)))]++;
-	}
-}
+	// Now we want to sort out times into ascending order.
+	std::sort(fTriggerHitTimes.begin(), fTriggerHitTimes.end());
 
-void WCSimWCDigitizer::FindNumberOfGatesFast()
-{
-	//GateMap is indexed by time bin and stores the number of hits in that nanosecond.
-	G4int acc = 0; // accumulated # hits within time window...
-	std::map<G4int, G4int>::iterator _mGateKeeper, _mNextGate;
+	fTrigger->FindTriggers(fTriggerHitTimes, TriggerTimes);
 
-	for (_mGateKeeper = GateMap.begin(); _mGateKeeper != GateMap.end(); _mGateKeeper++)
+	if (fDet->GetTriggerVerbose())
 	{
-		acc = 0;
-		_mNextGate = _mGateKeeper;
-		RealOffset = 0.0; // will need to add the offset later
-		// 40 means + 200ns
-		// so check 39 bins ahead in the histogram..
-		int offset200 = 199;																											   // Leigh: Offset in number of bins corresponding to 200ns (was 39).
-		while (_mNextGate != GateMap.lower_bound(_mGateKeeper->first + offset200) && _mNextGate->first <= _mGateKeeper->first + offset200) // but not more than 200ns away though!
+		for (unsigned int t = 0; t < TriggerTimes.size(); ++t)
 		{
-
-			acc += _mNextGate->second;
-			if (acc > WCSimWCDigitizer::GlobalThreshold)
-			{
-				//RealOffset = _mGateKeeper->first*5.0;
-				//RealOffset = _mNextGate->first*5.0;
-				RealOffset = _mNextGate->first;
-				TriggerTimes.push_back(RealOffset);
-				//std::cerr << "found a trigger..." << RealOffset/5.0  <<"\n";
-				std::cerr << "found a trigger..." << RealOffset << "\n";
-				//		    _mGateKeeper = GateMap.lower_bound( _mNextGate->first + G4int(WCSimWCDigitizer::eventgateup )/5. );
-				_mGateKeeper = GateMap.lower_bound(_mNextGate->first + G4int(WCSimWCDigitizer::eventgateup));
-				std::cerr.flush();
-				break;
-			}
-			_mNextGate++; // look at the next time bin with hits
+			std::cout << "Trigger time = " << TriggerTimes[t] << std::endl;
 		}
 	}
 }
@@ -213,17 +234,15 @@ void WCSimWCDigitizer::DigitizeGate(WCSimWCHitsCollection *WCHC, G4int G)
 	}
 	G4double upperbound = TriggerTimes[G] + EvtG8Up;
 
-	// Before looping over the hits, get hold of the PMTManager
-	WCSimPMTManager *pmtMan = fDet->GetPMTManager();
+	// Find the hits in this gate first so that the CHIPS PMT charges can
+	// all be calculated in one go.
+	fGateHits.clear();
+	fGateTrueTimes.clear();
+	fGatePe.clear();
+	fGateLastTimes.clear();
 	for (G4int i = 0; i < WCHC->entries(); i++)
 	{
-
-		// What type of PMT do we have?
-		WCSimPMTConfig pmtConfig = pmtMan->GetPMTByName((*WCHC)[i]->GetTubeName());
-		G4int timingConstant = pmtConfig.GetTimeConstant(); // In ns
-
-		// Get the tube ID and hit time
-		G4int tube = (*WCHC)[i]->GetTubeID();
+		// Get the hit time
 		G4float trueHitTime =
 			(fDet->GetPMTTime() == 1) ? (*WCHC)[i]->GetMeanHitTimeInGate() : (*WCHC)[i]->GetFirstHitTimeInGate(lowerbound, upperbound);
 
@@ -235,36 +254,58 @@ void WCSimWCDigitizer::DigitizeGate(WCSimWCHitsCollection *WCHC, G4int G)
 
 		// Find the total number of hits (integer number) in the gate for the PMT
 		double bound1 = trueHitTime + WCSimWCDigitizer::pmtgate;
-		G4float totalPe = (*WCHC)[i]->GetPeInGate(lowerbound, upperbound, bound1);
+		G4int totalPe = (*WCHC)[i]->GetPeInGate(lowerbound, upperbound, bound1);
+
+		// The time spread of the photon arrival times, for the CHIPS method
+		double maxTime = trueHitTime;
+		if (fDet->GetPMTSim() == 1 && totalPe != 1)
+			maxTime = (*WCHC)[i]->GetLastHitTimeInGate(lowerbound, upperbound);
+
+		fGateHits.push_back(i);
+		fGateTrueTimes.push_back(trueHitTime);
+		fGatePe.push_back(totalPe);
+		fGateLastTimes.push_back(maxTime);
+	}
+
+	// CHIPS method based on a simulation of the IceCube PMTs, takes account
+	// of non-linearity and saturation. Run the cascade for every tube at once.
+	if (fDet->GetPMTSim() == 1)
+	{
+		fPMTSim->CalculateCharges(fGatePe, fGateTrueTimes, fGateLastTimes, fGateCharges);
+	}
+
+	for (unsigned int h = 0; h < fGateHits.size(); h++)
+	{
+		G4int i = fGateHits[h];
+
+		// What type of PMT do we have?
+		const WCSimDigitizerPMTType &pmtType = fPMTTypes[(*WCHC)[i]->GetTubeType()];
+		G4int timingConstant = pmtType.timeConstant; // In ns
+
+		G4int tube = (*WCHC)[i]->GetTubeID();
+		G4float trueHitTime = fGateTrueTimes[h];
+		G4int totalPe = fGatePe[h];
 
 		// Now digitize this hit
 		G4double peSmeared = 0.0;
 
 		// Check which method we should be using to measure the PE
 		// Standard WCSim method based on SuperK (I think)
-		if (fDet->GetPMTSim() == 0)
+		if (pmtType.pmtSim == 0)
 		{
 			peSmeared = fSK1peSim->CalculateCharge(totalPe);
 		}
 
-		// CHIPS method based on a simulation of the IceCube PMTs, takes account
-		// of non-linearity and saturation.
-		else if (fDet->GetPMTSim() == 1)
+		// CHIPS method, already calculated above
+		else if (pmtType.pmtSim == 1)
 		{
-			// Firstly, we need to get the time spread of the photon arrival times.
-			double minTime = trueHitTime;
-			double maxTime = -1e20;
-			if (totalPe == 1)
-				maxTime = minTime;
-			else
-				maxTime = (*WCHC)[i]->GetLastHitTimeInGate(lowerbound, upperbound);
-			peSmeared = fPMTSim->CalculateCharge(totalPe, minTime, maxTime);
+			peSmeared = fGateCharges[h];
 		}
 
 		// Time over threshold method.
-		else if (fDet->GetPMTSim() == 2)
+		else if (pmtType.pmtSim == 2)
 		{
-			peSmeared = fTOTSim->CalculateCharge(totalPe, (*WCHC)[i]->GetTubeName());
+			peSmeared = fTOTSim->CalculateCharge(totalPe, (WCSimTOTPMT::TOTModel)pmtType.totModel);
 		}
 
 		else
@@ -287,7 +328,7 @@ void WCSimWCDigitizer::DigitizeGate(WCSimWCHitsCollection *WCHC, G4int G)
 				// looking at SK's jitter function for 20" tubes
 				if (timingResolution < 0.58)
 					timingResolution = 0.58;
-				digihittime += G4RandGauss::shoot(0.0, timingResolution);
+				digihittime += fTimingRand.Gaus(0.0, timingResolution);
 			}
 
 			if (digihittime > 0.0)
@@ -8,9 +8,9 @@
 #include "G4RotationMatrix.hh"
 #include <iomanip>
 
-G4int WCSimWCHit::maxPe = 0;
+G4ThreadLocal G4int WCSimWCHit::maxPe = 0;
 
-G4Allocator<WCSimWCHit> WCSimWCHitAllocator;
+G4ThreadLocal G4Allocator<WCSimWCHit> *WCSimWCHitAllocator = 0;
 
 G4double numbpmthit = 0.0;
 G4double avePe = 0.0;
@@ -18,6 +18,9 @@ G4double avePe = 0.0;
 WCSimWCHit::WCSimWCHit()
 {
 	totalPe = 0;
+	tubeType = 0;
+	pLogV = 0;
+	timesSorted = true;
 }
 
 WCSimWCHit::~WCSimWCHit()
@@ -28,19 +31,54 @@ WCSimWCHit::WCSimWCHit(const WCSimWCHit &right) : G4VHit()
 {
 	trackID = right.trackID;
 	tubeID = right.tubeID;
+	tubeType = right.tubeType;
 	edep = right.edep;
 	pos = right.pos;
+	timesSorted = true;
 }
 
 const WCSimWCHit &WCSimWCHit::operator=(const WCSimWCHit &right)
 {
 	trackID = right.trackID;
 	tubeID = right.tubeID;
+	tubeType = right.tubeType;
 	edep = right.edep;
 	pos = right.pos;
 	return *this;
 }
 
+void WCSimWCHit::SortHitTimes()
+{
+	if (timesSorted)
+	{
+		return;
+	}
+
+	if (primaryParentID.size() != time.size())
+	{
+		// No parents to keep in step with the times
+		std::sort(time.begin(), time.end());
+	}
+	else
+	{
+		// Sort the photons as (time, parent) pairs so the parent of
+		// each photon stays next to its time.
+		std::vector<std::pair<G4float, G4int>> photons(time.size());
+		for (unsigned int i = 0; i < time.size(); ++i)
+		{
+			photons[i] = std::make_pair(time[i], primaryParentID[i]);
+		}
+		std::stable_sort(photons.begin(), photons.end(),
+						 [](const std::pair<G4float, G4int> &a, const std::pair<G4float, G4int> &b) { return a.first < b.first; });
+		for (unsigned int i = 0; i < photons.size(); ++i)
+		{
+			time[i] = photons[i].first;
+			primaryParentID[i] = photons[i].second;
+		}
+	}
+	timesSorted = true;
+}
+
 G4int WCSimWCHit::operator==(const WCSimWCHit &right) const
 {
 	return (this == &right) ? 1 : 0;
@@ -49,7 +87,8 @@ G4int WCSimWCHit::operator==(const WCSimWCHit &right) const
 void WCSimWCHit::Draw()
 {
 	G4VVisManager *pVVisManager = G4VVisManager::GetConcreteInstance();
-	if (pVVisManager)
+	// Dark noise hits have no volume to draw
+	if (pVVisManager && pLogV)
 	{
 		G4Transform3D trans(rot, pos);
 		G4VisAttributes attribs;
@@ -9,9 +9,11 @@
 #include "G4ios.hh"
 
 #include <sstream>
+#include <chrono>
 
 #include "WCSimDetectorConstruction.hh"
 #include "WCSimTrackInformation.hh"
+#include "WCSimPhotonNtuple.hh"
 
 WCSimWCSD::WCSimWCSD(G4String name, WCSimDetectorConstruction *myDet) : G4VSensitiveDetector(name)
 {
@@ -28,6 +30,7 @@ WCSimWCSD::WCSimWCSD(G4String name, WCSimDetectorConstruction *myDet) : G4VSensi
 	fdet = myDet;
 
 	HCID = -1;
+	fRecordPhotons = false;
 }
 
 WCSimWCSD::~WCSimWCSD()
@@ -53,6 +56,15 @@ void WCSimWCSD::Initialize(G4HCofThisEvent *HCE)
 	// Initilize the Hit map to all tubes not hit.
 	PMTHitMap.clear();
 
+	// Reset the tube lookup validation counters
+	fNumLookups = 0;
+	fNumLookupMismatches = 0;
+	fKeyLookupTime = 0.0;
+	fTagLookupTime = 0.0;
+
+	// Tell the photon ntuple which photons were detected if it is being saved
+	fRecordPhotons = WCSimPhotonNtuple::IsOpen();
+
 	// Trick to access the static maxPE variable.  This will go away with the
 	// variable.
 
@@ -80,6 +92,30 @@ G4float WCSimWCSD::Interpolate_func(G4float x, G4int ncount, G4float *angle, G4f
 	}
 }
 
+G4int WCSimWCSD::ValidateTubeLookup(const G4VTouchable *touchable)
+{
+	// Time both lookups for the same photon so they can be compared
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	G4int keyTubeID = WCSimDetectorConstruction::GetTubeID(touchable);
+	std::chrono::steady_clock::time_point middle = std::chrono::steady_clock::now();
+	G4int tagTubeID = WCSimDetectorConstruction::GetTubeID(WCSimDetectorConstruction::GetTubeTag(touchable));
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+	fKeyLookupTime += std::chrono::duration<double>(middle - start).count();
+	fTagLookupTime += std::chrono::duration<double>(end - middle).count();
+	++fNumLookups;
+
+	if (keyTubeID != tagTubeID)
+	{
+		++fNumLookupMismatches;
+		std::cerr << "WCSimWCSD: tube lookup mismatch for " << WCSimDetectorConstruction::GetTubeTag(touchable)
+				  << " integer = " << keyTubeID << ", tag = " << tagTubeID << std::endl;
+	}
+
+	// The tag lookup is the reference
+	return tagTubeID;
+}
+
 G4bool WCSimWCSD::ProcessHits(G4Step *aStep, G4TouchableHistory *)
 {
 	G4StepPoint *preStepPoint = aStep->GetPreStepPoint();
@@ -101,7 +137,6 @@ G4bool WCSimWCSD::ProcessHits(G4Step *aStep, G4TouchableHistory *)
 		primParentID = aStep->GetTrack()->GetTrackID();
 
 	G4int trackID = aStep->GetTrack()->GetTrackID();
-	G4String volumeName = aStep->GetTrack()->GetVolume()->GetName();
 
 	//XQ Add the wavelength there
 	G4float wavelength = (2.0 * M_PI * 197.3) / (aStep->GetTrack()->GetTotalEnergy() / CLHEP::eV);
@@ -126,44 +161,23 @@ G4bool WCSimWCSD::ProcessHits(G4Step *aStep, G4TouchableHistory *)
 	//  if ( particleDefinition ==  G4OpticalPhoton::OpticalPhotonDefinition() )
 	// G4cout << volumeName << " hit by optical Photon! " << G4endl;
 
-	// Make the tubeTag string based on the replica numbers
-	// See WCSimDetectorConstruction::DescribeAndRegisterPMT() for matching
-	// tag construction.
-
-	std::stringstream tubeTag;
-
-	// Start tubeTag with mother to distinguish different PMT hierarchies
-	//  G4LogicalVolume *theMother = thePhysical->GetMotherLogical();
-	//  if (theMother != NULL)
-	//    tubeTag << theMother->GetName() << ":";
-
-	//  tubeTag << thePhysical->GetName();
-
-	std::string tubeType = "";
-	for (G4int i = theTouchable->GetHistoryDepth() - 1; i >= 0; i--)
+	// Get the tube ID from the touchable history. This uses the integer
+	// lookup built in WCSimDetectorConstruction::DescribeAndRegisterPMT(),
+	// the old string tubeTag lookup is only used to validate it.
+	G4int replicaNumber = 0;
+	if (fdet->GetValidateTubeLookup())
 	{
-		tubeTag << ":" << theTouchable->GetVolume(i)->GetName();
-		tubeTag << "-" << theTouchable->GetCopyNumber(i);
-
-		std::string volName = theTouchable->GetVolume(i)->GetName();
-		if (volName.find("WCPMT_") != volName.npos)
-		{
-			tubeType = volName;
-			// These are always named WCPMT_<pmt_name>, so strip the first part.
-			tubeType = volName.substr(6); // Return the string from character 6 to the end.
-		}
+		replicaNumber = ValidateTubeLookup(theTouchable());
+	}
+	else
+	{
+		replicaNumber = WCSimDetectorConstruction::GetTubeID(theTouchable());
 	}
-	if (tubeType == "")
+	if (replicaNumber <= 0)
 	{
-		std::cerr << "WCSimWCSD: Tube type could not be extracted, exiting." << std::endl;
+		std::cerr << "WCSimWCSD: Tube ID could not be found, exiting." << std::endl;
 		assert(0);
 	}
-	//  tubeTag << ":" << theTouchable->GetVolume(i)->GetCopyNo();
-
-	//  G4cout << tubeTag.str() << G4endl;
-
-	// Get the tube ID from the tubeTag
-	G4int replicaNumber = WCSimDetectorConstruction::GetTubeID(tubeTag.str());
 
 	// 100% angular collection efficiency everywhere, for testing
 	//G4float collection_angle[10]={0,10,20,30,40,50,60,70,74,90};
@@ -180,24 +194,28 @@ G4bool WCSimWCSD::ProcessHits(G4Step *aStep, G4TouchableHistory *)
 	G4float theta_angle;
 	G4float effectiveAngularEfficiency;
 
-	G4float ratio = 1.;
-	G4float maxQE;
-	G4float photonQE;
+	// The stacking action has already applied the largest QE of all the PMT
+	// types, see WCSimStackingAction::ClassifyNewTrack(). Apply what is left for
+	// the type of this tube.
+	const WCSimPMTQE &pmtQE = fdet->GetPMTQETable();
+	G4int pmtType = fdet->GetTubePMTType(replicaNumber);
+	G4float photonQE = 0.;
 	if (fdet->GetPMT_QE_Method() == 1)
 	{
 		photonQE = 1.1;
+		if (pmtQE.GetNTypes() > 1)
+		{
+			G4float envelopeQE = pmtQE.GetEnvelopeQE(wavelength);
+			photonQE = (envelopeQE > 0.) ? pmtQE.GetQE(wavelength, pmtType) / envelopeQE : 0.;
+		}
 	}
 	else if (fdet->GetPMT_QE_Method() == 2)
 	{
-		maxQE = fdet->GetPMTQE(wavelength, 0, 240, 660, ratio);
-		photonQE = fdet->GetPMTQE(wavelength, 1, 240, 660, ratio);
-		photonQE = photonQE / maxQE;
+		photonQE = pmtQE.GetQE(wavelength, pmtType) / pmtQE.GetMaxQE();
 	}
 	else if (fdet->GetPMT_QE_Method() == 3)
 	{
-		ratio = 1. / (1. - 0.25);
-		ratio = 1.0;
-		photonQE = fdet->GetPMTQE(wavelength, 1, 240, 660, ratio);
+		photonQE = pmtQE.GetQE(wavelength, pmtType);
 	}
 
 	if (G4UniformRand() <= photonQE)
@@ -214,9 +232,12 @@ G4bool WCSimWCSD::ProcessHits(G4Step *aStep, G4TouchableHistory *)
 			// If this tube hasn't been hit add it to the collection
 			if (PMTHitMap[replicaNumber] == 0)
 			{
+				// These are always named WCPMT_<pmt_name>, and the name without the
+				// prefix is stored with the PMT info.
 				WCSimWCHit *newHit = new WCSimWCHit();
-				newHit->SetTubeName(tubeType);
+				newHit->SetTubeName(fdet->Get_Pmts()->at(replicaNumber - 1)->Get_name());
 				newHit->SetTubeID(replicaNumber);
+				newHit->SetTubeType(pmtType);
 				newHit->SetTrackID(trackID);
 				newHit->SetEdep(energyDeposition);
 				newHit->SetLogicalVolume(thePhysical->GetLogicalVolume());
@@ -241,6 +262,11 @@ G4bool WCSimWCSD::ProcessHits(G4Step *aStep, G4TouchableHistory *)
 				(*hitsCollection)[PMTHitMap[replicaNumber] - 1]->AddPe(hitTime);
 				(*hitsCollection)[PMTHitMap[replicaNumber] - 1]->AddParentID(primParentID);
 			}
+
+			if (fRecordPhotons)
+			{
+				WCSimPhotonNtuple::DetectPhoton(trackID, replicaNumber);
+			}
 		}
 	}
 
@@ -249,6 +275,14 @@ G4bool WCSimWCSD::ProcessHits(G4Step *aStep, G4TouchableHistory *)
 
 void WCSimWCSD::EndOfEvent(G4HCofThisEvent *)
 {
+	if (fdet->GetValidateTubeLookup() && fNumLookups > 0)
+	{
+		G4cout << "WCSimWCSD: validated " << fNumLookups << " tube lookups, " << fNumLookupMismatches
+			   << " mismatches" << G4endl;
+		G4cout << "WCSimWCSD: integer lookup " << 1e9 * fKeyLookupTime / fNumLookups << " ns/photon, tag lookup "
+			   << 1e9 * fTagLookupTime / fNumLookups << " ns/photon" << G4endl;
+	}
+
 	if (verboseLevel > 0)
 	{
 		G4int numHits = hitsCollection->entries();